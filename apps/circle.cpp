@@ -12,6 +12,9 @@
 #include "constants.h"
 #include "ban.h"
 #include "genolc.h"
+#include "reactor.h"
+#include "mccp.h"
+#include "resolver.h"
 
 int main(int argc, char **argv)
 {
@@ -107,24 +110,57 @@ int main(int argc, char **argv)
                 no_specials = 1;
                 puts("Suppressing assignment of special routines.");
                 break;
+            case 'S':
+                reactor_type = REACTOR_SELECT;
+                puts("Using select() instead of epoll for network polling.");
+                break;
+            case 'z':
+                if (*(argv[pos] + 2))
+                    mccp_threads = atoi(argv[pos] + 2);
+                else if (++pos < argc)
+                    mccp_threads = atoi(argv[pos]);
+                else {
+                    puts("SYSERR: Thread count expected after option -z.");
+                    exit(1);
+                }
+                break;
+            case 'n': {
+                const char *stub;
+
+                if (*(argv[pos] + 2))
+                    stub = argv[pos] + 2;
+                else if (++pos < argc)
+                    stub = argv[pos];
+                else {
+                    puts("SYSERR: File name expected after option -n.");
+                    exit(1);
+                }
+                if (!resolver_use_stub(stub))
+                    exit(1);
+                printf("Resolving hostnames from %s instead of DNS.\n", stub);
+                break;
+            }
             case 'x':
                 xap_objs = 1;
                 log("Loading player objects from secondary (ascii) files.");
                 break;
             case 'h':
                 /* From: Anil Mahajan <amahajan@proxicom.com> */
-                printf("Usage: %s [-c] [-m] [-x] [-q] [-r] [-s] [-d pathname] [port #]\n"
+                printf("Usage: %s [-c] [-m] [-x] [-q] [-r] [-s] [-S] [-n file] [-z threads] [-d pathname] [port #]\n"
                        "  -c             Enable syntax check mode.\n"
                        "  -d <directory> Specify library directory (defaults to 'lib').\n"
                        "  -f<file>       Use <file> for configuration.\n"
                        "  -h             Print this command line argument help.\n"
                        "  -m             Start in mini-MUD mode.\n"
+                       "  -n <file>      Resolve hostnames from <file> (for testing).\n"
                        "  -o <file>      Write log to <file> instead of stderr.\n"
                        "  -q             Quick boot (doesn't scan rent for object limits)\n"
                        "  -r             Restrict MUD -- no new players allowed.\n"
                        "  -s             Suppress special procedure assignments.\n"
+                       "  -S             Poll sockets with select() instead of epoll.\n"
                        " Note:         These arguments are 'CaSe SeNsItIvE!!!'\n"
-                       "  -x             Load using secondary (ascii) files.\n",
+                       "  -x             Load using secondary (ascii) files.\n"
+                       "  -z <threads>   Run MCCP compression on <threads> worker threads.\n",
                        argv[0]
                 );
                 exit(0);
@@ -15,6 +15,7 @@ extern struct char_data *ch_selling, *ch_buying;
 // functions
 int check_saveroom_count(struct char_data *ch, struct obj_data *cont);
 void dball_load(void);
+int dball_exists(obj_vnum vnum);
 int check_insidebag(struct obj_data *cont, double mult);
 int perform_get_from_room(struct char_data *ch, struct obj_data *obj);
 void weight_change_object(struct obj_data *obj, int weight);
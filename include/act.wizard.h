@@ -76,5 +76,8 @@ ACMD(do_plist);
 ACMD(do_peace);
 ACMD(do_raise);
 ACMD(do_boom);
+ACMD(do_tasks);
+ACMD(do_profile);
+ACMD(do_pools);
 
 #endif //CIRCLE_ACT_WIZARD_H
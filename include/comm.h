@@ -58,7 +58,8 @@ void close_socket(struct descriptor_data *d);
 #define TO_HIDERESIST   (2 << 10)	/* resisted hiding roll      */
 
 /* I/O functions */
-void	write_to_q(const char *txt, struct txt_q *queue, int aliased);
+int	write_to_q(const char *txt, struct input_q *queue, int aliased);
+int	write_to_q_front(const char *txt, struct input_q *queue, int aliased);
 int	write_to_descriptor(socklen_t desc, const char *txt, struct compr *comp);
 size_t	write_to_output(struct descriptor_data *d, const char *txt, ...) __attribute__ ((format (printf, 2, 3)));
 size_t	vwrite_to_output(struct descriptor_data *d, const char *format, va_list args);
@@ -99,7 +100,7 @@ ssize_t perform_socket_write(socklen_t desc, const char *txt, size_t length, str
 void echo_off(struct descriptor_data *d);
 void echo_on(struct descriptor_data *d);
 void circle_sleep(struct timeval *timeout);
-int get_from_q(struct txt_q *queue, char *dest, int *aliased);
+int get_from_q(struct input_q *queue, char *dest, int *aliased);
 void init_game(uint16_t port);
 void signal_setup(void);
 void game_loop(socklen_t mother_desc);
@@ -117,11 +118,13 @@ void record_usage(void);
 char *make_prompt(struct descriptor_data *point);
 void check_idle_passwords(void);
 void check_idle_menu(void);
+void heartbeat_init(void);
 void heartbeat(int heart_pulse);
 struct in_addr *get_bind_addr(void);
 
 int set_sendbuf(socklen_t s);
 void free_bufpool(void);
+void queue_output(struct descriptor_data *t, const char *txt, size_t len);
 void setup_log(const char *filename, int fd);
 int open_logfile(const char *filename, FILE *stderr_fp);
 void init_descriptor (struct descriptor_data *newd, int desc);
@@ -131,9 +131,18 @@ extern room_rnum r_mortal_start_room;	/* rnum of mortal start room	 */
 extern room_rnum r_immort_start_room;	/* rnum of immort start room	 */
 extern room_rnum r_frozen_start_room;	/* rnum of frozen start room	 */
 
+/*
+ * Define this to have is_empty() check the zone occupancy counters against
+ * a scan of the descriptor list, logging any disagreement.
+ */
+/* #define CHECK_ZONE_OCCUPANCY */
+
 /* public procedures in db.c */
 void boot_world(void);
 int is_empty(zone_rnum zone_nr);
+void zone_occupancy_sync(struct char_data *ch);
+void zone_occupancy_sweep(void);
+void zone_occupancy_rebuild(void);
 void index_boot(int mode);
 void	boot_db(void);
 void	destroy_db(void);
@@ -172,6 +181,7 @@ void	reset_char(struct char_data *ch);
 void	free_char(struct char_data *ch);
 void	save_player_index(void);
 long  get_ptable_by_name(const char *name);
+void	set_ptable_id(int pos, long id);
 void	read_level_data(struct char_data *ch, FILE *fl);
 void	write_level_data(struct char_data *ch, FILE *fl);
 
@@ -243,6 +253,9 @@ struct zone_data {
    int max_level;           /* Max Mortal level to enter zone     */
    int zone_flags[ZF_ARRAY_MAX];          /* Flags for the zone.                */
 
+   int players;             /* players in the game in this zone   */
+   int mortals;             /* ... of them, those without nohassle */
+
 
    /*
     * Reset mode:
@@ -339,9 +352,9 @@ extern struct obj_data *object_list;
 extern struct obj_data *obj_proto;
 extern obj_rnum top_of_objt;
 
-extern struct htree_node *room_htree;
-extern struct htree_node *mob_htree;
-extern struct htree_node *obj_htree;
+extern struct vnum_index *room_vindex;
+extern struct vnum_index *mob_vindex;
+extern struct vnum_index *obj_vindex;
 
 extern struct social_messg *soc_mess_list;
 extern int top_of_socialt;
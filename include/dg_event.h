@@ -42,17 +42,29 @@ struct event {
 
 /***** Queue related info ******/
 
-/* number of queues to use (reduces enqueue cost) */
-#define NUM_EVENT_QUEUES    10
+/*
+ * Queues are hierarchical timing wheels: EVENT_WHEEL_LEVELS levels of
+ * EVENT_WHEEL_SIZE slots, level n slots being EVENT_WHEEL_SIZE^n pulses
+ * wide.  Three levels of 256 reach about 19 days out.
+ */
+#define EVENT_WHEEL_BITS    8
+#define EVENT_WHEEL_SIZE    (1 << EVENT_WHEEL_BITS)
+#define EVENT_WHEEL_MASK    (EVENT_WHEEL_SIZE - 1)
+#define EVENT_WHEEL_LEVELS  3
+
+/* events and queue elements are carved out this many at a time */
+#define EVENT_POOL_CHUNK    256
 
 struct queue {
-  struct q_element *head[NUM_EVENT_QUEUES], *tail[NUM_EVENT_QUEUES];
+  struct q_element *slot[EVENT_WHEEL_LEVELS][EVENT_WHEEL_SIZE];
+  long now;                   /* pulse the wheel has been turned to */
 };
 
 struct q_element {
   void *data;
   long key;
   struct q_element *prev, *next;
+  struct q_element **head;    /* slot this element is in */
 };
 /****** End of Queue related info ********/
 
@@ -141,11 +141,33 @@
 
 #define SCRIPT_ERROR_CODE     -9999999   /* this shouldn't happen too often */
 
+/* what a line of a trigger is, as found by compile_cmdlist() */
+#define DG_OP_NONE		0	/* not compiled yet		*/
+#define DG_OP_COMMENT		1
+#define DG_OP_IF		2
+#define DG_OP_ELSEIF		3
+#define DG_OP_ELSE		4
+#define DG_OP_WHILE		5
+#define DG_OP_SWITCH		6
+#define DG_OP_END		7
+#define DG_OP_DONE		8
+#define DG_OP_BREAK		9
+#define DG_OP_CASE		10
+#define DG_OP_COMMAND		11	/* substituted, then run	*/
+
 /* one line of the trigger */
 struct cmdlist_element {
   char *cmd;				/* one line of a trigger */
   struct cmdlist_element *original;
   struct cmdlist_element *next;
+
+  /* filled in by compile_cmdlist() */
+  int op;				/* DG_OP_xxx			*/
+  int command;				/* DG_CMD_xxx, if DG_OP_COMMAND	*/
+  char *line;				/* cmd past its indentation	*/
+  struct cmdlist_element *jump;		/* end or done that closes it	*/
+  struct cmdlist_element *arm;		/* next elseif/else/end or case	*/
+  int arm_how;				/* DG_ARM_xxx: what arm is	*/
 };
 
 struct trig_var_data {
@@ -154,6 +176,7 @@ struct trig_var_data {
   long context;				/* 0: global context */
 
   struct trig_var_data *next;
+  struct var_index *index;		/* on the head of a long list	*/
 };
 
 /* structure for triggers */
@@ -189,6 +212,16 @@ struct script_data {
   struct script_data *next;		/* used for purged_scripts    */
 };
 
+/* what the trigger running now has done, while 'tprofile' is on */
+struct trig_prof_run {
+  trig_vnum vnum;
+  unsigned long lines;			/* script lines executed	*/
+  unsigned long waits;			/* waits it scheduled		*/
+  unsigned long substs;			/* %var% substitutions		*/
+  bool runaway;				/* stopped by the loop limit	*/
+  unsigned long long child_nsec;	/* in triggers it set off	*/
+};
+
 /* The event data for the wait command */
 struct wait_event_data {
   struct trig_data *trigger;
@@ -306,6 +339,8 @@ struct room_data *dg_room_of_obj(struct obj_data *obj);
 /* To maintain strict-aliasing we'll have to do this trick with a union */
 /* Thanks to Chris Gilbert for reminding me that there are other options. */
 int script_driver(void *go_adress, trig_data *trig, int type, int mode);
+void compile_cmdlist(trig_data *trig);
+void periodic_trig_sync(void *thing, int type);
 trig_rnum real_trigger(trig_vnum vnum);
 void process_eval(void *go, struct script_data *sc, trig_data *trig,
                  int type, char *cmd);
@@ -314,6 +349,7 @@ void save_char_vars(struct char_data *ch);
 void init_lookup_table(void);
 void add_to_lookup_table(long uid, void *c);
 void remove_from_lookup_table(long uid);
+void lookup_table_stats(int *entries, int *slots, int *max_probe, double *avg_probe, unsigned long *misses);
 
 /* from dg_db_scripts.c */
 void parse_trigger(FILE *trig_f, int nr);
@@ -326,6 +362,10 @@ void assign_triggers(void *i, int type);
 
 /* From dg_variables.c */
 void add_var(struct trig_var_data **var_list, char *name, const char *value, long id);
+struct trig_var_data *find_var(struct trig_var_data *var_list, const char *name);
+struct trig_var_data *find_var_in_context(struct trig_var_data *var_list, const char *name, long context);
+void delete_var(struct trig_var_data **var_list, struct trig_var_data *vd);
+void free_var_index(struct trig_var_data *var_list);
 int item_in_list(char *item, obj_data *list);
 char *skill_percent(struct char_data *ch, char *skill);
 int char_has_item(char *item, struct char_data *ch);
@@ -335,6 +375,12 @@ int text_processed(char *field, char *subfield, struct trig_var_data *vd,
                    char *str, size_t slen);
 void find_replacement(void *go, struct script_data *sc, trig_data *trig,
                 int type, char *var, char *field, char *subfield, char *str, size_t slen);
+void dg_field_bench(struct char_data *ch);
+
+/* From dg_profile.c */
+extern bool trig_prof_on;
+extern struct trig_prof_run *trig_prof_cur;
+void trig_prof_done(struct trig_prof_run *run, unsigned long long nsec);
 
 
 /* From dg_handler.c */
@@ -387,6 +433,9 @@ room_rnum obj_room(obj_data *obj);
 #define GET_TRIG_DEPTH(t)         ((t)->depth)
 #define GET_TRIG_LOOPS(t)         ((t)->loops)
 
+/* bump a counter for the trigger being profiled, if there is one */
+#define TRIG_PROF_COUNT(field)	do { if (trig_prof_cur) trig_prof_cur->field++; } while (0)
+
 /* player id's: 0 to MOB_ID_BASE - 1            */
 /* mob id's: MOB_ID_BASE to ROOM_ID_BASE - 1      */
 /* room id's: ROOM_ID_BASE to OBJ_ID_BASE - 1    */
@@ -409,6 +458,10 @@ room_rnum obj_room(obj_data *obj);
 #define TRIGGER_CHECK(t, type)   (IS_SET(GET_TRIG_TYPE(t), type) && \
 				  !GET_TRIG_DEPTH(t))
 
+/* does anyone or anything in the room have a trigger of this type? */
+#define ROOM_MTRIG_CHECK(r, type) (IS_SET(world[(r)].trig.mob_types, type))
+#define ROOM_OTRIG_CHECK(r, type) (IS_SET(world[(r)].trig.obj_types, type))
+
 #define ADD_UID_VAR(buf, trig, go, name, context) do { \
 		         sprintf(buf, "%c%d", UID_CHAR, GET_ID(go)); \
                          add_var(&GET_TRIG_VARS(trig), name, buf, context); } while (0)
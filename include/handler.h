@@ -58,13 +58,27 @@ void	object_list_new_owner(struct obj_data *list, struct char_data *ch);
 
 void	extract_obj(struct obj_data *obj);
 
+void	obj_instance_add(struct obj_data *obj);
+void	obj_instance_remove(struct obj_data *obj);
+struct obj_data *obj_instances(obj_vnum vnum);
+
+extern std::vector<struct obj_data *> active_objs[NUM_ACTIVE_SETS];
+void	obj_activate(struct obj_data *obj, int set);
+void	obj_deactivate(struct obj_data *obj, int set);
+void	active_lock(int set);
+void	active_unlock(int set);
+
 /* ******* characters ********* */
 
 struct char_data *get_char_room(char *name, int *num, room_rnum room);
 struct char_data *get_char_num(mob_rnum nr);
+void	mob_instance_add(struct char_data *ch);
+void	mob_instance_remove(struct char_data *ch);
+struct char_data *mob_instances(mob_vnum vnum);
 
 void	char_from_room(struct char_data *ch);
 void	char_to_room(struct char_data *ch, room_rnum room);
+void	room_trig_sync(void *thing, int type);
 void	extract_char(struct char_data *ch);
 void	extract_char_final(struct char_data *ch);
 void	extract_pending_chars(void);
@@ -43,6 +43,10 @@ void	nanny(struct descriptor_data *d, char *arg);
 int	is_abbrev(const char *arg1, const char *arg2);
 int	is_number(const char *str);
 int	find_command(const char *command);
+int	lookup_command(const char *arg, int level, int admlevel);
+void	build_command_index(void);
+void	free_command_index(void);
+void	command_index_bench(struct char_data *ch);
 void	skip_spaces(char **string);
 char	*delete_doubledollar(char *string);
 
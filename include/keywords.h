@@ -0,0 +1,35 @@
+/* ************************************************************************
+*   File: keywords.h                                    Part of CircleMUD *
+*  Usage: header file: pre-split name keywords and the world name index   *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+#ifndef __KEYWORDS_H__
+#define __KEYWORDS_H__
+
+#include "structs.h"
+
+struct keyword_set {
+  std::string text;			/* the name it was split from	*/
+  std::string lower;			/* ... in lower case		*/
+  std::vector<std::string> words;	/* its words, in lower case	*/
+  int refs;				/* things filed under it	*/
+};
+
+const struct keyword_set *keywords_for(const char *name);
+int  keywords_match(const char *str, const struct keyword_set *kw);
+
+int  isname_obj(const char *str, struct obj_data *obj);
+int  isname_char(const char *str, struct char_data *ch);
+void obj_keywords_refresh(struct obj_data *obj);
+void char_keywords_refresh(struct char_data *ch);
+
+void keyword_file_obj(struct obj_data *obj);
+void keyword_unfile_obj(struct obj_data *obj);
+void keyword_file_char(struct char_data *ch);
+void keyword_unfile_char(struct char_data *ch);
+void keyword_find_objs(const char *str, std::vector<struct obj_data *> &found);
+void keyword_find_chars(const char *str, std::vector<struct char_data *> &found);
+
+#endif
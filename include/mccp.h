@@ -0,0 +1,28 @@
+/* ************************************************************************
+*   File: mccp.h                                        Part of CircleMUD *
+*  Usage: header file: MCCP2 stream compression, inline or on workers     *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+#ifndef __MCCP_H__
+#define __MCCP_H__
+
+#include "structs.h"
+
+#define MCCP_MAX_THREADS	16	/* upper bound for -z			*/
+#define MCCP_JOBS		16	/* jobs in flight per stream, power of 2 */
+#define MCCP_MAX_PENDING	MAX_SOCK_BUF	/* compressed bytes held for a slow socket */
+
+extern int mccp_threads;	/* worker threads, 0 = deflate on the game thread */
+
+int  mccp_init(void);
+void mccp_shutdown(void);
+void mccp_start(struct compr *comp);
+void mccp_end(struct compr *comp);
+ssize_t mccp_write(socklen_t desc, struct compr *comp, const struct iovec *iov, int cnt, int wait);
+int  mccp_pending(struct compr *comp);
+int  mccp_flush(socklen_t desc, struct compr *comp);
+void mccp_wait_all(void);
+
+#endif
@@ -0,0 +1,58 @@
+/* ************************************************************************
+*   File: pool.h                                        Part of CircleMUD *
+*  Usage: header file: typed slab pools for the busiest game structures   *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include "structs.h"
+
+/*
+ * Compile with -DPOOL_MALLOC (or -DMEMORY_DEBUG) to have every pool hand
+ * straight through to calloc() and free(), as ASan and zmalloc want, and
+ * with -DPOOL_DEBUG to poison freed items and check the poison on reuse.
+ */
+#if defined(POOL_MALLOC) || defined(MEMORY_DEBUG)
+#define POOL_PASSTHROUGH
+#endif
+
+#define POOL_SLAB_BYTES		(64 * 1024)	/* aim for slabs this size	*/
+#define POOL_SLAB_MIN		8	/* ... but at least this many items	*/
+#define POOL_ALIGN		16	/* items are aligned to this		*/
+#define POOL_POISON		0x5a	/* fill for freed items, in POOL_DEBUG	*/
+
+struct mem_slab;
+
+/* Defined with just a name and size; everything else starts at zero. */
+struct mem_pool {
+  const char *name;
+  size_t size;			/* of one item, rounded up to POOL_ALIGN */
+  int per_slab = 0;		/* items carved from each slab		*/
+  void *free_list = NULL;	/* freed items, most recent first	*/
+  struct mem_slab *slabs = NULL;
+
+  unsigned long live = 0;	/* items handed out now			*/
+  unsigned long peak = 0;	/* ... and the most there have been	*/
+  unsigned long idle = 0;	/* items waiting on free_list		*/
+  unsigned long num_slabs = 0;
+  unsigned long allocs = 0, frees = 0;
+};
+
+extern struct mem_pool char_pool;
+extern struct mem_pool obj_pool;
+extern struct mem_pool affect_pool;
+extern struct mem_pool script_pool;
+extern struct mem_pool trig_pool;
+
+void *pool_alloc(struct mem_pool *pool);
+void pool_free(struct mem_pool *pool, void *ptr);
+void pool_show(struct char_data *ch);
+
+/* As CREATE(result, type, 1) and free(), for things kept in a pool. */
+#define POOL_CREATE(result, type, pool)	((result) = (type *) pool_alloc(&(pool)))
+#define POOL_FREE(ptr, pool)		pool_free(&(pool), (ptr))
+
+#endif
@@ -0,0 +1,28 @@
+/* ************************************************************************
+*   File: profile.h                                     Part of CircleMUD *
+*  Usage: header file: per-phase timing of game_loop() passes             *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include "structs.h"
+
+#define PROF_MAX_PHASES		64
+#define PROF_MINUTES		60	/* longest window kept, in minutes	*/
+#define PROF_SUB_BITS		3	/* 2^n buckets per power of two	*/
+#define PROF_BUCKETS		(28 << PROF_SUB_BITS)	/* reaches past a minute in usec */
+#define PROF_WORST		5	/* phases named when a pass overruns	*/
+
+int  prof_phase(const char *name);
+unsigned long long prof_clock(void);
+void prof_add(int phase, unsigned long long nsec);
+unsigned long long prof_lap(int phase, unsigned long long since);
+void prof_end_pass(void);
+void prof_log_overrun(int missed_pulses);
+void prof_reset(void);
+void prof_show(struct char_data *ch);
+
+#endif
@@ -0,0 +1,44 @@
+/* ************************************************************************
+*   File: reactor.h                                     Part of CircleMUD *
+*  Usage: header file: pluggable socket readiness backends (epoll/select) *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+#ifndef __REACTOR_H__
+#define __REACTOR_H__
+
+#include "structs.h"
+
+/* Available backends. */
+#define REACTOR_EPOLL	0	/* edge-triggered epoll (default)	*/
+#define REACTOR_SELECT	1	/* classic select(), FD_SETSIZE bound	*/
+
+/* Readiness bits kept in descriptor_data.ready */
+#define REACT_READ	(1 << 0)	/* input pending			*/
+#define REACT_WRITE	(1 << 1)	/* socket can take more output		*/
+#define REACT_EXCEPT	(1 << 2)	/* error/out-of-band, kick them		*/
+#define REACT_QUEUED	(1 << 3)	/* descriptor is on ready_list		*/
+
+struct reactor_ops {
+  const char *name;
+  int  (*init)(socklen_t mother);
+  void (*shutdown)(void);
+  int  (*add)(struct descriptor_data *d);
+  void (*del)(struct descriptor_data *d);
+  int  (*poll)(int *mother_ready);
+};
+
+extern int reactor_type;
+extern struct descriptor_data *ready_list;
+
+int  reactor_init(socklen_t mother);
+void reactor_shutdown(void);
+const char *reactor_name(void);
+int  reactor_add(struct descriptor_data *d);
+void reactor_del(struct descriptor_data *d);
+int  reactor_poll(int *mother_ready);
+void reactor_mark(struct descriptor_data *d, int flags);
+void reactor_prune(void);
+
+#endif
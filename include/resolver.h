@@ -0,0 +1,33 @@
+/* ************************************************************************
+*   File: resolver.h                                    Part of CircleMUD *
+*  Usage: header file: background reverse DNS with a TTL cache            *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+#ifndef __RESOLVER_H__
+#define __RESOLVER_H__
+
+#include "structs.h"
+
+#define RESOLVER_THREADS	2	/* lookups that may block at once	*/
+#define RESOLVER_TTL		3600	/* seconds to trust a name		*/
+#define RESOLVER_NEG_TTL	300	/* seconds to remember a failure	*/
+#define RESOLVER_CACHE_MAX	4096	/* entries before expired ones go	*/
+
+/*
+ * Does the actual lookup, on a resolver thread.  Fills in 'host' and
+ * returns TRUE, or returns FALSE if the address has no name.
+ */
+typedef int (*resolver_backend)(struct in_addr addr, char *host, size_t len);
+
+extern resolver_backend resolver_lookup;
+
+void resolver_init(void);
+void resolver_shutdown(void);
+int  resolver_use_stub(const char *filename);
+int  resolver_cached(struct in_addr addr, char *host, size_t len);
+void resolver_request(struct in_addr addr);
+int  resolver_next(struct in_addr *addr, char *host, size_t len);
+
+#endif
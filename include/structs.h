@@ -1591,16 +1591,18 @@
 /* Variables for the output buffering system */
 #define MAX_SOCK_BUF            (96 * 1024) /* Size of kernel's sock buf   */
 #define MAX_PROMPT_LENGTH       1024          /* Max length of prompt        */
-#define GARBAGE_SPACE        512          /* Space for **OVERFLOW** etc  */
-#define SMALL_BUFSIZE        6020        /* Static output buffer size   */
-/* Max amount of output that can be buffered */
-#define LARGE_BUFSIZE       (MAX_SOCK_BUF - GARBAGE_SPACE - MAX_PROMPT_LENGTH)
+#define SMALL_BUFSIZE        6020        /* MCCP stream buffer size     */
+#define OUTBUF_SEGSIZE       4096        /* Size of one output segment  */
+/* Output queued past this is dropped until the client catches up */
+#define MAX_OUTBUF_QUEUE    (16 * MAX_SOCK_BUF)
 
 #define HISTORY_SIZE        5    /* Keep last 5 commands. */
 #define MAX_STRING_LENGTH    64936
 #define MAX_INPUT_LENGTH    2048    /* Max length per *line* of
 input */
 #define MAX_RAW_INPUT_LENGTH    4096    /* Max size of *raw* input */
+#define INPUT_QUEUE_LINES       64      /* Max queued commands, power of 2 */
+#define INPUT_ARENA_SIZE    (4 * MAX_INPUT_LENGTH) /* Text of queued commands */
 #define MAX_MESSAGES        100
 #define MAX_NAME_LENGTH        20
 #define MAX_PWD_LENGTH        30
@@ -1935,6 +1937,13 @@ struct obj_spellbook_spell {
     int pages;        /* How many pages does it take up */
 };
 
+/* Active object sets: the objects a periodic update has to visit */
+#define ACTIVE_HOMING		0	/* homing ki attacks, homing_update()	*/
+#define ACTIVE_HUGE		1	/* huge ki attacks, huge_update()	*/
+#define NUM_ACTIVE_SETS		2
+
+struct keyword_set;
+
 /* ================== Memory Structure for Objects ================== */
 struct obj_data {
     obj_vnum item_number;    /* Where in data-base			*/
@@ -1956,6 +1965,8 @@ struct obj_data {
     struct obj_affected_type affected[MAX_OBJ_AFFECT];  /* affects */
 
     char *name;                    /* Title of object :get etc.        */
+    const struct keyword_set *keywords; /* name split up, see keywords.c */
+    unsigned long list_seq;        /* place on object_list, 0 if off it */
     char *description;          /* When in room                     */
     char *short_description;       /* when worn/carry/in cont.         */
     char *action_description;      /* What to write when used          */
@@ -1973,9 +1984,16 @@ struct obj_data {
 
     struct trig_proto_list *proto_script; /* list of default triggers  */
     struct script_data *script;    /* script info for the object       */
+    long trig_types;               /* types counted in trig_room's totals */
+    room_vnum trig_room;
 
     struct obj_data *next_content; /* For 'contains' lists             */
+    struct obj_data *prev_content;
     struct obj_data *next;         /* For the object list              */
+    struct obj_data *prev;
+    struct obj_data *next_instance; /* Live objects of the same rnum   */
+    struct obj_data *prev_instance;
+    int active_pos[NUM_ACTIVE_SETS]; /* 1 + slot in each active set   */
 
     struct obj_spellbook_spell *sbinfo;  /* For spellbook info */
     struct char_data *sitting;       /* Who is sitting on me? */
@@ -2024,6 +2042,17 @@ struct room_direction_data {
 
 
 /* ================== Memory Structure for room ======================= */
+/*
+ * The trigger types among the mobs in a room, and among the objects lying
+ * in it or carried or worn by someone in it, with a count of each type.
+ */
+struct trig_presence {
+    long mob_types;
+    long obj_types;
+    unsigned short mob_count[NUM_MTRIG_TYPES];
+    unsigned short obj_count[NUM_OTRIG_TYPES];
+};
+
 struct room_data {
     room_vnum number;        /* Rooms number	(vnum)		      */
     zone_rnum zone;              /* Room zone (for resetting)          */
@@ -2042,6 +2071,7 @@ struct room_data {
 
     struct obj_data *contents;   /* List of items in room              */
     struct char_data *people;    /* List of NPC / PC in room           */
+    struct trig_presence trig;   /* Trigger types among those here     */
 
     int timed;                   /* For timed Dt's                     */
     int dmg;                     /* How damaged the room is            */
@@ -2250,6 +2280,32 @@ struct levelup_data {
     struct level_learn_entry *feats;    /* Head of linked list		*/
 };
 
+/* Case-insensitive hashing so name-keyed tables behave like strcasecmp(). */
+struct ci_hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const {
+        size_t h = 14695981039346656037ULL;
+        for (unsigned char c : s)
+            h = (h ^ (size_t) tolower(c)) * 1099511628211ULL;
+        return h;
+    }
+};
+
+struct ci_equal {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const {
+        return a.size() == b.size() && !strncasecmp(a.data(), b.data(), a.size());
+    }
+};
+
+/* In-memory copy of a character's intro (dub) and sense memory files */
+struct recog_memory {
+    std::unordered_map<std::string, std::string, ci_hash, ci_equal> intro; /* name -> dubbed name */
+    std::unordered_set<int> sense;    /* idnum for players, vnum for mobs	*/
+    bool intro_loaded, intro_dirty;
+    bool sense_loaded, sense_dirty;
+};
+
 enum ResurrectionMode : uint8_t {
     Costless = 0,
     Basic = 1,
@@ -2262,9 +2318,14 @@ struct char_data {
     mob_rnum nr;            /* Mob's rnum				*/
     room_rnum in_room;        /* Location (real room number)		*/
     room_rnum was_in_room;    /* location for linkdead people		*/
+    zone_rnum counted_zone;   /* zone counting us, if 'counted'		*/
+    bool counted;             /* in counted_zone's player count		*/
+    bool counted_mortal;      /* ... and in its mortal count		*/
     int wait;            /* wait for how many loops		*/
 
     char *name;            /* PC / NPC s name (kill ...  )		*/
+    const struct keyword_set *keywords; /* name split up, see keywords.c */
+    unsigned long list_seq;   /* place on character_list, 0 if off it	*/
     char *short_descr;        /* for NPC 'actions'			*/
     char *long_descr;        /* for 'look'				*/
     char *description;        /* Extra descriptions                   */
@@ -2300,6 +2361,7 @@ struct char_data {
     /* PC specials				*/
     struct mob_special_data mob_specials;
     /* NPC specials				*/
+    struct recog_memory *recog;    /* cached intro/sense files, NULL until used */
 
     struct affected_type *affected;
     /* affected by what spells		*/
@@ -2318,15 +2380,24 @@ struct char_data {
     /* list of default triggers		*/
     struct script_data *script;    /* script info for the object		*/
     struct script_memory *memory;    /* for mob memory triggers		*/
+    long trig_types;			/* types counted in trig_room's totals	*/
+    room_vnum trig_room;
 
     struct char_data *next_in_room;
     /* For room->people - list		*/
+    struct char_data *prev_in_room;
     struct char_data *next;    /* For either monster or ppl-list	*/
+    struct char_data *prev;
+    struct char_data *next_instance;	/* Live mobs of the same rnum	*/
+    struct char_data *prev_instance;
     struct char_data *next_fighting;
     /* For fighting list			*/
     struct char_data *next_affect;/* For affect wearoff			*/
+    struct char_data *prev_affect;
     struct char_data *next_affectv;
     /* For round based affect wearoff	*/
+    struct char_data *prev_affectv;
+    struct char_data *next_extract;	/* Queued for extract_pending_chars() */
 
     struct follow_type *followers;/* List of chars followers		*/
     struct char_data *master;    /* Who is char following?		*/
@@ -2702,28 +2773,58 @@ struct txt_block {
 };
 
 
-struct txt_q {
-    struct txt_block *head;
-    struct txt_block *tail;
+/*
+ * Queued input lines.  The text of every line lives in one arena, packed in
+ * queue order between 'lo' and 'hi', and the lines themselves are a ring of
+ * slices into it; lines can be pushed at either end (aliases go to the
+ * front) without touching malloc.
+ */
+struct input_line {
+    int off;                    /* offset of the text in the arena	*/
+    int len;                    /* length, not NUL terminated		*/
+    int aliased;
 };
 
-struct compr {
-    int state; /* 0 - off. 1 - waiting for response. 2 - compress2 on */
+struct input_q {
+    struct input_line lines[INPUT_QUEUE_LINES];
+    int head;                   /* ring index of the oldest line	*/
+    int count;                  /* lines queued			*/
+    int lo, hi;                 /* live part of the arena		*/
+    char arena[INPUT_ARENA_SIZE];
+};
+
+/*
+ * One link in a descriptor's output chain.  Text is appended at 'end' and
+ * written out from 'start'; a drained segment goes back to the pool.
+ */
+struct outbuf_seg {
+    struct outbuf_seg *next;
+    int start;                  /* first byte not yet sent           */
+    int end;                    /* first free byte                   */
+    char text[OUTBUF_SEGSIZE];
+};
 
-    Bytef *buff_out;
-    int total_out; /* size of input buffer */
-    int size_out; /* size of data in output buffer */
+struct compr {
+    int state; /* 0 - off. 1 - waiting for response. 2 - compress2 on. 3 - finishing */
 
-    Bytef *buff_in;
-    int total_in; /* size of input buffer */
-    int size_in; /* size of data in input buffer */
+    Bytef *buff_out; /* compressed data the socket hasn't taken yet */
+    size_t total_out; /* size of output buffer */
+    size_t size_out; /* size of data in output buffer */
+    size_t sent_out; /* how much of that has been written */
 
     z_streamp stream;
+    struct mccp_stream *async; /* worker side of the stream, if any */
+
+    unsigned long long raw_bytes; /* text fed to deflate */
+    unsigned long long zip_bytes; /* what came out of it */
+    unsigned long long cpu_nsec;  /* CPU time spent in deflate */
 };
 
 struct descriptor_data {
     socklen_t descriptor;    /* file descriptor for socket		*/
     char host[HOST_LENGTH + 1];    /* hostname				*/
+    struct in_addr addr;    /* numeric address, for the resolver	*/
+    int dns_pending;        /* host is numeric until the lookup ends	*/
     int8_t bad_pws;    /* number of bad pw attemps this login	*/
     int8_t idle_tics;        /* tics idle at password prompt		*/
     int connected;        /* mode of 'connectedness'		*/
@@ -2739,20 +2840,22 @@ struct descriptor_data {
     int32_t mail_to;        /* name for mail system			*/
     int has_prompt;        /* is the user at a prompt?             */
     char inbuf[MAX_RAW_INPUT_LENGTH];  /* buffer for raw input		*/
+    int inbuf_len;         /* bytes of raw input not yet made lines	*/
     char last_input[MAX_INPUT_LENGTH]; /* the last input			*/
-    char small_outbuf[SMALL_BUFSIZE];  /* standard output buffer		*/
-    char *output;        /* ptr to the current output buffer	*/
+    struct outbuf_seg *out_head;  /* oldest unsent output segment	*/
+    struct outbuf_seg *out_tail;  /* segment new output is appended to	*/
+    size_t out_len;        /* bytes of output waiting to be sent	*/
+    int out_overflow;      /* dropping output until the queue drains */
     char **history;        /* History of commands, for ! mostly.	*/
     int history_pos;        /* Circular array position.		*/
-    int bufptr;            /* ptr to end of current output		*/
-    int bufspace;        /* space left in the output buffer	*/
-    struct txt_block *large_outbuf; /* ptr to large buffer, if we need it */
-    struct txt_q input;        /* q of unprocessed input		*/
+    struct input_q input;      /* q of unprocessed input		*/
     struct char_data *character;    /* linked to char			*/
     struct char_data *original;    /* original char if switched		*/
     struct descriptor_data *snooping; /* Who is this char snooping	*/
     struct descriptor_data *snoop_by; /* And who is snooping this char	*/
     struct descriptor_data *next; /* link to next descriptor		*/
+    struct descriptor_data *next_ready; /* link in the reactor ready list	*/
+    int ready;                    /* REACT_xxx readiness bits            */
     struct oasis_olc_data *olc;   /* OLC info                            */
     struct compr *comp;                /* compression info */
     char *user;                   /* What user am I?                     */
@@ -2879,6 +2982,9 @@ struct index_data {
 
     char *farg;         /* string argument for special function     */
     struct trig_data *proto;     /* for triggers... the trigger     */
+
+    struct char_data *mobs;      /* live instances, if a mob        */
+    struct obj_data *objs;       /* live instances, if an object    */
 };
 
 /* linked list for mob/object prototype trigger lists */
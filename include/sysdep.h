@@ -52,6 +52,8 @@
 #include <vector>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
+#include <string_view>
 #include <memory>
 #include <algorithm>
 #include <set>
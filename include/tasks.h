@@ -0,0 +1,47 @@
+/* ************************************************************************
+*   File: tasks.h                                       Part of CircleMUD *
+*  Usage: header file: periodic heartbeat tasks on a timing wheel         *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+#ifndef __TASKS_H__
+#define __TASKS_H__
+
+#include "structs.h"
+
+#define TASK_WHEEL_BITS		8	/* slots per wheel level, as a power of 2 */
+#define TASK_WHEEL_SIZE		(1 << TASK_WHEEL_BITS)
+#define TASK_WHEEL_MASK		(TASK_WHEEL_SIZE - 1)
+
+#define TASK_STAGGER		(-1)	/* phase: pick one clear of other heavy tasks */
+
+/* Task flags */
+#define TASK_HEAVY		(1 << 0)	/* keep off other heavy tasks' pulses */
+
+struct tick_task {
+  const char *name;
+  void (*func)(void);
+  int period;			/* pulses between runs			*/
+  int phase;			/* runs when pulse % period == phase	*/
+  int flags;
+  int order;			/* registration order, for running	*/
+  int due;			/* next pulse to run on			*/
+  int prof;			/* its profile phase			*/
+
+  unsigned long runs;
+  unsigned long long total_nsec;
+  unsigned long long max_nsec;
+  unsigned long long last_nsec;
+
+  struct tick_task *next;	/* in task_list				*/
+  struct tick_task *next_slot;	/* in its wheel slot			*/
+};
+
+extern struct tick_task *task_list;
+
+struct tick_task *task_add(const char *name, void (*func)(void), int period, int phase, int flags);
+void task_run(int pulse);
+void task_reset_stats(void);
+
+#endif
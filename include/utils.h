@@ -54,6 +54,10 @@ const char *disp_align(struct char_data *ch);
 void senseCreate(struct char_data *ch);
 void sense_memory_write(struct char_data *ch, struct char_data *vict);
 int read_sense_memory(struct char_data *ch, struct char_data *vict);
+int load_intro_memory(struct char_data *ch);
+int load_sense_memory(struct char_data *ch);
+void save_recog_memory(struct char_data *ch);
+void free_recog_memory(struct char_data *ch);
 int roll_pursue(struct char_data *ch, struct char_data *vict);
 void broken_update(void);
 int wearable_obj(struct obj_data *obj);
@@ -276,6 +280,35 @@ int wield_type(int chsize, const struct obj_data *weap);
             }					\
       }						\
 
+/*
+ * The lists things come off all the time (character_list, object_list,
+ * room people and contents, inventories and containers, the affect
+ * lists) also keep a back link, so taking an item off is O(1) instead of
+ * a walk from the head.  Unlinking something that isn't on the list is
+ * harmless.  The item's own 'next' is left alone, as REMOVE_FROM_LIST
+ * leaves it, for the code that clears it or still follows it.
+ */
+#define LINK_TO_LIST(item, head, next, prev)	\
+   do {						\
+      (item)->prev = NULL;			\
+      if (((item)->next = (head)))		\
+         (head)->prev = (item);			\
+      (head) = (item);				\
+   } while (0)
+
+#define UNLINK_FROM_LIST(item, head, next, prev)	\
+   do {						\
+      if ((item)->prev)				\
+         (item)->prev->next = (item)->next;	\
+      else if ((head) == (item))		\
+         (head) = (item)->next;			\
+      else					\
+         break;					\
+      if ((item)->next)				\
+         (item)->next->prev = (item)->prev;	\
+      (item)->prev = NULL;			\
+   } while (0)
+
 /* basic bitvector utils *************************************************/
 
 
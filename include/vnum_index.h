@@ -0,0 +1,37 @@
+/***************************************************************************
+ *   File: vnum_index.h                                                    *
+ *  Usage: Paged vnum -> rnum lookup tables for rooms, mobiles and objects *
+ *                                                                         *
+ * This code is released under the CircleMud License                       *
+ ***************************************************************************/
+
+#ifndef __VNUM_INDEX_H__
+#define __VNUM_INDEX_H__
+
+#include "structs.h"
+
+/*
+ * A flat directory of fixed-size pages, each page a plain array of rnums.
+ * A lookup is two loads; pages are only allocated for vnum ranges that are
+ * actually used, so sparse zone layouts stay cheap.  Vnums at or above
+ * VNUM_INDEX_LIMIT are not indexed and fall back to binary search.
+ */
+#define VNUM_PAGE_BITS		10
+#define VNUM_PAGE_SIZE		(1 << VNUM_PAGE_BITS)
+#define VNUM_PAGE_MASK		(VNUM_PAGE_SIZE - 1)
+#define VNUM_INDEX_LIMIT	(1 << 24)
+
+struct vnum_index {
+  IDXTYPE **pages;	/* directory, indexed by vnum >> VNUM_PAGE_BITS	*/
+  size_t num_pages;	/* size of the directory			*/
+  int pages_used;	/* pages actually allocated			*/
+};
+
+struct vnum_index *vnum_index_init(void);
+void vnum_index_free(struct vnum_index *vi);
+int vnum_index_add(struct vnum_index *vi, IDXTYPE vnum, IDXTYPE rnum);
+void vnum_index_del(struct vnum_index *vi, IDXTYPE vnum);
+IDXTYPE vnum_index_find(struct vnum_index *vi, IDXTYPE vnum);
+void vnum_index_test(void);
+
+#endif
@@ -27,6 +27,8 @@
 #include "mail.h"
 #include "guild.h"
 #include "clan.h"
+#include "keywords.h"
+#include "pool.h"
 
 /* local functions */
 static void gen_map(struct char_data *ch, int num);
@@ -810,6 +812,7 @@ ACMD(do_nickname)
    sprintf(nick2, "%s %s", obj->name, arg2);
    obj->short_description = strdup(nick);
    obj->name = strdup(nick2);
+   obj_keywords_refresh(obj);
    return;
   } 
 }
@@ -882,11 +885,7 @@ void introCreate(struct char_data *ch)
 }
 
 int readIntro(struct char_data *ch, struct char_data *vict) {  
-  char fname[40], filler[50], scrap[100], line[256];
-  int known = FALSE;
-  FILE *fl;
-
-  /* Read Introduction File */
+  /* Read Introduction Memory */
   if (vict == NULL) {
     return 0;
   }
@@ -895,91 +894,31 @@ int readIntro(struct char_data *ch, struct char_data *vict) {
    return 1;
   }
 
-  if (!get_filename(fname, sizeof(fname), INTRO_FILE, GET_NAME(ch))) {
-    introCreate(ch);
-  }
-  if (!(fl = fopen(fname, "r"))) {
+  if (!load_intro_memory(ch)) {
     return 2;
   }
   if (vict == ch) {
-    fclose(fl);
     return 0;
   }
 
-  while (!feof(fl)) {
-    get_line(fl, line);
-    sscanf(line, "%s %s\n", filler, scrap);
-    if (!strcasecmp(GET_NAME(vict), filler)) {
-     known = TRUE;
-    }
-  }
-   fclose(fl);
-
-   if (known == TRUE)
+  if (ch->recog->intro.find(std::string_view(GET_NAME(vict))) != ch->recog->intro.end())
     return 1;
-   else
+  else
     return 0;
 }
 
+/* Remember vict as name; the intro file is rewritten by save_char(). */
 void introWrite(struct char_data *ch, struct char_data *vict, char *name)
 {
-  FILE *file;
-  char fname[40], filler[50], scrap[100], line[256];
-  char *names[500] = {""}, *alias[500] = {""};
-  FILE *fl;
-  int count = 0, x = 0;
-
-  /* Read Introduction File */
-  if (!get_filename(fname, sizeof(fname), INTRO_FILE, GET_NAME(ch))) {
-    introCreate(ch);
-  }
-  if (!(file = fopen(fname, "r"))) {
-    return;
-  }
-  while (!feof(file) || count < 498) {
-    get_line(file, line);
-    sscanf(line, "%s %s\n", filler, scrap);
-    names[count] = strdup(filler);
-    alias[count] = strdup(scrap);
-    count++;
-     *filler = '\0';
-     *scrap = '\0';
-  }
-  fclose(file);
-
-  /* Write Introduction File */
-
-  if (!get_filename(fname, sizeof(fname), INTRO_FILE, GET_NAME(ch)))
+  if (!load_intro_memory(ch)) {
     return;
-
-  if( !(fl = fopen(fname, "w")) ) {
-    log("ERROR: could not save intro file, %s, to filename, %s.", GET_NAME(ch), fname);
-    return;
-  }
-
-  while(x < count) {
-    if (x == 0 || strcasecmp(names[x-1], names[x])) {
-     if (strcasecmp(names[x], GET_NAME(vict))) {
-      fprintf(fl, "%s %s\n", names[x], alias[x]);
-     }
-    }
-    x++;
-  }
-
-  x = 0;
-  while (x < count) {
-   if (names[x] != NULL) {
-    free(names[x]);
-   } if (alias[x] != NULL) {
-    free(alias[x]);
-   }
-   x++;
   }
 
-  fprintf(fl, "%s %s\n", GET_NAME(vict), CAP(name));
+  ch->recog->intro.insert_or_assign(GET_NAME(vict), CAP(name));
+  ch->recog->intro_dirty = TRUE;
 
-  fclose(fl);
-  return;
+  if (!IS_NPC(ch))
+    SET_BIT_AR(PLR_FLAGS(ch), PLR_CRASH);
 }
 
 ACMD(do_intro)
@@ -7203,7 +7142,7 @@ ACMD(do_who)
 /* BIG OL' FIXME: Rewrite it all. Similar to do_who(). */
 ACMD(do_users)
 {
-  char line[200], line2[220], idletime[10];
+  char line[256], line2[276], idletime[10], ratio[16], zcpu[16];
   char state[30], *timeptr, mode;
   char name_search[MAX_INPUT_LENGTH], host_search[MAX_INPUT_LENGTH];
   struct char_data *tch;
@@ -7260,8 +7199,8 @@ ACMD(do_users)
     }
   }				/* end while (parser) */
   send_to_char(ch,
-         "Num Name                 User-name            State          Idl Login    C\r\n"
-         "--- -------------------- -------------------- -------------- --- -------- -\r\n");
+         "Num Name                 User-name            State          Idl Login    C Ratio  zCPU\r\n"
+         "--- -------------------- -------------------- -------------- --- -------- - ----- -----\r\n");
 
   one_argument(argument, arg);
 
@@ -7311,11 +7250,18 @@ ACMD(do_users)
     else
       strcpy(idletime, "");
 
-    sprintf(line, "%3d %-20s %-20s %-14s %-3s %-8s %1s ", d->desc_num,
+    /* MCCP: how well the stream compresses and what deflate has cost us */
+    if (d->comp->zip_bytes) {
+      snprintf(ratio, sizeof(ratio), "%4.1fx", (double)d->comp->raw_bytes / d->comp->zip_bytes);
+      snprintf(zcpu, sizeof(zcpu), "%.0fms", d->comp->cpu_nsec / 1000000.0);
+    } else
+      *ratio = *zcpu = '\0';
+
+    sprintf(line, "%3d %-20s %-20s %-14s %-3s %-8s %1s %5s %5s ", d->desc_num,
 	d->original && d->original->name ? d->original->name :
 	d->character && d->character->name ? d->character->name :
 	"UNDEFINED", d->user ? d->user : "UNKNOWN", state, idletime, timeptr,
-        d->comp->state ? d->comp->state == 1 ? "?" : "Y" : "N");
+        d->comp->state ? d->comp->state == 1 ? "?" : "Y" : "N", ratio, zcpu);
 
     if (d->host && *d->host)
       sprintf(line + strlen(line), "\n%3d [%s Site: %s]\r\n", d->desc_num, d->user ? d->user : "UNKNOWN", d->host);
@@ -8480,7 +8426,7 @@ ACMD(do_whois)
   if (!*argument) {
     send_to_char(ch, "Who?\r\n");
   } else {
-  CREATE(victim, struct char_data, 1);
+  POOL_CREATE(victim, struct char_data, char_pool);
   clear_char(victim);
   CREATE(victim->player_specials, struct player_special_data, 1);
   if (load_char(argument, victim) >= 0) {
@@ -8515,7 +8461,7 @@ ACMD(do_whois)
     } else {
     send_to_char(ch, "There is no such player.\r\n"); 
     }
-    free(victim); 
+    POOL_FREE(victim, char_pool);
   }
 }
 
@@ -28,6 +28,7 @@
 #include "genzon.h"
 #include "dg_scripts.h"
 #include "boards.h"
+#include "keywords.h"
 
 /* global variables */
 struct obj_data *obj_selling = NULL;	/* current object for sale */
@@ -1181,6 +1182,19 @@ void check_auction(void)
 	}
 }
 
+/* Is there a real (not forged) dragonball of this vnum anywhere? */
+int dball_exists(obj_vnum vnum)
+{
+ struct obj_data *k;
+
+ for (k = obj_instances(vnum); k; k = k->next_instance) {
+  if (!OBJ_FLAGGED(k, ITEM_FORGED)) {
+   return (TRUE);
+  }
+ }
+ return (FALSE);
+}
+
 void dball_load()
 {
  int found1 = FALSE, found2 = FALSE, found3 = FALSE;
@@ -1197,39 +1211,25 @@ if (dballtime == 0) {
  struct char_data *hunter = NULL;
  mob_rnum r_num;
 
+ struct obj_data *next_k;
+
  WISHTIME = 0;
- for (k = object_list; k; k = k->next) {
-  if (OBJ_FLAGGED(k, ITEM_FORGED)) {
+ found1 = dball_exists(20);
+ found2 = dball_exists(21);
+ found3 = dball_exists(22);
+ found4 = dball_exists(23);
+ found5 = dball_exists(24);
+ found6 = dball_exists(25);
+ found7 = dball_exists(26);
+ for (k = object_list; k; k = next_k) {
+  next_k = k->next;
+  if (OBJ_FLAGGED(k, ITEM_FORGED) || (GET_OBJ_VNUM(k) >= 20 && GET_OBJ_VNUM(k) <= 26)) {
    continue;
   }
-  if (GET_OBJ_VNUM(k) == 20) {
-   found1 = TRUE;
-  }
-  else if (GET_OBJ_VNUM(k) == 21) {
-   found2 = TRUE;
-  }
-  else if (GET_OBJ_VNUM(k) == 22) {
-   found3 = TRUE;
-  }
-  else if (GET_OBJ_VNUM(k) == 23) {
-   found4 = TRUE;
-  }
-  else if (GET_OBJ_VNUM(k) == 24) {
-   found5 = TRUE;
-  }
-  else if (GET_OBJ_VNUM(k) == 25) {
-   found6 = TRUE;
-  }
-  else if (GET_OBJ_VNUM(k) == 26) {
-   found7 = TRUE;
-  }
-  else if (IN_ROOM(k) != NOWHERE && ROOM_EFFECT(IN_ROOM(k)) == 6 && !OBJ_FLAGGED(k, ITEM_UNBREAKABLE)) {
+  if (IN_ROOM(k) != NOWHERE && ROOM_EFFECT(IN_ROOM(k)) == 6 && !OBJ_FLAGGED(k, ITEM_UNBREAKABLE)) {
    send_to_room(IN_ROOM(k), "@R%s@r melts in the lava!@n\r\n", k->short_description);
    extract_obj(k);
   }
-  else {
-   continue;
-  }
  }
   if (found1 == FALSE) {
    load = FALSE;
@@ -3360,6 +3360,7 @@ void name_from_drinkcon(struct obj_data *obj)
   if (GET_OBJ_RNUM(obj) == NOTHING || obj->name != obj_proto[GET_OBJ_RNUM(obj)].name)
     free(obj->name);
   obj->name = new_name;
+  obj_keywords_refresh(obj);
 }
 
 void name_to_drinkcon(struct obj_data *obj, int type)
@@ -3376,6 +3377,7 @@ void name_to_drinkcon(struct obj_data *obj, int type)
     free(obj->name);
 
   obj->name = new_name;
+  obj_keywords_refresh(obj);
 }
 
 ACMD(do_drink)
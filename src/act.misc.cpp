@@ -24,6 +24,7 @@
 #include "obj_edit.h"
 #include "fight.h"
 #include "class.h"
+#include "keywords.h"
 
 /* local functions  */
 static void generate_multiform(struct char_data *ch, int count);
@@ -253,6 +254,7 @@ static void generate_multiform(struct char_data *ch, int count)
         clone = read_mobile(r_num, REAL);
 
         clone->name = strdup(clone_name.c_str());
+        char_keywords_refresh(clone);
         clone->short_descr = strdup(clone_sdesc.c_str());
         clone->long_descr = strdup(clone_ldesc.c_str());
         if(ch->description)
@@ -1810,6 +1810,7 @@ ACMD(do_geno)
   KITYPE(obj) = SKILL_GENOCIDE;
   USER(obj) = ch;
   KIDIST(obj) = dista;
+  obj_activate(obj, ACTIVE_HUGE);
   pcost(ch, attperc, 0);
   act("@WYou raise one arm above your head and pour your charged ki there. A large swirling pink ball of energy begins to form above your raised hand. You grin viciously as the @mG@Me@wn@mo@Mc@wi@md@Me@W attack is complete and you toss it at @c$N@W!@n", TRUE, ch, 0, vict, TO_CHAR);
   act("@C$n@W raises one arm above $s head and pours $s charged ki there. A large swirling pink ball of energy begins to form above $s raised hand. @C$n@W grins viciously as the @mG@Me@wn@mo@Mc@wi@md@Me@W attack is complete and $e tosses it at YOU!@n", TRUE, ch, 0, vict, TO_VICT);
@@ -1919,6 +1920,7 @@ ACMD(do_genki)
   KITYPE(obj) = SKILL_GENKIDAMA;
   USER(obj) = ch;
   KIDIST(obj) = dista;
+  obj_activate(obj, ACTIVE_HUGE);
   pcost(ch, attperc, 0);
   act("@WYou raise both your arms upwards and begin to pool your charged ki there. You also start calling on the ki of all living beings in the vicinity who are willing to help. A large @cS@Cp@wi@cr@Ci@wt @cB@Co@wm@cb@W forms above your hands, when it is finished you lob it toward @c$N@W!@n", TRUE, ch, 0, vict, TO_CHAR);
   act("@C$n@W raises both $s arms upwards and begin to pool $s charged ki there. @C$n@W also starts calling on the ki of all living beings in the vicinity who are willing to help. A large @cS@Cp@wi@cr@Ci@wt @cB@Co@wm@cb@W forms above $s hands, when it is finished $e lobs it toward YOU!@n", TRUE, ch, 0, vict, TO_VICT);
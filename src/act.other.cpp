@@ -36,6 +36,7 @@
 #include "objsave.h"
 #include "mail.h"
 #include "clan.h"
+#include "pool.h"
 
 /* local functions */
 static int has_scanner(struct char_data *ch);
@@ -534,26 +535,9 @@ ACMD(do_rpp)
          return;
     } else {
      int found = FALSE;
-     struct obj_data *k = NULL;
-     for (k = object_list; k; k = k->next) {
-      if (OBJ_FLAGGED(k, ITEM_FORGED)) {
-       continue;
-      }
-      if (GET_OBJ_VNUM(k) == 20) {
-       found = TRUE;
-      } else if (GET_OBJ_VNUM(k) == 21) {
-       found = TRUE;
-      } else if (GET_OBJ_VNUM(k) == 22) {
-       found = TRUE;
-      } else if (GET_OBJ_VNUM(k) == 23) {
-       found = TRUE;
-      } else if (GET_OBJ_VNUM(k) == 24) {
-       found = TRUE;
-      } else if (GET_OBJ_VNUM(k) == 25) {
-       found = TRUE;
-      } else if (GET_OBJ_VNUM(k) == 26) {
-       found = TRUE;
-      }
+     obj_vnum ball;
+     for (ball = 20; ball <= 26 && !found; ball++) {
+      found = dball_exists(ball);
      }
      if (found == FALSE) {
       send_to_char(ch, "You have reduced the Dragon Ball wait by a whole real life day!\r\n");
@@ -10794,6 +10778,7 @@ ACMD(do_gen_tog)
     break;
   case SCMD_NOHASSLE:
     result = PRF_TOG_CHK(ch, PRF_NOHASSLE);
+    zone_occupancy_sync(ch);
     break;
   case SCMD_BRIEF:
     result = PRF_TOG_CHK(ch, PRF_BRIEF);
@@ -11988,7 +11973,7 @@ ACMD(do_clan) {
     } else if(clanOpenJoin(arg3)) {
       send_to_char(ch, "You can't kick someone out of an open-join clan.\r\n");
     } else if(!(vict = get_char_vis(ch, name1, NULL, FIND_CHAR_WORLD))) {
-       CREATE(vict, struct char_data, 1);
+       POOL_CREATE(vict, struct char_data, char_pool);
        clear_char(vict);
        CREATE(vict->player_specials, struct player_special_data, 1);
 
@@ -323,11 +323,13 @@ void create_command_list(void)
   complete_cmd_info[k].minimum_level   = 0; 
   complete_cmd_info[k].minimum_admlevel   = 0; 
   complete_cmd_info[k].subcmd      = 0; 
+  build_command_index();
   log("Command info rebuilt, %d total commands.", k); 
 }
 
 void free_command_list(void) 
 {
+  free_command_index();
   free(complete_cmd_info);
   complete_cmd_info = NULL;
 }
@@ -425,7 +427,7 @@ struct social_messg *find_social( const char *name )
 
 ACMD(do_gmote) 
 { 
-  int act_nr, length; 
+  int act_nr; 
   char arg[MAX_INPUT_LENGTH], buf[MAX_INPUT_LENGTH]; 
   struct social_messg *action; 
   struct char_data *vict = NULL; 
@@ -433,9 +435,7 @@ ACMD(do_gmote)
   half_chop(argument, buf, arg); 
 
   if(subcmd) 
-    for (length = strlen(buf), cmd = 0; *complete_cmd_info[cmd].command != '\n'; cmd++) 
-      if (!strncmp(complete_cmd_info[cmd].command, buf, length)) 
-        break; 
+    cmd = lookup_command(buf, INT_MAX, INT_MAX);
 
   if ((act_nr = find_action(cmd)) < 0) { 
     snprintf(buf, sizeof(buf), "@D[@BOOC@D: @g%s %s@n@D]", GET_ADMLEVEL(ch) < 1 ? ch->desc->user : GET_NAME(ch), argument);
@@ -38,6 +38,11 @@
 #include "shop.h"
 #include "guild.h"
 #include "spell_parser.h"
+#include "reactor.h"
+#include "mccp.h"
+#include "tasks.h"
+#include "profile.h"
+#include "pool.h"
 
 /* local variables */
 static int copyover_timer = 0; /* for timed copyovers */
@@ -2010,7 +2015,7 @@ ACMD(do_stat)
     else if ((victim = get_player_vis(ch, buf2, NULL, FIND_CHAR_WORLD)) != NULL)
 	do_stat_character(ch, victim);
     else {
-      CREATE(victim, struct char_data, 1);
+      POOL_CREATE(victim, struct char_data, char_pool);
       clear_char(victim);
       CREATE(victim->player_specials, struct player_special_data, 1);
       if (load_char(buf2, victim) >= 0) {
@@ -2205,6 +2210,7 @@ ACMD(do_switch)
 
     victim->desc = ch->desc;
     ch->desc = NULL;
+    zone_occupancy_sync(ch);
   }
 }
 
@@ -2233,6 +2239,7 @@ ACMD(do_return)
 
     /* And our body's pointer to descriptor now points to our descriptor. */
     ch->desc->character->desc = ch->desc;
+    zone_occupancy_sync(ch->desc->character);
     ch->desc = NULL;
   }
 }
@@ -2504,7 +2511,8 @@ static void execute_copyover(void)
 {
   FILE *fp;
   struct descriptor_data *d, *d_next;
-  char buf [100], buf2[100];
+  char buf [100], buf2[100], buf3[100], *args[8];
+  int nargs = 0;
 
   fp = fopen (COPYOVER_FILE, "w");
 
@@ -2541,12 +2549,7 @@ static void execute_copyover(void)
         }
       write_to_descriptor (d->descriptor, buf, d->comp);
       d->comp->state = 0;
-        if (d->comp->stream) {
-            deflateEnd(d->comp->stream);
-            free(d->comp->stream);
-            free(d->comp->buff_out);
-            free(d->comp->buff_in);
-        }
+      mccp_end(d->comp);
     }
   }
 
@@ -2563,11 +2566,20 @@ static void execute_copyover(void)
 
   sprintf (buf, "%d", port);
   sprintf (buf2, "-C%d", mother_desc);
+  sprintf (buf3, "-z%d", mccp_threads);
   chdir ("..");
-  execl (EXE_FILE, "circle", buf2, buf, (char *) NULL);
+  args[nargs++] = (char *) "circle";
+  if (reactor_type == REACTOR_SELECT)
+    args[nargs++] = (char *) "-S";
+  if (mccp_threads > 0)
+    args[nargs++] = buf3;
+  args[nargs++] = buf2;
+  args[nargs++] = buf;
+  args[nargs] = NULL;
+  execv (EXE_FILE, args);
   /* Failed - sucessful exec will not return */
 
-  perror ("do_copyover: execl");
+  perror ("do_copyover: execv");
   send_to_imm("Copyover FAILED!\n\r");
 
   exit (1); /* too much trouble to try to recover! */
@@ -2997,7 +3009,7 @@ ACMD(do_last)
     send_to_char(ch, "For whom do you wish to search?\r\n");
     return;
   }
-  CREATE(vict, struct char_data, 1);
+  POOL_CREATE(vict, struct char_data, char_pool);
   clear_char(vict);
   CREATE(vict->player_specials, struct player_special_data, 1);
   if (load_char(arg, vict) <  0) {
@@ -3370,8 +3382,9 @@ static size_t print_zone_to_buf(char *bufptr, size_t left, zone_rnum zone, int l
                         "         Mobiles:  %2d\r\n"
                         "         Shops:    %2d\r\n"
                         "         Triggers: %2d\r\n"
-                        "         Guilds:   %2d\r\n", 
-                          j, k, l, m, n, o);
+                        "         Guilds:   %2d\r\n"
+                        "         Players:  %2d (%d without nohassle)\r\n",
+                          j, k, l, m, n, o, zone_table[zone].players, zone_table[zone].mortals);
         
     return tmp;
   } 
@@ -3397,6 +3410,9 @@ ACMD(do_show)
   char field[MAX_INPUT_LENGTH], value[MAX_INPUT_LENGTH], *strp,
 	arg[MAX_INPUT_LENGTH], buf[MAX_STRING_LENGTH];
   extern int top_of_trigt;
+  int uid_entries, uid_slots, uid_probe;
+  double uid_avg_probe;
+  unsigned long uid_misses;
 
   struct show_struct {
     const char *cmd;
@@ -3478,7 +3494,7 @@ ACMD(do_show)
       return;
     }
 
-    CREATE(vict, struct char_data, 1);
+    POOL_CREATE(vict, struct char_data, char_pool);
     clear_char(vict);
     CREATE(vict->player_specials, struct player_special_data, 1);
     if (load_char(value, vict) < 0) {
@@ -3529,6 +3545,7 @@ ACMD(do_show)
     }
     for (obj = object_list; obj; obj = obj->next)
       k++;
+    lookup_table_stats(&uid_entries, &uid_slots, &uid_probe, &uid_avg_probe, &uid_misses);
     send_to_char(ch,
 	"             @D---   @CCore Stats   @D---\r\n"
 	"  @Y%5d@W players in game  @y%5d@W connected\r\n"
@@ -3537,8 +3554,9 @@ ACMD(do_show)
 	"  @Y%5d@W objects          @y%5d@W prototypes\r\n"
 	"  @Y%5d@W rooms            @y%5d@W zones\r\n"
         "  @Y%5d@W triggers\r\n"
-	"  @Y%5d@W large bufs\r\n"
-	"  @Y%5d@W buf switches     @y%5d@W overflows\r\n"
+	"  @Y%5d@W uids             @y%5d@W slots, probes @y%.2f@W avg @y%d@W max, @y%lu@W misses\r\n"
+	"  @Y%5d@W output segments\r\n"
+	"  @Y%5d@W seg chains       @y%5d@W overflows\r\n"
         "             @D--- @CMiscellaneous  @D---\r\n"
         "  @Y%5s@W Mob ki attacks this boot\r\n"
         "  @Y%5s@W Asssassins Generated@n\r\n"
@@ -3549,6 +3567,7 @@ ACMD(do_show)
 	k, top_of_objt + 1,
 	top_of_world + 1, top_of_zone_table + 1,
 	top_of_trigt + 1,
+	uid_entries, uid_slots, uid_avg_probe, uid_probe, uid_misses,
 	buf_largecount,
 	buf_switches, buf_overflows,
         add_commas(mob_specials_used),
@@ -4033,6 +4052,7 @@ static int perform_set(struct char_data *ch, struct char_data *vict, int mode,
       return (0);
     }
     SET_OR_REMOVE(PRF_FLAGS(vict), PRF_NOHASSLE);
+    zone_occupancy_sync(vict);
     break;
   case 26:
     if (ch == vict && on) {
@@ -4438,7 +4458,7 @@ ACMD(do_set)
     }
   } else if (is_file) {
     /* try to load the player off disk */
-    CREATE(cbuf, struct char_data, 1);
+    POOL_CREATE(cbuf, struct char_data, char_pool);
     clear_char(cbuf);
     CREATE(cbuf->player_specials, struct player_special_data, 1);
     if ((player_i = load_char(name, cbuf)) > -1) {
@@ -5529,3 +5549,52 @@ ACMD(do_boom)
 
   send_to_outdoor("%s shakes the world with a mighty boom!\r\n", GET_NAME(ch));
 }
+
+ACMD(do_tasks)
+{
+  struct tick_task *t;
+  char arg[MAX_INPUT_LENGTH];
+
+  one_argument(argument, arg);
+
+  if (*arg && is_abbrev(arg, "reset")) {
+    task_reset_stats();
+    send_to_char(ch, "Task statistics cleared.\r\n");
+    return;
+  } else if (*arg) {
+    send_to_char(ch, "Usage: tasks [reset]\r\n");
+    return;
+  }
+
+  send_to_char(ch, "Task             Period Phase Heavy       Runs    Avg ms    Max ms   Last ms\r\n"
+                   "---------------- ------ ----- ----- ---------- --------- --------- ---------\r\n");
+  for (t = task_list; t; t = t->next)
+    send_to_char(ch, "%-16s %6d %5d %-5s %10lu %9.3f %9.3f %9.3f\r\n", t->name, t->period, t->phase,
+                 IS_SET(t->flags, TASK_HEAVY) ? "yes" : "no", t->runs,
+                 t->runs ? t->total_nsec / (double) t->runs / 1000000.0 : 0.0,
+                 t->max_nsec / 1000000.0, t->last_nsec / 1000000.0);
+}
+
+ACMD(do_profile)
+{
+  char arg[MAX_INPUT_LENGTH];
+
+  one_argument(argument, arg);
+
+  if (*arg && is_abbrev(arg, "reset")) {
+    prof_reset();
+    send_to_char(ch, "Profile histograms cleared.\r\n");
+  } else if (*arg && is_abbrev(arg, "commands"))
+    command_index_bench(ch);
+  else if (*arg && is_abbrev(arg, "fields"))
+    dg_field_bench(ch);
+  else if (*arg)
+    send_to_char(ch, "Usage: profile [reset | commands | fields]\r\n");
+  else
+    prof_show(ch);
+}
+
+ACMD(do_pools)
+{
+  pool_show(ch);
+}
@@ -399,6 +399,9 @@ void cedit_save_internally(struct descriptor_data *d)
   CONFIG_PULSE_TIMESAVE       = OLC_CONFIG(d)->ticks.pulse_timesave;
   CONFIG_PULSE_CURRENT        = OLC_CONFIG(d)->ticks.pulse_current;
 
+  /* Let the heartbeat tasks pick up the new pulse lengths. */
+  heartbeat_init();
+
   /****************************************************************************/
   /** Character Creation Method                                              **/
   /****************************************************************************/
@@ -1715,23 +1715,30 @@ void huge_update()
 {
  int dge = 0, skill = 0, bonus = 1, count = 0;
  int64_t dmg = 0;
- struct obj_data *k;
+ struct obj_data *k, *next_k;
  struct char_data *ch, *vict, *next_v;
+ room_rnum aucroom;
+ size_t i;
  
- /* Checking the object list for any huge ki attacks */
- for (k = object_list; k; k = k->next) {
-  if (GET_AUCTER(k) > 0 && GET_AUCTIME(k) + 604800 <= time(0)) {
-   if (IN_ROOM(k) && GET_ROOM_VNUM(IN_ROOM(k)) == 80) {
-    room_vnum inroom = IN_ROOM(k);
-    REMOVE_BIT_AR(ROOM_FLAGS(inroom), ROOM_HOUSE_CRASH);
+ /* Auctions that have sat out their week in the auction room */
+ if ((aucroom = real_room(80)) != NOWHERE) {
+  for (k = world[aucroom].contents; k; k = next_k) {
+   next_k = k->next_content;
+   if (GET_AUCTER(k) > 0 && GET_AUCTIME(k) + 604800 <= time(0)) {
+    REMOVE_BIT_AR(ROOM_FLAGS(aucroom), ROOM_HOUSE_CRASH);
     extract_obj(k);
-    continue;
    }
-  }  
-  if (KICHARGE(k) <= 0) {
+  }
+ }
+
+ /* Checking the huge ki attacks in flight */
+ active_lock(ACTIVE_HUGE);
+ for (i = 0; i < active_objs[ACTIVE_HUGE].size(); i++) {
+  if (!(k = active_objs[ACTIVE_HUGE][i])) {
    continue;
   }
-  if (GET_OBJ_VNUM(k) != 82 && GET_OBJ_VNUM(k) != 83) {
+  if (KICHARGE(k) <= 0) {
+   obj_deactivate(k, ACTIVE_HUGE);
    continue;
   }
   else if (KIDIST(k) <= 0) {
@@ -2092,6 +2099,7 @@ void huge_update()
    act("$p@W descends slowly towards the ground!@n", TRUE, 0, k, 0, TO_ROOM);
    KIDIST(k)--;
  } 
+ active_unlock(ACTIVE_HUGE);
 
 }
 /* End huge ki attack update */
@@ -2100,12 +2108,15 @@ void huge_update()
 void homing_update()
 {
  struct obj_data *k;
+ size_t i;
 
- for (k = object_list; k; k = k->next) {
-  if (!k || k == NULL)
+ active_lock(ACTIVE_HOMING);
+ for (i = 0; i < active_objs[ACTIVE_HOMING].size(); i++) {
+  if (!(k = active_objs[ACTIVE_HOMING][i]))
    continue;
 
   if (KICHARGE(k) <= 0) {
+   obj_deactivate(k, ACTIVE_HOMING);
    continue;
   }
 
@@ -2253,6 +2264,7 @@ void homing_update()
    } // Spiritball attack
   } // pursue the target.
  } // End for
+ active_unlock(ACTIVE_HOMING);
 }
 
 /* For checking if they have enough free limbs to preform the technique. */
@@ -2862,6 +2874,7 @@ void dodge_ki(struct char_data *ch, struct char_data *vict, int type, int type2,
     KICHARGE(obj) = damtype(ch, type2, skill, .2);
     KITYPE(obj) = skill2;
     USER(obj) = ch;
+    obj_activate(obj, ACTIVE_HOMING);
    } else {
     act("@RIt fails to follow after @r$N@R!@n", TRUE, ch, 0, vict, TO_CHAR);
     act("@RIt fails to follow after YOU!@n", TRUE, ch, 0, vict, TO_VICT);
@@ -2908,6 +2921,7 @@ void dodge_ki(struct char_data *ch, struct char_data *vict, int type, int type2,
     KICHARGE(obj) = damtype(ch, type2, skill, .3);
     KITYPE(obj) = skill2;
     USER(obj) = ch;
+    obj_activate(obj, ACTIVE_HOMING);
   }
 }
 
@@ -40,6 +40,12 @@
 #include "races.h"
 #include "constants.h"
 #include "screen.h"
+#include "reactor.h"
+#include "mccp.h"
+#include "resolver.h"
+#include "tasks.h"
+#include "profile.h"
+#include "pool.h"
 
 /* externs */
 
@@ -49,10 +55,10 @@ int passcomm(struct char_data *ch, char *comm);
 
 /* local globals */
 struct descriptor_data *descriptor_list = NULL;		/* master desc list */
-struct txt_block *bufpool = 0;	/* pool of large output buffers */
-int buf_largecount = 0;		/* # of large buffers which exist */
+struct outbuf_seg *outbuf_pool = NULL;	/* pool of free output segments */
+int buf_largecount = 0;		/* # of output segments which exist */
 int buf_overflows = 0;		/* # of overflows of output */
-int buf_switches = 0;		/* # of switches from small to large buf */
+int buf_switches = 0;		/* # of times output spilled into another segment */
 int circle_shutdown = 0;	/* clean shutdown */
 int circle_reboot = 0;		/* reboot the game after a shutdown */
 int no_specials = 0;		/* Suppress ass. of special routines */
@@ -72,15 +78,12 @@ socklen_t mother_desc;
 char *last_act_message = NULL;
 
 
-void *z_alloc(void *opaque, uInt items, uInt size)
-{
-    return calloc(items, size);
-}
+static void outbuf_put_seg(struct outbuf_seg *seg);
+static void check_resolved_hosts(void);
 
-void z_free(void *opaque, void *address)
-{
-    return free(address);
-}
+/* Profile phases for game_loop() and heartbeat(); see heartbeat_init(). */
+static int prof_pass, prof_poll, prof_input, prof_commands, prof_output;
+static int prof_imc, prof_events, prof_extract;
 
 /***********************************************************************
 *  main game loop and related stuff                                    *
@@ -139,6 +142,18 @@ void copyover_recover()
     init_descriptor (d,desc); /* set up various stuff */
 		
     strcpy(d->host, host);
+
+    /* a descriptor the reactor isn't watching would never be heard from */
+    if (reactor_add(d) < 0) {
+      log("SYSERR: copyover_recover: unable to watch descriptor %d, dropping %s.", desc, name);
+      write_to_descriptor(desc, "\n\rSomehow, your connection was lost during the folding. Sorry.\n\r", NULL);
+      close(desc);
+      free(d->history);
+      free(d->comp);
+      free(d);
+      continue;
+    }
+
     d->next = descriptor_list;
     descriptor_list = d;
 
@@ -146,7 +161,7 @@ void copyover_recover()
 	
     /* Now, find the pfile */
 		
-    CREATE(d->character, struct char_data, 1);
+    POOL_CREATE(d->character, struct char_data, char_pool);
     clear_char(d->character);
     CREATE(d->character->player_specials, struct player_special_data, 1);
     d->character->desc = d;
@@ -179,6 +194,7 @@ void copyover_recover()
        enter_player_game(d);
        GET_LOADROOM(d->character) = set_loadroom;
        d->connected = CON_PLAYING;
+       zone_occupancy_sync(d->character);
        look_at_room(IN_ROOM(d->character), d->character, 0);
        if (AFF_FLAGGED(d->character, AFF_HAYASA)) {
         GET_SPEEDBOOST(d->character) = GET_SPEEDCALC(d->character) * 0.5;
@@ -205,6 +221,13 @@ void init_game(uint16_t cmport)
   }
 
 
+  if (reactor_init(mother_desc) < 0) {
+    log("SYSERR: Unable to start any network reactor.");
+    exit(1);
+  }
+
+  mccp_init();
+  resolver_init();
   event_init();
 
   /* set up hash table for find_char() */
@@ -246,6 +269,8 @@ void init_game(uint16_t cmport)
   if (fCopyOver) /* reload players */
     copyover_recover();
 
+  heartbeat_init();
+
   log("Entering game loop.");
 
   game_loop(mother_desc);
@@ -257,6 +282,9 @@ void init_game(uint16_t cmport)
     close_socket(descriptor_list);
 
   close(mother_desc);
+  reactor_shutdown();
+  mccp_shutdown();
+  resolver_shutdown();
 
   if (CONFIG_IMC_ENABLED) {
     imc_shutdown(FALSE);
@@ -383,12 +411,13 @@ int get_max_players(void)
  */
 void game_loop(socklen_t cmmother_desc)
 {
-  fd_set input_set, output_set, exc_set, null_set;
+  fd_set input_set, null_set;
   struct timeval last_time, opt_time, process_time, temp_time;
   struct timeval before_sleep, now, timeout;
   char comm[MAX_INPUT_LENGTH];
   struct descriptor_data *d, *next_d;
-  int missed_pulses, maxdesc, aliased, top_desc;
+  int missed_pulses, aliased, top_desc, mother_ready, result;
+  unsigned long long pass_start, mark;
 
   /* initialize various time values */
   null_time.tv_sec = 0;
@@ -430,21 +459,6 @@ void game_loop(socklen_t cmmother_desc)
          }
       gettimeofday(&last_time, (struct timezone *) 0);
     }
-    /* Set up the input, output, and exception sets for select(). */
-    FD_ZERO(&input_set);
-    FD_ZERO(&output_set);
-    FD_ZERO(&exc_set);
-    FD_SET(cmmother_desc, &input_set);
-
-    maxdesc = cmmother_desc;
-    for (d = descriptor_list; d; d = d->next) {
-        if (d->descriptor > maxdesc)
-            maxdesc = d->descriptor;
-      FD_SET(d->descriptor, &input_set);
-      FD_SET(d->descriptor, &output_set);
-      FD_SET(d->descriptor, &exc_set);
-    }
-
     /*
      * At this point, we have completed all input, output and heartbeat
      * activity from the previous iteration, so we have to put ourselves
@@ -468,6 +482,10 @@ void game_loop(socklen_t cmmother_desc)
       process_time.tv_usec = process_time.tv_usec % OPT_USEC;
     }
 
+    /* Say where the time went if the last pass ran long. */
+    if (missed_pulses > 0)
+      prof_log_overrun(missed_pulses);
+
     /* Calculate the time we should wake up */
     timediff(&temp_time, &opt_time, &process_time);
     timeadd(&last_time, &before_sleep, &temp_time);
@@ -483,33 +501,40 @@ void game_loop(socklen_t cmmother_desc)
       timediff(&timeout, &last_time, &now);
     } while (timeout.tv_usec || timeout.tv_sec);
 
+    pass_start = mark = prof_clock();
+
     /* Poll (without blocking) for new input, output, and exceptions */
-    if (select(maxdesc + 1, &input_set, &output_set, &exc_set, &null_time) < 0) {
-      perror("SYSERR: Select poll");
+    if (reactor_poll(&mother_ready) < 0) {
+      perror("SYSERR: Reactor poll");
       return;
     }
     /* If there are new connections waiting, accept them. */
-    if (FD_ISSET(cmmother_desc, &input_set))
+    if (mother_ready)
       new_descriptor(cmmother_desc);
 
+    /* Pick up any hostnames the resolver has found. */
+    check_resolved_hosts();
+
     /* Kick out the freaky folks in the exception set and marked for close */
-    for (d = descriptor_list; d; d = next_d) {
-      next_d = d->next;
-      if (FD_ISSET(d->descriptor, &exc_set)) {
-	FD_CLR(d->descriptor, &input_set);
-	FD_CLR(d->descriptor, &output_set);
+    for (d = ready_list; d; d = next_d) {
+      next_d = d->next_ready;
+      if (d->ready & REACT_EXCEPT)
 	close_socket(d);
-      }
     }
+    mark = prof_lap(prof_poll, mark);
 
     /* Process descriptors with input pending */
-    for (d = descriptor_list; d; d = next_d) {
-      next_d = d->next;
-      if (FD_ISSET(d->descriptor, &input_set))
+    for (d = ready_list; d; d = next_d) {
+      next_d = d->next_ready;
+      if (d->ready & REACT_READ)
 	if (process_input(d) < 0)
         close_socket(d);
     }
 
+    /* Anything process_input() drained waits for the next reactor edge. */
+    reactor_prune();
+    mark = prof_lap(prof_input, mark);
+
     /* Process commands we just read from process_input */
     for (d = descriptor_list; d; d = next_d) {
       next_d = d->next;
@@ -560,18 +585,36 @@ void game_loop(socklen_t cmmother_desc)
 	command_interpreter(d->character, comm); /* Send it to interpreter */
       }
     }
+    mark = prof_lap(prof_commands, mark);
 
     /* Send queued output out to the operating system (ultimately to user). */
     for (d = descriptor_list; d; d = next_d) {
       next_d = d->next;
-      if (*(d->output) && FD_ISSET(d->descriptor, &output_set)) {
+      if (d->out_len && (d->ready & REACT_WRITE)) {
 	/* Output for this player is ready */
 	if (process_output(d) < 0) {
         close_socket(d);
 	  log("ERROR: Tried to send output to dead socket!");
-        }
-	else
+        } else {
 	  d->has_prompt = 1;
+	  /* Leftovers mean the kernel buffer filled; wait for EPOLLOUT. */
+	  /* Compressed streams find that out in the MCCP flush below. */
+	  if (d->out_len && !d->comp->stream)
+	    d->ready &= ~REACT_WRITE;
+	}
+      }
+    }
+
+    /* Compressed output goes out once the MCCP workers are done with it. */
+    mccp_wait_all();
+    for (d = descriptor_list; d; d = next_d) {
+      next_d = d->next;
+      if (mccp_pending(d->comp) && (d->ready & REACT_WRITE)) {
+        if ((result = mccp_flush(d->descriptor, d->comp)) < 0) {
+          close_socket(d);
+          log("ERROR: Tried to send output to dead socket!");
+        } else if (result > 0)
+          d->ready &= ~REACT_WRITE;
       }
     }
 
@@ -590,6 +633,7 @@ void game_loop(socklen_t cmmother_desc)
       if (STATE(d) == CON_CLOSE || STATE(d) == CON_DISCONNECT)
           close_socket(d);
     }
+    mark = prof_lap(prof_output, mark);
 
     /*
      * Now, we execute as many pulses as necessary--just one if we haven't
@@ -611,8 +655,12 @@ void game_loop(socklen_t cmmother_desc)
 
     if (CONFIG_IMC_ENABLED) {
       imc_loop();
+      mark = prof_lap(prof_imc, mark);
     }
 
+    /* Catch players who went into or out of menus and editors. */
+    zone_occupancy_sweep();
+
     /* Now execute the heartbeat functions */
     while (missed_pulses--)
       heartbeat(++pulse);
@@ -633,99 +681,114 @@ void game_loop(socklen_t cmmother_desc)
 
       /* Update tics for deadlock protection */
       tics_passed++;
+
+    prof_add(prof_pass, prof_clock() - pass_start);
+    prof_end_pass();
   }
 }
 
 
-void heartbeat(int heart_pulse)
+/* Wrappers for the tasks that need more than a bare call. */
+static void homing_task(void)
 {
-  static int mins_since_crashsave = 0;
-
-  event_process();
+  if (rand_number(1, 2) == 2)
+    homing_update();
+}
 
-  if (!(heart_pulse % PULSE_DG_SCRIPT))
-    script_trigger_check();
 
-  if (!(heart_pulse % PULSE_ZONE))
-    zone_update();
+static void hour_task(void)
+{
+  weather_and_time(1);
+  check_time_triggers();
+}
 
-  if (!(heart_pulse % PULSE_IDLEPWD))		/* 15 seconds */
-    check_idle_passwords();
 
-  if (!(heart_pulse % (PULSE_1SEC * 60)))           /* 15 seconds */
-    check_idle_menu();
+static void autosave_task(void)
+{
+  static int mins_since_crashsave = 0;
 
-  if (!(heart_pulse % (PULSE_IDLEPWD / 15))) {           /* 1 second */
-    dball_load();
-  }
-  if (!(heart_pulse % (PULSE_2SEC))) {
-    base_update();
-    fish_update();
-  }
+  if (!CONFIG_AUTO_SAVE)
+    return;
 
-  if (!(heart_pulse % (PULSE_1SEC * 15))) {
-   handle_songs();
+  clan_update();
+  if (++mins_since_crashsave >= CONFIG_AUTOSAVE_TIME) {
+    mins_since_crashsave = 0;
+    Crash_save_all();
+    House_save_all();
   }
+}
 
-  if (!(heart_pulse % (PULSE_1SEC)))
-    wishSYS();
-
-  if (!(heart_pulse % PULSE_MOBILE))
-    mobile_activity();
 
-  if (!(heart_pulse % PULSE_AUCTION))
-    check_auction();
+static void mudtime_task(void)
+{
+  save_mud_time(&time_info);
+}
 
-  if (!(heart_pulse % (PULSE_IDLEPWD / 15))) {
-    fight_stack();
-  }
-  if (!(heart_pulse % ((PULSE_IDLEPWD / 15) * 2))) {
-    if (rand_number(1, 2) == 2) {
-     homing_update();
-    }
-    huge_update();
-    broken_update();
-    /*update_mob_absorb();*/
-  }
 
-  if (!(heart_pulse % (1 * PASSES_PER_SEC))) { /* EVERY second */ 
-    copyover_check(); 
-  }
+static void timed_dt_task(void)
+{
+  timed_dt(NULL);
+}
 
-  if (!(heart_pulse % PULSE_VIOLENCE)) {
-    affect_update_violence();
-  }
 
-  if (!(heart_pulse % (SECS_PER_MUD_HOUR * PASSES_PER_SEC))) {
-    weather_and_time(1);
-    check_time_triggers();
-    affect_update();
-  }
-  if (!(heart_pulse % ((SECS_PER_MUD_HOUR / 3) * PASSES_PER_SEC))) {
-    point_update();
-  }
+/*
+ * Register the periodic tasks heartbeat() runs.  Called again when cedit
+ * changes the pulse lengths; tasks already known just pick up the new
+ * periods.  The heavy updates are staggered so they don't all land on
+ * the same pulse.
+ */
+void heartbeat_init(void)
+{
+  /* game_loop()'s own phases head the profile, the whole pass first. */
+  prof_pass = prof_phase("pass");
+  prof_poll = prof_phase("poll");
+  prof_input = prof_phase("input");
+  prof_commands = prof_phase("commands");
+  prof_output = prof_phase("output");
+  prof_imc = prof_phase("imc");
+  prof_events = prof_phase("events");
+  prof_extract = prof_phase("extract");
+
+  task_add("dg scripts", script_trigger_check, PULSE_DG_SCRIPT, TASK_STAGGER, TASK_HEAVY);
+  task_add("zone reset", zone_update, PULSE_ZONE, TASK_STAGGER, TASK_HEAVY);
+  task_add("idle passwd", check_idle_passwords, PULSE_IDLEPWD, 0, 0);
+  task_add("idle menu", check_idle_menu, PULSE_1SEC * 60, 0, 0);
+  task_add("dragonballs", dball_load, PULSE_IDLEPWD / 15, 0, 0);
+  task_add("base update", base_update, PULSE_2SEC, TASK_STAGGER, TASK_HEAVY);
+  task_add("fishing", fish_update, PULSE_2SEC, 0, 0);
+  task_add("songs", handle_songs, PULSE_1SEC * 15, 0, 0);
+  task_add("wishes", wishSYS, PULSE_1SEC, 0, 0);
+  task_add("mobiles", mobile_activity, PULSE_MOBILE, TASK_STAGGER, TASK_HEAVY);
+  task_add("auction", check_auction, PULSE_AUCTION, 0, 0);
+  task_add("fight stack", fight_stack, PULSE_IDLEPWD / 15, 0, 0);
+  task_add("homing", homing_task, (PULSE_IDLEPWD / 15) * 2, 0, 0);
+  task_add("huge update", huge_update, (PULSE_IDLEPWD / 15) * 2, TASK_STAGGER, TASK_HEAVY);
+  task_add("broken update", broken_update, (PULSE_IDLEPWD / 15) * 2, TASK_STAGGER, TASK_HEAVY);
+  task_add("copyover", copyover_check, PULSE_1SEC, 0, 0);
+  task_add("violence", affect_update_violence, PULSE_VIOLENCE, 0, 0);
+  task_add("mud hour", hour_task, SECS_PER_MUD_HOUR * PASSES_PER_SEC, 0, 0);
+  task_add("affects", affect_update, SECS_PER_MUD_HOUR * PASSES_PER_SEC, TASK_STAGGER, TASK_HEAVY);
+  task_add("points", point_update, (SECS_PER_MUD_HOUR / 3) * PASSES_PER_SEC, TASK_STAGGER, TASK_HEAVY);
+  task_add("autosave", autosave_task, PULSE_AUTOSAVE, TASK_STAGGER, TASK_HEAVY);
+  task_add("usage", record_usage, PULSE_USAGE, 0, 0);
+  task_add("mud time", mudtime_task, PULSE_TIMESAVE, 0, 0);
+  task_add("timed dt", timed_dt_task, 30 * PASSES_PER_SEC, 0, 0);
+}
 
-  if (CONFIG_AUTO_SAVE && !(heart_pulse % PULSE_AUTOSAVE)) {	/* 1 minute */
-      clan_update();
-    if (++mins_since_crashsave >= CONFIG_AUTOSAVE_TIME) {
-      mins_since_crashsave = 0;
-      Crash_save_all();
-      House_save_all();
-    }
-  }
 
-  if (!(heart_pulse % PULSE_USAGE))
-    record_usage();
+void heartbeat(int heart_pulse)
+{
+  unsigned long long mark = prof_clock();
 
-  if (!(heart_pulse % PULSE_TIMESAVE))
-    save_mud_time(&time_info);
+  event_process();
+  prof_lap(prof_events, mark);
 
-  if (!(heart_pulse % (30 * PASSES_PER_SEC))) {
-    timed_dt(NULL);
-   }
+  task_run(heart_pulse);
 
   /* Every pulse! Don't want them to stink the place up... */
+  mark = prof_clock();
   extract_pending_chars();
+  prof_lap(prof_extract, mark);
 }
 
 
@@ -1574,65 +1637,133 @@ char *make_prompt(struct descriptor_data *d)
 }
 
 
+/*
+ * Make room for 'len' bytes at one end of the input arena.  When that end
+ * is used up, the live text (usually a line or two) is slid back towards
+ * the middle.  Returns FALSE if the queue is simply full.
+ */
+static int input_q_room(struct input_q *q, int len, int front)
+{
+  int used = q->hi - q->lo, base, delta, i;
+
+  if (q->count >= INPUT_QUEUE_LINES)
+    return (FALSE);
+  if (front ? q->lo >= len : INPUT_ARENA_SIZE - q->hi >= len)
+    return (TRUE);
+  if (used + len > INPUT_ARENA_SIZE)
+    return (FALSE);
+
+  base = (INPUT_ARENA_SIZE - used - len) / 2 + (front ? len : 0);
+  delta = base - q->lo;
+  memmove(q->arena + base, q->arena + q->lo, used);
+  for (i = 0; i < q->count; i++)
+    q->lines[(q->head + i) & (INPUT_QUEUE_LINES - 1)].off += delta;
+  q->lo += delta;
+  q->hi += delta;
+
+  return (TRUE);
+}
+
+static void input_q_reset(struct input_q *q)
+{
+  q->head = q->count = 0;
+  q->lo = q->hi = INPUT_ARENA_SIZE / 2;
+}
+
+
 /*
  * NOTE: 'txt' must be at most MAX_INPUT_LENGTH big.
+ * Returns FALSE if the queue is full and the line was dropped.
  */
-void write_to_q(const char *txt, struct txt_q *queue, int aliased)
+int write_to_q(const char *txt, struct input_q *queue, int aliased)
 {
-  struct txt_block *newt;
+  struct input_line *line;
+  int len = MIN(strlen(txt), MAX_INPUT_LENGTH - 1);
 
-  CREATE(newt, struct txt_block, 1);
-  newt->text = strdup(txt);
-  newt->aliased = aliased;
+  if (!input_q_room(queue, len, FALSE))
+    return (FALSE);
 
-  /* queue empty? */
-  if (!queue->head) {
-    newt->next = NULL;
-    queue->head = queue->tail = newt;
-  } else {
-    queue->tail->next = newt;
-    queue->tail = newt;
-    newt->next = NULL;
-  }
+  line = &queue->lines[(queue->head + queue->count++) & (INPUT_QUEUE_LINES - 1)];
+  line->off = queue->hi;
+  line->len = len;
+  line->aliased = aliased;
+  memcpy(queue->arena + queue->hi, txt, len);
+  queue->hi += len;
+
+  return (TRUE);
+}
+
+
+/* As write_to_q(), but the line will be the next one read. */
+int write_to_q_front(const char *txt, struct input_q *queue, int aliased)
+{
+  struct input_line *line;
+  int len = MIN(strlen(txt), MAX_INPUT_LENGTH - 1);
+
+  if (!input_q_room(queue, len, TRUE))
+    return (FALSE);
+
+  queue->head = (queue->head - 1) & (INPUT_QUEUE_LINES - 1);
+  queue->count++;
+  queue->lo -= len;
+
+  line = &queue->lines[queue->head];
+  line->off = queue->lo;
+  line->len = len;
+  line->aliased = aliased;
+  memcpy(queue->arena + queue->lo, txt, len);
+
+  return (TRUE);
 }
 
 
 /*
  * NOTE: 'dest' must be at least MAX_INPUT_LENGTH big.
  */
-int get_from_q(struct txt_q *queue, char *dest, int *aliased)
+int get_from_q(struct input_q *queue, char *dest, int *aliased)
 {
-  struct txt_block *tmp;
+  struct input_line *line;
 
   /* queue empty? */
-  if (!queue->head)
+  if (!queue->count)
     return (0);
 
-  strcpy(dest, queue->head->text);	/* strcpy: OK (mutual MAX_INPUT_LENGTH) */
-  *aliased = queue->head->aliased;
+  line = &queue->lines[queue->head];
+  memcpy(dest, queue->arena + line->off, line->len);
+  dest[line->len] = '\0';
+  *aliased = line->aliased;
 
-  tmp = queue->head;
-  queue->head = queue->head->next;
-  free(tmp->text);
-  free(tmp);
+  /* The arena is in queue order, so the oldest line is always at 'lo'. */
+  if (--queue->count == 0)
+    input_q_reset(queue);
+  else {
+    queue->lo += line->len;
+    queue->head = (queue->head + 1) & (INPUT_QUEUE_LINES - 1);
+  }
 
   return (1);
 }
 
 
+/* Throw away any commands the player has typed ahead. */
+static void flush_input_queue(struct descriptor_data *d)
+{
+  input_q_reset(&d->input);
+}
+
+
 /* Empty the queues before closing connection */
 void flush_queues(struct descriptor_data *d)
 {
-  if (d->large_outbuf) {
-    d->large_outbuf->next = bufpool;
-    bufpool = d->large_outbuf;
-  }
-  while (d->input.head) {
-    struct txt_block *tmp = d->input.head;
-    d->input.head = d->input.head->next;
-    free(tmp->text);
-    free(tmp);
+  struct outbuf_seg *seg;
+
+  while ((seg = d->out_head) != NULL) {
+    d->out_head = seg->next;
+    outbuf_put_seg(seg);
   }
+  d->out_tail = NULL;
+  d->out_len = 0;
+  flush_input_queue(d);
 }
 
 
@@ -1815,6 +1946,108 @@ size_t proc_colors(char *txt, size_t maxlen, int parse, char **choices)
 }
 #undef NEW_STRING_LENGTH
 
+/* Grab an empty output segment, from the pool if we can. */
+static struct outbuf_seg *outbuf_get_seg(void)
+{
+  struct outbuf_seg *seg;
+
+  if (outbuf_pool != NULL) {
+    seg = outbuf_pool;
+    outbuf_pool = seg->next;
+  } else {
+    CREATE(seg, struct outbuf_seg, 1);
+    buf_largecount++;
+  }
+  seg->next = NULL;
+  seg->start = seg->end = 0;
+
+  return (seg);
+}
+
+static void outbuf_put_seg(struct outbuf_seg *seg)
+{
+  seg->next = outbuf_pool;
+  outbuf_pool = seg;
+}
+
+
+/*
+ * Append raw bytes to a descriptor's output chain.  The text must already
+ * be color-processed; it is copied exactly once, into the tail segment,
+ * and a fresh segment is chained on whenever the tail fills up.
+ */
+void queue_output(struct descriptor_data *t, const char *txt, size_t len)
+{
+  struct outbuf_seg *seg;
+  size_t chunk;
+
+  while (len > 0) {
+    if ((seg = t->out_tail) == NULL || seg->end == OUTBUF_SEGSIZE) {
+      seg = outbuf_get_seg();
+      if (t->out_tail) {
+        t->out_tail->next = seg;
+        buf_switches++;
+      } else
+        t->out_head = seg;
+      t->out_tail = seg;
+    }
+    chunk = MIN(len, (size_t)(OUTBUF_SEGSIZE - seg->end));
+    memcpy(seg->text + seg->end, txt, chunk);
+    seg->end += chunk;
+    t->out_len += chunk;
+    txt += chunk;
+    len -= chunk;
+  }
+}
+
+
+/* Put back 'len' unsent bytes, no more than a segment, at the front. */
+static void unshift_output(struct descriptor_data *t, const char *txt, size_t len)
+{
+  struct outbuf_seg *seg;
+
+  if ((seg = t->out_head) == NULL || seg->start < (int)len) {
+    seg = outbuf_get_seg();
+    seg->start = seg->end = OUTBUF_SEGSIZE;
+    seg->next = t->out_head;
+    t->out_head = seg;
+    if (!t->out_tail)
+      t->out_tail = seg;
+  }
+  seg->start -= len;
+  memcpy(seg->text + seg->start, txt, len);
+  t->out_len += len;
+}
+
+
+/* Drop 'len' bytes from the front of the output chain. */
+static void consume_output(struct descriptor_data *t, size_t len)
+{
+  struct outbuf_seg *seg;
+  size_t chunk;
+
+  while (len > 0 && (seg = t->out_head) != NULL) {
+    chunk = MIN(len, (size_t)(seg->end - seg->start));
+    seg->start += chunk;
+    t->out_len -= chunk;
+    len -= chunk;
+
+    if (seg->start == seg->end) {
+      /* Keep the last segment around; it is about to be written to again. */
+      if (seg == t->out_tail) {
+        seg->start = seg->end = 0;
+        break;
+      }
+      t->out_head = seg->next;
+      outbuf_put_seg(seg);
+    }
+  }
+
+  if (t->out_len < MAX_OUTBUF_QUEUE / 2)
+    t->out_overflow = FALSE;
+}
+
+
 /* Add a new string to a player's output queue. */
 size_t vwrite_to_output(struct descriptor_data *t, const char *format, va_list args)
 {
@@ -1823,7 +2056,7 @@ size_t vwrite_to_output(struct descriptor_data *t, const char *format, va_list a
   int size;
 
   /* if we're in the overflow state already, ignore this new output */
-  if (t->bufspace == 0)
+  if (t->out_overflow)
     return (0);
 
   wantsize = size = vsnprintf(txt, sizeof(txt), format, args);
@@ -1835,64 +2068,33 @@ size_t vwrite_to_output(struct descriptor_data *t, const char *format, va_list a
     strcpy(txt + size - strlen(text_overflow), text_overflow);  /* strcpy: OK */
   }
 
-  /*
-   * If the text is too big to fit into even a large buffer, truncate
-   * the new text to make it fit.  (This will switch to the overflow
-   * state automatically because t->bufspace will end up 0.)
-   */
-  if (size + t->bufptr + 1 > LARGE_BUFSIZE) {
-    size = LARGE_BUFSIZE - t->bufptr - 1;
-    txt[size] = '\0';
-    GET_OVERFLOW(t->character) = TRUE;
-    buf_overflows++;
-  }
+  queue_output(t, txt, size);
 
   /*
-   * If we have enough space, just write to buffer and that's it! If the
-   * text just barely fits, then it's switched to a large buffer instead.
+   * A client that stops reading can't make us buffer forever.  Messages are
+   * never cut in half; once the queue is over the limit we say so once and
+   * drop whole messages until it has drained by half.
    */
-  if (t->bufspace > size) {
-    strcpy(t->output + t->bufptr, txt); /* strcpy: OK (size checked above) */
-    t->bufspace -= size;
-    t->bufptr += size;
-    return (t->bufspace);
-  }
-
-  buf_switches++;
-
-  /* if the pool has a buffer in it, grab it */
-  if (bufpool != NULL) {
-    t->large_outbuf = bufpool;
-    bufpool = bufpool->next;
-  } else {                      /* else create a new one */
-    CREATE(t->large_outbuf, struct txt_block, 1);
-    CREATE(t->large_outbuf->text, char, LARGE_BUFSIZE);
-    buf_largecount++;
+  if (t->out_len > MAX_OUTBUF_QUEUE) {
+    queue_output(t, text_overflow, strlen(text_overflow));
+    t->out_overflow = TRUE;
+    if (t->character)
+      GET_OVERFLOW(t->character) = TRUE;
+    buf_overflows++;
+    return (0);
   }
 
-  strcpy(t->large_outbuf->text, t->output);     /* strcpy: OK (size checked previously) */
-  t->output = t->large_outbuf->text;    /* make big buffer primary */
-  strcat(t->output, txt);       /* strcat: OK (size checked) */
-
-  /* set the pointer for the next write */
-  t->bufptr = strlen(t->output);
-
-  /* calculate how much space is left in the buffer */
-  t->bufspace = LARGE_BUFSIZE - 1 - t->bufptr;
-
-  return (t->bufspace);
+  return (MAX_OUTBUF_QUEUE - t->out_len);
 }
 
 void free_bufpool(void)
 {
-  struct txt_block *tmp;
+  struct outbuf_seg *tmp;
 
-  while (bufpool) {
-    tmp = bufpool->next;
-    if (bufpool->text)
-      free(bufpool->text);
-    free(bufpool);
-    bufpool = tmp;
+  while (outbuf_pool) {
+    tmp = outbuf_pool->next;
+    free(outbuf_pool);
+    outbuf_pool = tmp;
   }
 }
 
@@ -1957,11 +2159,10 @@ void init_descriptor (struct descriptor_data *newd, int desc)
 
   newd->descriptor = desc;
   newd->idle_tics = 0;
-  newd->output = newd->small_outbuf;
-  newd->bufspace = SMALL_BUFSIZE - 1;
+  newd->out_head = newd->out_tail = NULL;
+  newd->out_len = 0;
+  newd->out_overflow = FALSE;
   newd->login_time = time(0);
-  *newd->output = '\0';
-  newd->bufptr = 0;
   newd->has_prompt = 1;  /* prompt is part of greetings */
   STATE(newd) = CON_GET_USER;
   CREATE(newd->history, char *, HISTORY_SIZE);
@@ -1977,7 +2178,7 @@ void init_descriptor (struct descriptor_data *newd, int desc)
 void set_color(struct descriptor_data *d)
 {
    if (d->character == NULL) {
-      CREATE(d->character, struct char_data, 1);
+      POOL_CREATE(d->character, struct char_data, char_pool);
       clear_char(d->character);
       CREATE(d->character->player_specials, struct player_special_data, 1);
       d->character->desc = d;
@@ -2007,7 +2208,6 @@ int new_descriptor(socklen_t s)
   socklen_t i;
   struct descriptor_data *newd;
   struct sockaddr_in peer;
-  struct hostent *from = NULL;
 
   /* accept the new connection */
   i = sizeof(peer);
@@ -2036,19 +2236,22 @@ int new_descriptor(socklen_t s)
   /* create a new descriptor */
   CREATE(newd, struct descriptor_data, 1);
 
-  /* find the sitename */
-  if (CONFIG_NS_IS_SLOW ||
-      !(from = gethostbyaddr((char *) &peer.sin_addr,
-				      sizeof(peer.sin_addr), AF_INET))) {
+  /*
+   * Start out with the numeric address.  Unless the nameserver is slow,
+   * use a name we already know or go find one; check_resolved_hosts()
+   * fills it in later.
+   */
+  strncpy(newd->host, (char *)inet_ntoa(peer.sin_addr), HOST_LENGTH);	/* strncpy: OK (n->host:HOST_LENGTH+1) */
+  newd->host[HOST_LENGTH] = '\0';
+  newd->addr = peer.sin_addr;
 
-    /* resolution failed */
+  if (!CONFIG_NS_IS_SLOW) {
+    char name[HOST_LENGTH + 1];
 
-    /* find the numeric site address */
-    strncpy(newd->host, (char *)inet_ntoa(peer.sin_addr), HOST_LENGTH);	/* strncpy: OK (n->host:HOST_LENGTH+1) */
-    newd->host[HOST_LENGTH] = '\0';
-  } else {
-    strncpy(newd->host, from->h_name, HOST_LENGTH);	/* strncpy: OK (n->host:HOST_LENGTH+1) */
-    newd->host[HOST_LENGTH] = '\0';
+    if (!resolver_cached(peer.sin_addr, name, sizeof(name)))
+      newd->dns_pending = TRUE;
+    else if (*name)
+      strcpy(newd->host, name);	/* strcpy: OK (name:HOST_LENGTH+1) */
   }
 
   /* determine if the site is banned */
@@ -2062,10 +2265,23 @@ int new_descriptor(socklen_t s)
   /* initialize descriptor data */
   init_descriptor(newd, desc);
 
+  /* register with the reactor so game_loop() hears about it */
+  if (reactor_add(newd) < 0) {
+    write_to_descriptor(desc, "Sorry, CircleMUD is full right now... please try again later!\r\n", NULL);
+    close(desc);
+    free(newd->history);
+    free(newd->comp);
+    free(newd);
+    return (0);
+  }
+
   /* prepend to list */
   newd->next = descriptor_list;
   descriptor_list = newd;
 
+  if (newd->dns_pending)
+    resolver_request(newd->addr);
+
   set_color(newd);
 
   return (0);
@@ -2073,101 +2289,180 @@ int new_descriptor(socklen_t s)
 
 
 /*
- * Send all of the output that we've accumulated for a player out to
- * the player's descriptor.
- *
- * 32 int8_tGARBAGE_SPACE in MAX_SOCK_BUF used for:
- *	 2 bytes: prepended \r\n
- *	14 bytes: overflow message
- *	 2 bytes: extra \r\n for non-comapct
- *      14 bytes: unused
+ * Give connections still known by number the names the resolver found
+ * for them, and check the bans again now that we know who they are.
+ * Only BAN_ALL closes a connection here.  The nanny checks BAN_NEW and
+ * BAN_SELECT against d->host as it goes, so this only has to catch a
+ * character that got past its BAN_SELECT check before the name came in;
+ * until CON_GET_NAME is done, d->character isn't the one they'll play.
  */
-int process_output(struct descriptor_data *t)
+static void check_resolved_hosts(void)
 {
-  char i[MAX_SOCK_BUF], *osb = i + 2;
-  int result;
+  struct descriptor_data *d;
+  struct in_addr addr;
+  char name[HOST_LENGTH + 1];
+  int ban;
 
-  /* we may need this \r\n for later -- see below */
-  strcpy(i, "\r\n");    /* strcpy: OK (for 'MAX_SOCK_BUF >= 3') */
+  while (resolver_next(&addr, name, sizeof(name))) {
+    for (d = descriptor_list; d; d = d->next) {
+      if (!d->dns_pending || d->addr.s_addr != addr.s_addr)
+        continue;
+
+      d->dns_pending = FALSE;
+      if (!*name)
+        continue;
+      strcpy(d->host, name);	/* strcpy: OK (name:HOST_LENGTH+1) */
+
+      if (STATE(d) == CON_CLOSE || (ban = isbanned(d->host)) == BAN_NOT)
+        continue;
+
+      if (ban == BAN_ALL) {
+        write_to_output(d, "You have been banned. Have a nice day.\r\n");
+        mudlog(CMP, ADMLVL_GOD, TRUE, "Connection attempt denied from [%s]", d->host);
+        STATE(d) = CON_CLOSE;
+      } else if (ban == BAN_SELECT && STATE(d) != CON_GET_USER && STATE(d) != CON_GET_NAME &&
+                 d->character && !PLR_FLAGGED(d->character, PLR_SITEOK)) {
+        write_to_output(d, "Sorry, this char has not been cleared for login from your site!\r\n");
+        mudlog(NRM, ADMLVL_GOD, TRUE, "Connection attempt for %s denied from %s", GET_NAME(d->character), d->host);
+        STATE(d) = CON_CLOSE;
+      }
+    }
+  }
+}
 
-  /* now, append the 'real' output */
-  strcpy(osb, t->output);       /* strcpy: OK (t->output:LARGE_BUFSIZE < osb:MAX_SOCK_BUF-2) */
 
-  /* if we're in the overflow state, notify the user */
-  if (t->bufspace == 0)
-    strcat(osb, "**OVERFLOW**\r\n");    /* strcpy: OK (osb:MAX_SOCK_BUF-2 reserves space) */
+/* Copy the next 'len' bytes of t's output onto its snooper's queue. */
+static void snoop_output(struct descriptor_data *t, size_t len)
+{
+  struct outbuf_seg *seg;
+  size_t chunk;
 
-  /* add the extra CRLF if the person isn't in compact mode */
-  if (STATE(t) == CON_PLAYING && t->character && !IS_NPC(t->character) && !PRF_FLAGGED(t->character, PRF_COMPACT)) 
-    strcat(osb, "\r\n");	/* strcpy: OK (osb:MAX_SOCK_BUF-2 reserves space) */
+  for (seg = t->out_head; seg && len > 0; seg = seg->next) {
+    chunk = MIN(len, (size_t)(seg->end - seg->start));
+    queue_output(t->snoop_by, seg->text + seg->start, chunk);
+    len -= chunk;
+  }
+}
 
-  /* add a prompt */
 
-  strcat(i, make_prompt(t));    /* strcpy: OK (i:MAX_SOCK_BUF reserves space) */
-  if (STATE(t) == CON_PLAYING) {
-  proc_colors(i, sizeof(i), COLOR_ON(t->character), COLOR_CHOICES(t->character));
-  }
+/*
+ * Hand a set of iovecs to the kernel.  Without compression this is a
+ * single writev(); MCCP streams compress the lot as one unit, possibly on
+ * a worker, in which case game_loop() sends the result later.  Returns
+ * bytes taken, 0 if the socket is full, -1 on a fatal error.
+ */
+static ssize_t write_iovecs(struct descriptor_data *t, struct iovec *iov, int cnt)
+{
+  ssize_t result;
 
-  /*
-   * now, send the output.  If this is an 'interruption', use the prepended
-   * CRLF, otherwise send the straight output sans CRLF.
-   */
-  if (t->has_prompt) {
-    t->has_prompt = FALSE;
-    result = write_to_descriptor(t->descriptor, i, t->comp);
-    if (result >= 2)
-      result -= 2;
-  } else
-    result = write_to_descriptor(t->descriptor, osb, t->comp);
+  if (t->comp && t->comp->state >= 2)
+    return (mccp_write(t->descriptor, t->comp, iov, cnt, FALSE));
 
-  if (result < 0) {     /* Oops, fatal error. Bye! */
-    close_socket(t);
-    return (-1);
-  } else if (result == 0)       /* Socket buffer full. Try later. */
+  if ((result = writev(t->descriptor, iov, cnt)) >= 0)
+    return (result);
+  if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
     return (0);
+  perror("SYSERR: Write to socket");
+  return (-1);
+}
 
-  /* Handle snooping: prepend "% " and send to snooper. */
-  if (t->snoop_by)
-    write_to_output(t->snoop_by, "\nvvvvvvvvvvvvv[Snoop]vvvvvvvvvvvvv\n%s\n^^^^^^^^^^^^^[Snoop]^^^^^^^^^^^^^\n", t->output);
-  /* The common case: all saved output was handed off to the kernel buffer. */
-  if (result >= t->bufptr ) {
-    /*
-     * if we were using a large buffer, put the large buffer on the buffer pool
-     * and switch back to the small one
-     */
-    if (t->large_outbuf) {
-      t->large_outbuf->next = bufpool;
-      bufpool = t->large_outbuf;
-      t->large_outbuf = NULL;
-      t->output = t->small_outbuf;
+
+/*
+ * Send all of the output that we've accumulated for a player out to
+ * the player's descriptor.
+ *
+ * The output chain goes to writev() one iovec per segment, with the
+ * prepended CRLF, the extra CRLF for non-compact players and the prompt
+ * as iovecs of their own, so nothing is copied or shifted on the way out.
+ * Whatever the kernel didn't take stays queued, and any of the leading
+ * CRLF it didn't take is put back in front of it.  The prompt counts as
+ * sent once it's been written or queued behind the last of the output;
+ * if only part of it made it, the rest is queued as ordinary output.
+ */
+#define OUTPUT_IOVECS	64
+
+int process_output(struct descriptor_data *t)
+{
+  static char prompt[MAX_PROMPT_LENGTH * 4];
+  struct iovec iov[OUTPUT_IOVECS];
+  struct outbuf_seg *seg;
+  size_t lead, body, crlf, plen, used;
+  ssize_t result, total = 0;
+  int cnt, trailer, snooped = FALSE, prompted = FALSE;
+
+  strlcpy(prompt, make_prompt(t), sizeof(prompt));
+  if (STATE(t) == CON_PLAYING)
+    proc_colors(prompt, sizeof(prompt), COLOR_ON(t->character), COLOR_CHOICES(t->character));
+  plen = strlen(prompt);
+
+  do {
+    cnt = 0;
+    lead = body = crlf = 0;
+
+    /* If this is an 'interruption', use the prepended CRLF. */
+    if (t->has_prompt) {
+      t->has_prompt = FALSE;
+      iov[cnt].iov_base = (void *)"\r\n";
+      iov[cnt++].iov_len = lead = 2;
     }
-    /* reset total bufspace back to that of a small buffer */
-    t->bufspace = SMALL_BUFSIZE - 1;
-    t->bufptr = 0;
-    *(t->output) = '\0';
 
-    /*
-     * If the overflow message or prompt were partially written, try to save
-     * them. There will be enough space for them if this is true.  'result'
-     * is effectively unsigned here anyway.
-     */
-    if ((unsigned int)result < strlen(osb)) {
-      size_t savetextlen = strlen(osb + result);
+    for (seg = t->out_head; seg && cnt < OUTPUT_IOVECS - 2; seg = seg->next) {
+      if (seg->end == seg->start)
+        continue;
+      iov[cnt].iov_base = seg->text + seg->start;
+      iov[cnt++].iov_len = seg->end - seg->start;
+      body += seg->end - seg->start;
+    }
 
-      strcat(t->output, osb + result);
-      t->bufptr   -= savetextlen;
-      t->bufspace += savetextlen;
+    /* The prompt goes out once, after the last of the real output. */
+    if ((trailer = (!seg && !prompted))) {
+      if (STATE(t) == CON_PLAYING && t->character && !IS_NPC(t->character) && !PRF_FLAGGED(t->character, PRF_COMPACT)) {
+        iov[cnt].iov_base = (void *)"\r\n";
+        iov[cnt++].iov_len = crlf = 2;
+      }
+      if (plen) {
+        iov[cnt].iov_base = prompt;
+        iov[cnt++].iov_len = plen;
+      }
     }
 
-  } else {
-    /* Not all data in buffer sent.  result < output buffersize. */
+    if (cnt == 0 || (result = write_iovecs(t, iov, cnt)) == 0)
+      break;
+    if (result < 0)
+      return (-1);
+    total += result;
+
+    if (result < (ssize_t)lead)
+      unshift_output(t, "\r\n" + result, lead - result);
+    result -= MIN(result, lead);
+
+    /* Handle snooping: send exactly what the player just got. */
+    used = MIN(result, body);
+    if (used && t->snoop_by) {
+      if (!snooped)
+        write_to_output(t->snoop_by, "\nvvvvvvvvvvvvv[Snoop]vvvvvvvvvvvvv\n");
+      snooped = TRUE;
+      snoop_output(t, used);
+    }
+    consume_output(t, used);
+    result -= used;
+
+    /* Save a partly written prompt; there's always room in the queue. */
+    if (trailer && used == body) {
+      prompted = TRUE;
+      if (result < (ssize_t)(crlf + plen)) {
+        if (result < (ssize_t)crlf)
+          queue_output(t, "\r\n" + result, crlf - result);
+        used = MAX(0, result - (ssize_t)crlf);
+        queue_output(t, prompt + used, plen - used);
+      }
+    }
+  } while (t->out_len > 0 || !prompted);
 
-    strcpy(t->output, t->output + result);      /* strcpy: OK (overlap) */
-    t->bufptr   -= result;
-    t->bufspace += result;
-  }
+  if (snooped)
+    write_to_output(t->snoop_by, "\n^^^^^^^^^^^^^[Snoop]^^^^^^^^^^^^^\n");
 
-  return (result);
+  return (total);
 }
 
 
@@ -2193,75 +2488,14 @@ ssize_t perform_socket_write(socklen_t desc, const char *txt, size_t length, str
 {
   ssize_t result = 0;
 
-  int compr_result, tmp, cnt, bytes_copied;
-  
-  /* MCCP! this is where the zlib compression is handled */
-  if (comp && comp->state >= 2) { /* compress2 on */
-    /* copy data to input buffer */
-    /* first check that overflow won't happen */
-    /* if it will, we only copy over so much text */
-    if (comp->size_in + length > comp->total_in)
-      bytes_copied = comp->total_in - comp->size_in;
-    else
-      bytes_copied = length;
-    
-    /* now copy what will fit into the buffer */
-    strncpy((char *)comp->buff_in + comp->size_in, txt, bytes_copied);
-    comp->size_in += bytes_copied;
+  /* MCCP! compression is handled in mccp.c */
+  if (comp && comp->state >= 2) {
+    struct iovec iov;
 
-    /* set up stream input */
-    comp->stream->avail_in = comp->size_in;
-    comp->stream->next_in = comp->buff_in;
-    
-    /* lets do it */
-    /* deflate all the input - this means flushing our output buffer when it fills */
-    do {
-      /* set up stream output - the size_out bit is somewhat unnecessary, but makes things safer */
-      comp->stream->avail_out = comp->total_out - comp->size_out;
-      comp->stream->next_out = comp->buff_out + comp->size_out;
-      
-      compr_result = deflate(comp->stream, comp->state == 3 ? Z_FINISH : Z_SYNC_FLUSH);
-      
-      if (compr_result == Z_STREAM_END)
-        compr_result = 0;
-      else if (compr_result == Z_OK && !(comp->stream->avail_out))
-        compr_result = 1;
-      else if (compr_result < 0) {  /* uh oh, fatal zlib error */
-	result = 0;
-	break;
-      } else
-	compr_result = 0;
-    
-      /* adjust output state value */
-      comp->size_out = comp->total_out - comp->stream->avail_out;
-
-      /* write out compressed data - flush buff_out */
-      /* if problems encountered, resort to resending all data by breaking and returning < 1.. */
-      tmp = 0;
-      while (comp->size_out > 0) {
-	result = write(desc, comp->buff_out + tmp, comp->size_out);
-	if (result < 1) /* unsuccessful write or socket error */
-	  goto exitzlibdo; /* yummy, goto. faster than two breaks ! */ 
-	comp->size_out -= result;
-	tmp += result;
-      }
-    } while (compr_result);
-exitzlibdo:
-    
-    /* adjust buffers - is this necessary? not with Z_SYNC_FLUSH I think - but just to be safe */
-    /* input loses size_in - avail_in bytes */
-    tmp = comp->size_in - comp->stream->avail_in;
-    for (cnt = tmp; cnt < comp->size_in; cnt++)
-	*(comp->buff_in + (cnt - tmp)) = *(comp->buff_in + cnt);
-
-    /* adjust input state value - it is important that this is done after the previous step */
-    comp->size_in = comp->stream->avail_in;
-    /* the above as taken out because I don't think its necessary.. this is faster too */
-    /*comp->size_in = 0;*/
-
-    if (result > 0)
-	result = bytes_copied;
-  } else 
+    iov.iov_base = (void *)txt;
+    iov.iov_len = length;
+    return (mccp_write(desc, comp, &iov, 1, TRUE));
+  }
 
   result = write(desc, txt, length);
 
@@ -2379,12 +2613,27 @@ ssize_t perform_socket_read(socklen_t desc, char *read_point, size_t space_left)
  * character. (Do you really need 256 characters on a line?)
  * -gg 1/21/2000
  */
+/*
+ * Find the first CR or LF in a block of raw input.  memchr() is vectorised
+ * in any libc worth having, and the CR search stops at the first LF.
+ */
+static char *find_newline(char *txt, size_t len)
+{
+  char *nl, *cr;
+
+  nl = (char *)memchr(txt, '\n', len);
+  if ((cr = (char *)memchr(txt, '\r', nl ? (size_t)(nl - txt) : len)) != NULL)
+    return (cr);
+  return (nl);
+}
+
+
 int process_input(struct descriptor_data *t)
 {
-  int buf_length, failed_subst;
+  int failed_subst;
   ssize_t bytes_read;
   size_t space_left;
-  char *ptr, *read_point, *write_point, *nl_pos = NULL;
+  char *ptr, *read_point, *write_point, *end, *iac, *nl_pos = NULL;
   char tmp[MAX_INPUT_LENGTH];
 
 const char compress_start[] =
@@ -2398,9 +2647,8 @@ const char compress_start[] =
         };
 
   /* first, find the point where we left off reading data */
-  buf_length = strlen(t->inbuf);
-  read_point = t->inbuf + buf_length;
-  space_left = MAX_RAW_INPUT_LENGTH - buf_length - 1;
+  read_point = t->inbuf + t->inbuf_len;
+  space_left = MAX_RAW_INPUT_LENGTH - t->inbuf_len - 1;
 
   do {
     if (space_left <= 0) {
@@ -2412,55 +2660,39 @@ const char compress_start[] =
 
     if (bytes_read < 0)	/* Error, disconnect them. */
       return (-1);
-    else if (bytes_read == 0)	/* Just blocking, no problems. */
+    else if (bytes_read == 0) {	/* Just blocking, no problems. */
+      if (errno != EINTR)	/* drained: wait for the reactor to say more came in */
+        t->ready &= ~REACT_READ;
+      t->inbuf_len = read_point - t->inbuf;	/* keep any partial line for next time */
       return (0);
+    }
 
     /* check for compression response, if still expecting something */
-    /* note: this will bork if the user is giving lots of input when he first connects */
-    /* he shouldn't be doing this, and for the sake of efficiency, the read buffer isn't searched */
-    /* (ie. it assumes that read_point[0] will be IAC, etc.) */
-    if (t->comp->state == 1) {
+    /* the IAC may be anywhere in what we read; only the 3 byte reply is cut out */
+    if (t->comp->state == 1 && (iac = (char *)memchr(read_point, IAC, bytes_read)) != NULL &&
+        iac + 2 < read_point + bytes_read) {
 
-      if (*read_point == (char)IAC && *(read_point + 1) == (char)DO && *(read_point + 2) == (char)COMPRESS2) {
+      if (*(iac + 1) == (char)DO && *(iac + 2) == (char)COMPRESS2) {
 	/* compression just turned on */
 	/* first send plaintext start of the compression stream */
 	write_to_descriptor(t->descriptor, compress_start, NULL);
 	
-	/* init the compression stream */	
-	CREATE(t->comp->stream, z_stream, 1);
-	t->comp->stream->zalloc = z_alloc;
-	t->comp->stream->zfree = z_free;
-	t->comp->stream->opaque = Z_NULL;
-	deflateInit(t->comp->stream, Z_DEFAULT_COMPRESSION);
-        
-	/* init the state structure */
-	/* first the output component */
-	CREATE(t->comp->buff_out, Bytef, SMALL_BUFSIZE);
-	t->comp->total_out = SMALL_BUFSIZE;
-	t->comp->size_out = 0;
-	/* now the input component */
-	CREATE(t->comp->buff_in, Bytef, SMALL_BUFSIZE);
-	t->comp->total_in = SMALL_BUFSIZE;
-	t->comp->size_in = 0;
-
-	/* finally, turn compression on */
-	t->comp->state = 2;
-	
-	bytes_read = 0; /* ignore the compression string - don't process it further */
-      } else if (*read_point == (char)IAC && *(read_point + 1) == (char)DONT && *(read_point + 2) == (char)COMPRESS2) {
+	/* init the compression stream and turn compression on */
+	mccp_start(t->comp);
+      } else if (*(iac + 1) == (char)DONT && *(iac + 2) == (char)COMPRESS2)
 	t->comp->state = 0;
-	
-	bytes_read = 0; /* ignore the compression string - don't process it further */
+
+      /* ignore the compression string - don't process it further */
+      if (t->comp->state != 1) {
+	memmove(iac, iac + 3, read_point + bytes_read - (iac + 3));
+	bytes_read -= 3;
       }
     }
     /* at this point, we know we got some data from the read */
 
-    *(read_point + bytes_read) = '\0';	/* terminate the string */
-
     /* search for a newline in the data we just read */
-    for (ptr = read_point; *ptr && !nl_pos; ptr++)
-      if (ISNEWL(*ptr))
-	nl_pos = ptr;
+    if (!nl_pos)
+      nl_pos = find_newline(read_point, bytes_read);
 
     read_point += bytes_read;
     space_left -= bytes_read;
@@ -2482,6 +2714,7 @@ const char compress_start[] =
    * can copy the formatted data to a new array for further processing.
    */
 
+  end = read_point;
   read_point = t->inbuf;
 
   while (nl_pos != NULL) {
@@ -2556,28 +2789,24 @@ const char compress_start[] =
    if ( (*tmp == '-') && (*(tmp+1) == '-') && !(*(tmp+2)) ) 
    { 
      write_to_output(t, "All queued commands cancelled.\r\n"); 
-     flush_queues(t);  /* Flush the command queue */ 
+     flush_input_queue(t);  /* Flush the command queue */ 
      /* No need to process the -- command any further, so quit back out */ 
    }
-    if (!failed_subst)
-      write_to_q(tmp, &t->input, 0);
+    if (!failed_subst && !write_to_q(tmp, &t->input, 0))
+      write_to_output(t, "Too many commands queued; that one was dropped.\r\n");
 
     /* find the end of this line */
-    while (ISNEWL(*nl_pos))
+    while (nl_pos < end && ISNEWL(*nl_pos))
       nl_pos++;
 
     /* see if there's another newline in the input buffer */
-    read_point = ptr = nl_pos;
-    for (nl_pos = NULL; *ptr && !nl_pos; ptr++)
-      if (ISNEWL(*ptr))
-	nl_pos = ptr;
+    read_point = nl_pos;
+    nl_pos = find_newline(read_point, end - read_point);
   }
 
   /* now move the rest of the buffer up to the beginning for the next pass */
-  write_point = t->inbuf;
-  while (*read_point)
-    *(write_point++) = *(read_point++);
-  *write_point = '\0';
+  t->inbuf_len = end - read_point;
+  memmove(t->inbuf, read_point, t->inbuf_len);
 
   return (1);
 }
@@ -2684,6 +2913,7 @@ void close_socket(struct descriptor_data *d)
   struct descriptor_data *temp;
 
   REMOVE_FROM_LIST(d, descriptor_list, next, temp);
+  reactor_del(d);
     close(d->descriptor);
   flush_queues(d);
 
@@ -2699,6 +2929,7 @@ void close_socket(struct descriptor_data *d)
   if (d->character) {
     /* If we're switched, this resets the mobile taken. */
     d->character->desc = NULL;
+    zone_occupancy_sync(d->character);
 
     /* Plug memory leak, from Eric Green. */
     if (!IS_NPC(d->character) && PLR_FLAGGED(d->character, PLR_MAILING) && d->str) {
@@ -2724,8 +2955,10 @@ void close_socket(struct descriptor_data *d)
     mudlog(CMP, ADMLVL_IMMORT, TRUE, "Losing descriptor without char.");
 
   /* JE 2/22/95 -- part of my unending quest to make switch stable */
-  if (d->original && d->original->desc)
+  if (d->original && d->original->desc) {
     d->original->desc = NULL;
+    zone_occupancy_sync(d->original);
+  }
 
   /* Clear the command history. */
   if (d->history) {
@@ -2767,12 +3000,8 @@ void close_socket(struct descriptor_data *d)
   }
 
   /* free compression structures */
-    if (d->comp->stream) {
-        deflateEnd(d->comp->stream);
-        free(d->comp->stream);
-        free(d->comp->buff_out);
-        free(d->comp->buff_in);
-    }
+  if (d->comp)
+    mccp_end(d->comp);
   /* d->comp was still created even if there is no zlib, for comp->state) */
   if (d->comp)
     free(d->comp);  
@@ -26,7 +26,7 @@
 #include "comm.h"
 #include "dg_scripts.h"
 #include "interpreter.h"
-#include "htree.h"
+#include "vnum_index.h"
 #include "genolc.h"
 #include "shop.h"
 #include "handler.h"
@@ -41,6 +41,8 @@
 #include "imc.h"
 #include "spell_parser.h"
 #include "genobj.h"
+#include "keywords.h"
+#include "pool.h"
 
 /**************************************************************************
 *  declarations of most of the 'global' variables                         *
@@ -50,7 +52,7 @@ struct config_data config_info; /* Game configuration list.    */
 
 struct room_data *world = NULL;	/* array of rooms		 */
 room_rnum top_of_world = 0;	/* ref to top element of world	 */
-struct htree_node *room_htree = NULL;	/* hash tree for fast room lookup */
+struct vnum_index *room_vindex = NULL;	/* vnum index for fast room lookup */
 
 struct char_data *character_list = NULL; /* global linked list of chars	 */
 struct char_data *affect_list = NULL; /* global linked list of chars with affects */
@@ -58,13 +60,13 @@ struct char_data *affectv_list = NULL; /* global linked list of chars with round
 struct index_data *mob_index;	/* index table for mobile file	 */
 struct char_data *mob_proto;	/* prototypes for mobs		 */
 mob_rnum top_of_mobt = 0;	/* top of mobile index table	 */
-struct htree_node *mob_htree = NULL;	/* hash tree for fast mob lookup */
+struct vnum_index *mob_vindex = NULL;	/* vnum index for fast mob lookup */
 
 struct obj_data *object_list = NULL;	/* global linked list of objs	 */
 struct index_data *obj_index;	/* index table for object file	 */
 struct obj_data *obj_proto;	/* prototypes for objs		 */
 obj_rnum top_of_objt = 0;	/* top of object index table	 */
-struct htree_node *obj_htree = NULL;	/* hash tree for fast obj lookup */
+struct vnum_index *obj_vindex = NULL;	/* vnum index for fast obj lookup */
 
 struct zone_data *zone_table;	/* zone table			 */
 zone_rnum top_of_zone_table = 0;/* top element of zone tab	 */
@@ -683,7 +685,8 @@ void destroy_db(void)
   }
   free(world);
   top_of_world = 0;
-  htree_free(room_htree);
+  vnum_index_free(room_vindex);
+  room_vindex = NULL;
 
   /* Objects */
   for (cnt = 0; cnt <= top_of_objt; cnt++) {
@@ -703,7 +706,8 @@ void destroy_db(void)
   }
   free(obj_proto);
   free(obj_index);
-  htree_free(obj_htree);
+  vnum_index_free(obj_vindex);
+  obj_vindex = NULL;
 
   /* Mobiles */
   for (cnt = 0; cnt <= top_of_mobt; cnt++) {
@@ -726,7 +730,8 @@ void destroy_db(void)
   }
   free(mob_proto);
   free(mob_index);
-  htree_free(mob_htree);
+  vnum_index_free(mob_vindex);
+  mob_vindex = NULL;
 
   /* Shops */
   destroy_shops();
@@ -811,8 +816,6 @@ void destroy_db(void)
 
   free_obj_unique_hash();
 
-  htree_shutdown();
-
   log("Freeing Assemblies.");
   free_assemblies();
 }
@@ -877,7 +880,7 @@ void boot_db(void)
 
   boot_world();
 
-  htree_test();
+  vnum_index_test();
 
   log("Loading help entries.");
   index_boot(DB_BOOT_HLP);
@@ -1497,9 +1500,9 @@ static void parse_room(FILE *fl, int virtual_nr)
   world[room_nr].name = fread_string(fl, buf2);
   world[room_nr].description = fread_string(fl, buf2);
 
-  if (! room_htree)
-    room_htree = htree_init();
-  htree_add(room_htree, virtual_nr, room_nr);
+  if (! room_vindex)
+    room_vindex = vnum_index_init();
+  vnum_index_add(room_vindex, virtual_nr, room_nr);
 
   if (!get_line(fl, line)) {
     log("SYSERR: Expecting roomflags/sector type of room #%d but file ended!",
@@ -2176,6 +2179,7 @@ int parse_mobile_from_file(FILE *mob_f, struct char_data *ch)
 
   /***** String data *****/
   ch->name = fread_string(mob_f, buf2);
+  ch->keywords = keywords_for(ch->name);
   tmpptr = ch->short_descr = fread_string(mob_f, buf2);
   if (tmpptr && *tmpptr)
     if (!strcasecmp(fname(tmpptr), "a") || !strcasecmp(fname(tmpptr), "an") ||
@@ -2332,9 +2336,9 @@ static void parse_mobile(FILE *mob_f, int nr)
   mob_proto[i].desc = NULL;
 
   if (parse_mobile_from_file(mob_f, mob_proto + i)) {
-    if (! mob_htree)
-      mob_htree = htree_init();
-    htree_add(mob_htree, nr, i);
+    if (! mob_vindex)
+      mob_vindex = vnum_index_init();
+    vnum_index_add(mob_vindex, nr, i);
 
     top_of_mobt = i++;
   } else { /* We used to exit in the file reading code, but now we do it here */
@@ -2360,9 +2364,9 @@ static char *parse_object(FILE *obj_f, int nr)
   obj_index[i].number = 0;
   obj_index[i].func = NULL;
 
-  if (! obj_htree)
-    obj_htree = htree_init();
-  htree_add(obj_htree, nr, i);
+  if (! obj_vindex)
+    obj_vindex = vnum_index_init();
+  vnum_index_add(obj_vindex, nr, i);
 
   clear_object(obj_proto + i);
   obj_proto[i].item_number = i;
@@ -2374,6 +2378,7 @@ static char *parse_object(FILE *obj_f, int nr)
     log("SYSERR: Null obj name or format error at or near %s", buf2);
     exit(1);
   }
+  obj_proto[i].keywords = keywords_for(obj_proto[i].name);
   tmpptr = obj_proto[i].short_description = fread_string(obj_f, buf2);
   if (tmpptr && *tmpptr)
     if (!strcasecmp(fname(tmpptr), "a") || !strcasecmp(fname(tmpptr), "an") ||
@@ -3006,12 +3011,12 @@ struct char_data *create_char(void)
 {
   struct char_data *ch;
 
-  CREATE(ch, struct char_data, 1);
+  POOL_CREATE(ch, struct char_data, char_pool);
   clear_char(ch);
-  ch->next = character_list;
-  character_list = ch;
-  ch->next_affect = NULL;
-  ch->next_affectv = NULL;
+  LINK_TO_LIST(ch, character_list, next, prev);
+  keyword_file_char(ch);
+  ch->next_affect = ch->prev_affect = NULL;
+  ch->next_affectv = ch->prev_affectv = NULL;
   GET_ID(ch) = max_mob_id++;
   /* find_char helper */
   add_to_lookup_table(GET_ID(ch), (void *)ch);
@@ -3034,13 +3039,13 @@ struct char_data *read_mobile(mob_vnum nr, int type) /* and mob_rnum */
   } else
     i = nr;
 
-  CREATE(mob, struct char_data, 1);
+  POOL_CREATE(mob, struct char_data, char_pool);
   clear_char(mob);
   *mob = mob_proto[i];
-  mob->next = character_list;
-  character_list = mob;
-  mob->next_affect = NULL;
-  mob->next_affectv = NULL;
+  LINK_TO_LIST(mob, character_list, next, prev);
+  keyword_file_char(mob);
+  mob->next_affect = mob->prev_affect = NULL;
+  mob->next_affectv = mob->prev_affectv = NULL;
 
   if (IS_HOSHIJIN(mob) && GET_SEX(mob) == SEX_MALE) {
    mob->hairl = 0;
@@ -3603,6 +3608,7 @@ struct char_data *read_mobile(mob_vnum nr, int type) /* and mob_rnum */
   }
  
   mob_index[i].number++;
+  mob_instance_add(mob);
 
   GET_ID(mob) = max_mob_id++;
   /* find_char helper */
@@ -3789,10 +3795,10 @@ struct obj_data *create_obj(void)
 {
   struct obj_data *obj;
 
-  CREATE(obj, struct obj_data, 1);
+  POOL_CREATE(obj, struct obj_data, obj_pool);
   clear_object(obj);
-  obj->next = object_list;
-  object_list = obj;
+  LINK_TO_LIST(obj, object_list, next, prev);
+  keyword_file_obj(obj);
 
   GET_ID(obj) = max_obj_id++;
   /* find_obj helper */
@@ -3821,14 +3827,15 @@ struct obj_data *read_object(obj_vnum nr, int type) /* and obj_rnum */
     return (NULL);
   }
 
-  CREATE(obj, struct obj_data, 1);
+  POOL_CREATE(obj, struct obj_data, obj_pool);
   clear_object(obj);
   *obj = obj_proto[i];
-  obj->next = object_list;
-  object_list = obj;
+  LINK_TO_LIST(obj, object_list, next, prev);
+  keyword_file_obj(obj);
   OBJ_LOADROOM(obj) = NOWHERE;
 
   obj_index[i].number++;
+  obj_instance_add(obj);
 
   GET_ID(obj) = max_obj_id++;
   /* find_obj helper */
@@ -4189,21 +4196,24 @@ void reset_zone(zone_rnum zone)
     case 'T': /* trigger command */
       if (ZCMD2.arg1==MOB_TRIGGER && tmob) {
         if (!SCRIPT(tmob))
-          CREATE(SCRIPT(tmob), struct script_data, 1);
+          POOL_CREATE(SCRIPT(tmob), struct script_data, script_pool);
         add_trigger(SCRIPT(tmob), read_trigger(ZCMD2.arg2), -1);
+        room_trig_sync(tmob, MOB_TRIGGER);
         last_cmd = 1;
       } else if (ZCMD2.arg1==OBJ_TRIGGER && tobj) {
         if (!SCRIPT(tobj))
-          CREATE(SCRIPT(tobj), struct script_data, 1);
+          POOL_CREATE(SCRIPT(tobj), struct script_data, script_pool);
         add_trigger(SCRIPT(tobj), read_trigger(ZCMD2.arg2), -1);
+        room_trig_sync(tobj, OBJ_TRIGGER);
         last_cmd = 1;
       } else if (ZCMD2.arg1==WLD_TRIGGER) {
         if (ZCMD2.arg3 == NOWHERE || ZCMD2.arg3>top_of_world) {
           ZONE_ERROR("Invalid room number in trigger assignment");
         }
         if (!world[ZCMD2.arg3].script)
-          CREATE(world[ZCMD2.arg3].script, struct script_data, 1);
+          POOL_CREATE(world[ZCMD2.arg3].script, struct script_data, script_pool);
         add_trigger(world[ZCMD2.arg3].script, read_trigger(ZCMD2.arg2), -1);
+        periodic_trig_sync(&world[ZCMD2.arg3], WLD_TRIGGER);
         last_cmd = 1;
       }
 
@@ -4310,7 +4320,92 @@ void reset_zone(zone_rnum zone)
 
 
 /* for use in reset_zone; return TRUE if zone 'nr' is free of PC's  */
-int is_empty(zone_rnum zone_nr)
+/*
+ * Each zone counts the players in the game inside it, and how many of those
+ * are "mortals" -- not immortals with nohassle on.  is_empty() used to scan
+ * the whole descriptor list and is called for every scripted mob and room
+ * on every DG pulse, so it now just reads the count.
+ *
+ * A character remembers which counts it is in.  zone_occupancy_sync()
+ * works out which ones it should be in and moves it; it's called wherever
+ * that can change: moving rooms, attaching or detaching a descriptor
+ * (login, linkdeath, switch/return), admin level and nohassle changes.
+ * Connectedness changes (menus, OLC editors) are caught by
+ * zone_occupancy_sweep() once a pass, before the heartbeat runs.
+ */
+static int zone_counts_char(struct char_data *ch, int *mortal)
+{
+  if (IS_NPC(ch) || IN_ROOM(ch) == NOWHERE || !ch->desc)
+    return (FALSE);
+  if (STATE(ch->desc) != CON_PLAYING)
+    return (FALSE);
+
+  *mortal = !(GET_ADMLEVEL(ch) >= ADMLVL_IMMORT && PRF_FLAGGED(ch, PRF_NOHASSLE));
+  return (TRUE);
+}
+
+
+void zone_occupancy_sync(struct char_data *ch)
+{
+  int counts, mortal = FALSE;
+  zone_rnum zone;
+
+  if (!ch || (!ch->counted && IS_NPC(ch)))
+    return;
+
+  counts = zone_counts_char(ch, &mortal);
+  zone = counts ? world[IN_ROOM(ch)].zone : NOWHERE;
+
+  if (ch->counted == counts && ch->counted_zone == zone && ch->counted_mortal == mortal)
+    return;
+
+  if (ch->counted) {
+    zone_table[ch->counted_zone].players--;
+    if (ch->counted_mortal)
+      zone_table[ch->counted_zone].mortals--;
+  }
+
+  ch->counted = counts;
+  ch->counted_zone = zone;
+  ch->counted_mortal = (counts && mortal);
+
+  if (ch->counted) {
+    zone_table[zone].players++;
+    if (ch->counted_mortal)
+      zone_table[zone].mortals++;
+  }
+}
+
+
+void zone_occupancy_sweep(void)
+{
+  struct descriptor_data *d;
+
+  for (d = descriptor_list; d; d = d->next)
+    zone_occupancy_sync(d->character);
+}
+
+
+/* Count everyone again from scratch, after zone rnums have moved. */
+void zone_occupancy_rebuild(void)
+{
+  struct char_data *ch;
+  zone_rnum zone;
+
+  for (zone = 0; zone <= top_of_zone_table; zone++)
+    zone_table[zone].players = zone_table[zone].mortals = 0;
+
+  for (ch = character_list; ch; ch = ch->next) {
+    ch->counted = ch->counted_mortal = FALSE;
+    ch->counted_zone = NOWHERE;
+    zone_occupancy_sync(ch);
+  }
+}
+
+
+#ifdef CHECK_ZONE_OCCUPANCY
+/* The old way: look for a mortal player in the zone. */
+static int is_empty_scan(zone_rnum zone_nr)
 {
   struct descriptor_data *i;
 
@@ -4321,13 +4416,8 @@ int is_empty(zone_rnum zone_nr)
       continue;
     if (world[IN_ROOM(i->character)].zone != zone_nr)
       continue;
-    /*
-     * if an immortal has nohassle off, he counts as present 
-     * added for testing zone reset triggers - Welcor 
-     */
     if (IS_NPC(i->character))
       continue; /* immortal switched into a mob */
-
     if ((GET_ADMLEVEL(i->character) >= ADMLVL_IMMORT) && (PRF_FLAGGED(i->character, PRF_NOHASSLE)))
       continue;
 
@@ -4336,6 +4426,24 @@ int is_empty(zone_rnum zone_nr)
 
   return (1);
 }
+#endif
+
+
+int is_empty(zone_rnum zone_nr)
+{
+#ifdef CHECK_ZONE_OCCUPANCY
+  int scan = is_empty_scan(zone_nr);
+
+  if (scan != !zone_table[zone_nr].mortals) {
+    log("SYSERR: Zone %d has %d mortal%s counted but the scan says it's %sempty.",
+        zone_table[zone_nr].number, zone_table[zone_nr].mortals,
+        zone_table[zone_nr].mortals == 1 ? "" : "s", scan ? "" : "not ");
+    return (scan);
+  }
+#endif
+
+  return (!zone_table[zone_nr].mortals);
+}
 
 
 /************************************************************************
@@ -4477,6 +4585,9 @@ void free_char(struct char_data *ch)
   if (SCRIPT(ch))
     extract_script(ch, MOB_TRIGGER);
 
+  /* intro and sense memory are only ever cached per instance */
+  free_recog_memory(ch);
+
   /* new version of free_followers take the followers pointer as arg */
   free_followers(ch->followers);
 
@@ -4507,7 +4618,10 @@ void free_char(struct char_data *ch)
   if (GET_ID(ch) != 0)
     remove_from_lookup_table(GET_ID(ch));
 
-  free(ch);
+  /* its keyword split is only counted while it's filed */
+  keyword_unfile_char(ch);
+
+  POOL_FREE(ch, char_pool);
 }
 
 
@@ -4517,6 +4631,7 @@ void free_char(struct char_data *ch)
 void free_obj(struct obj_data *obj)
 {
   remove_unique_id(obj);
+  keyword_unfile_obj(obj);
   if (GET_OBJ_RNUM(obj) == NOWHERE) {
     free_object_strings(obj);
     /* free script proto list */
@@ -4543,7 +4658,7 @@ void free_obj(struct obj_data *obj)
   if (obj->sbinfo)
     free(obj->sbinfo);
 
-  free(obj);
+  POOL_FREE(obj, obj_pool);
 }
 
 
@@ -4743,7 +4858,7 @@ void init_char(struct char_data *ch)
   set_height_and_weight_by_race(ch);
 
   if ((i = get_ptable_by_name(GET_NAME(ch))) != -1)
-    player_table[i].id = GET_IDNUM(ch) = ++top_idnum;
+    set_ptable_id(i, GET_IDNUM(ch) = ++top_idnum);
   else
     log("SYSERR: init_char: Character '%s' not found in player table.", GET_NAME(ch));
 
@@ -4774,9 +4889,9 @@ room_rnum real_room(room_vnum vnum)
 {
   room_rnum bot, top, mid, i, last_top;
 
-  i = htree_find(room_htree, vnum);
+  i = vnum_index_find(room_vindex, vnum);
 
-  if (i != NOWHERE && world[i].number == vnum)
+  if (i != NOWHERE && i <= top_of_world && world[i].number == vnum)
     return i;
   else {
     bot = 0;
@@ -4788,8 +4903,8 @@ room_rnum real_room(room_vnum vnum)
       mid = (bot + top) / 2;
 
       if ((world + mid)->number == vnum) {
-        log("room_htree sync fix: %d: %d -> %d", vnum, i, mid);
-        htree_add(room_htree, vnum, mid);
+        if (vnum_index_add(room_vindex, vnum, mid))
+          log("room_vindex sync fix: %d: %d -> %d", vnum, i, mid);
         return (mid);
       }
       if (bot >= top)
@@ -4812,9 +4927,9 @@ mob_rnum real_mobile(mob_vnum vnum)
 {
   mob_rnum bot, top, mid, i, last_top;
 
-  i = htree_find(mob_htree, vnum);
+  i = vnum_index_find(mob_vindex, vnum);
 
-  if (i != NOBODY && mob_index[i].vnum == vnum)
+  if (i != NOBODY && i <= top_of_mobt && mob_index[i].vnum == vnum)
     return i;
   else {
     bot = 0;
@@ -4826,8 +4941,8 @@ mob_rnum real_mobile(mob_vnum vnum)
       mid = (bot + top) / 2;
 
       if ((mob_index + mid)->vnum == vnum) {
-        log("mob_htree sync fix: %d: %d -> %d", vnum, i, mid);
-        htree_add(mob_htree, vnum, mid);
+        if (vnum_index_add(mob_vindex, vnum, mid))
+          log("mob_vindex sync fix: %d: %d -> %d", vnum, i, mid);
         return (mid);
       }
       if (bot >= top)
@@ -4849,9 +4964,9 @@ obj_rnum real_object(obj_vnum vnum)
 {
   obj_rnum bot, top, mid, i, last_top;
 
-  i = htree_find(obj_htree, vnum);
+  i = vnum_index_find(obj_vindex, vnum);
 
-  if (i != NOWHERE && obj_index[i].vnum == vnum)
+  if (i != NOWHERE && i <= top_of_objt && obj_index[i].vnum == vnum)
     return i;
   else {
     bot = 0;
@@ -4863,8 +4978,8 @@ obj_rnum real_object(obj_vnum vnum)
       mid = (bot + top) / 2;
 
       if ((obj_index + mid)->vnum == vnum) {
-        log("obj_htree sync fix: %d: %d -> %d", vnum, i, mid);
-        htree_add(obj_htree, vnum, mid);
+        if (vnum_index_add(obj_vindex, vnum, mid))
+          log("obj_vindex sync fix: %d: %d -> %d", vnum, i, mid);
         return (mid);
       }
       if (bot >= top)
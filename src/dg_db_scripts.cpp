@@ -21,6 +21,7 @@
 #include "dg_event.h"
 #include "comm.h"
 #include "constants.h"
+#include "pool.h"
 
 extern void half_chop(char *string, char *arg1, char *arg2);
 extern bitvector_t asciiflag_conv(char *flag);
@@ -36,7 +37,7 @@ void parse_trigger(FILE *trig_f, int nr)
     struct index_data *t_index;
     struct trig_data *trig;
 
-    CREATE(trig, trig_data, 1);
+    POOL_CREATE(trig, struct trig_data, trig_pool);
     CREATE(t_index, index_data, 1);
 
     t_index->vnum = nr;
@@ -72,6 +73,7 @@ void parse_trigger(FILE *trig_f, int nr)
     free(cmds);
 
     trig_index[top_of_trigt++] = t_index;
+    compile_cmdlist(trig);
 }
 
 
@@ -88,7 +90,7 @@ trig_data *read_trigger(int nr)
     if ((t_index = trig_index[nr]) == NULL)
 	return NULL;
 
-    CREATE(trig, trig_data, 1);
+    POOL_CREATE(trig, struct trig_data, trig_pool);
     trig_data_copy(trig, t_index->proto);
 
     t_index->number++;
@@ -208,8 +210,9 @@ void dg_read_trigger(FILE *fp, void *proto, int type)
 
       if (rnum != NOTHING) {
         if (!(room->script))
-          CREATE(room->script, struct script_data, 1);
+          POOL_CREATE(room->script, struct script_data, script_pool);
         add_trigger(SCRIPT(room), read_trigger(rnum), -1);
+        periodic_trig_sync(room, WLD_TRIGGER);
       } else {
         mudlog(BRF, ADMLVL_BUILDER, TRUE,
                "SYSERR: non-existant trigger #%d assigned to room #%d",
@@ -278,11 +281,12 @@ void assign_triggers(void *i, int type)
                  trg_proto->vnum, mob_index[mob->nr].vnum);
         } else {
           if (!SCRIPT(mob))
-            CREATE(SCRIPT(mob), struct script_data, 1);
+            POOL_CREATE(SCRIPT(mob), struct script_data, script_pool);
           add_trigger(SCRIPT(mob), read_trigger(rnum), -1);
         }
         trg_proto = trg_proto->next;
       }
+      room_trig_sync(mob, MOB_TRIGGER);
       break;
     case OBJ_TRIGGER:
       obj = (obj_data *)i;
@@ -294,11 +298,12 @@ void assign_triggers(void *i, int type)
             trg_proto->vnum, obj_index[obj->item_number].vnum);
         } else {
           if (!SCRIPT(obj))
-            CREATE(SCRIPT(obj), struct script_data, 1);
+            POOL_CREATE(SCRIPT(obj), struct script_data, script_pool);
           add_trigger(SCRIPT(obj), read_trigger(rnum), -1);
         }
         trg_proto = trg_proto->next;
       }
+      room_trig_sync(obj, OBJ_TRIGGER);
       break;
     case WLD_TRIGGER:
       room = (struct room_data *)i;
@@ -311,11 +316,12 @@ void assign_triggers(void *i, int type)
                  trg_proto->vnum, room->number);
         } else {
           if (!SCRIPT(room))
-            CREATE(SCRIPT(room), struct script_data, 1);
+            POOL_CREATE(SCRIPT(room), struct script_data, script_pool);
           add_trigger(SCRIPT(room), read_trigger(rnum), -1);
         }
         trg_proto = trg_proto->next;
       }
+      periodic_trig_sync(room, WLD_TRIGGER);
       break;
     default:
       mudlog(BRF, ADMLVL_BUILDER, TRUE,
@@ -34,6 +34,71 @@
 
 static struct queue *event_q;          /* the event queue */
 
+/*
+ * Events and queue elements come from free lists, topped up
+ * EVENT_POOL_CHUNK at a time, so a script 'wait' doesn't cost two
+ * mallocs and two frees.  A free event is chained through event_obj.
+ */
+static struct event *event_pool = NULL;
+static struct q_element *q_element_pool = NULL;
+
+static struct event *event_alloc(void)
+{
+  struct event *ev;
+  int i;
+
+  if (!event_pool) {
+    CREATE(ev, struct event, EVENT_POOL_CHUNK);
+    for (i = 0; i < EVENT_POOL_CHUNK; i++) {
+      ev[i].event_obj = event_pool;
+      event_pool = &ev[i];
+    }
+  }
+
+  ev = event_pool;
+  event_pool = (struct event *) ev->event_obj;
+  memset(ev, 0, sizeof(*ev));
+  return ev;
+}
+
+
+static void event_release(struct event *ev)
+{
+  ev->event_obj = event_pool;
+  ev->q_el = NULL;
+  event_pool = ev;
+}
+
+
+static struct q_element *q_element_alloc(void)
+{
+  struct q_element *qe;
+  int i;
+
+  if (!q_element_pool) {
+    CREATE(qe, struct q_element, EVENT_POOL_CHUNK);
+    for (i = 0; i < EVENT_POOL_CHUNK; i++) {
+      qe[i].next = q_element_pool;
+      q_element_pool = &qe[i];
+    }
+  }
+
+  qe = q_element_pool;
+  q_element_pool = qe->next;
+  memset(qe, 0, sizeof(*qe));
+  return qe;
+}
+
+
+static void q_element_release(struct q_element *qe)
+{
+  qe->data = NULL;
+  qe->head = NULL;
+  qe->next = q_element_pool;
+  q_element_pool = qe;
+}
+
+
 /* initializes the event queue */
 void event_init(void)
 {
@@ -52,7 +117,7 @@ struct event *event_create(EVENTFUNC(*func), void *event_obj, long when)
   if (when < 1) /* make sure its in the future */
     when = 1;
 
-  CREATE(new_event, struct event, 1);
+  new_event = event_alloc();
   new_event->func = func;
   new_event->event_obj = event_obj;
   new_event->q_el = queue_enq(event_q, new_event, when + pulse);
@@ -76,7 +141,7 @@ void event_cancel(struct event *event)
 
   if (event->event_obj)
     free(event->event_obj);
-  free(event);
+  event_release(event);
 }
 
 
@@ -103,7 +168,7 @@ void event_process(void)
     if ((new_time = (the_event->func)(the_event->event_obj)) > 0)
       the_event->q_el = queue_enq(event_q, the_event, new_time + pulse);
     else
-      free(the_event);
+      event_release(the_event);
   }
 }
 
@@ -141,12 +206,89 @@ int event_is_queued(struct event *event)
 *                                                                         *
 ************************************************************************ */
 
+/*
+ * The queue is a hierarchical timing wheel rather than sorted lists, so
+ * adding and removing an element is O(1) however many are waiting.
+ * Level 0 has a slot for each of the next EVENT_WHEEL_SIZE pulses; each
+ * higher level has slots EVENT_WHEEL_SIZE times wider, and as the wheel
+ * turns onto a new stretch of a level its slot is spilled down into the
+ * levels below.  An element further out than the top level reaches
+ * waits in the top level's furthest slot and is sorted again from there.
+ * Level 0's slot for the current pulse holds exactly what is due now.
+ */
+
+/* Put qe in the slot for its key, as seen from q->now. */
+static void queue_slot(struct queue *q, struct q_element *qe)
+{
+  struct q_element **head;
+  long key = MAX(qe->key, q->now), delta = key - q->now;
+  int lvl, shift;
+
+  for (lvl = 0; lvl < EVENT_WHEEL_LEVELS; lvl++)
+    if (delta < 1L << (EVENT_WHEEL_BITS * (lvl + 1)))
+      break;
+
+  if (lvl < EVENT_WHEEL_LEVELS) {
+    shift = EVENT_WHEEL_BITS * lvl;
+    head = &q->slot[lvl][(key >> shift) & EVENT_WHEEL_MASK];
+  } else {
+    lvl = EVENT_WHEEL_LEVELS - 1;
+    shift = EVENT_WHEEL_BITS * lvl;
+    head = &q->slot[lvl][((q->now >> shift) + EVENT_WHEEL_MASK) & EVENT_WHEEL_MASK];
+  }
+
+  qe->head = head;
+  qe->prev = NULL;
+  qe->next = *head;
+  if (*head)
+    (*head)->prev = qe;
+  *head = qe;
+}
+
+
+/* Turn the wheel forward to the current pulse. */
+static void queue_advance(struct queue *q)
+{
+  struct q_element *qe, *next_qe, **cur;
+  int lvl, shift;
+
+  while (q->now < (long) pulse) {
+    /* Anything still in this pulse's slot is overdue; carry it along. */
+    cur = &q->slot[0][q->now & EVENT_WHEEL_MASK];
+    qe = *cur;
+    *cur = NULL;
+
+    q->now++;
+
+    for (; qe; qe = next_qe) {
+      next_qe = qe->next;
+      queue_slot(q, qe);
+    }
+
+    /* Spill each level whose next stretch starts now, top down. */
+    for (lvl = EVENT_WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+      shift = EVENT_WHEEL_BITS * lvl;
+      if (q->now & ((1L << shift) - 1))
+        continue;
+      cur = &q->slot[lvl][(q->now >> shift) & EVENT_WHEEL_MASK];
+      qe = *cur;
+      *cur = NULL;
+      for (; qe; qe = next_qe) {
+        next_qe = qe->next;
+        queue_slot(q, qe);
+      }
+    }
+  }
+}
+
+
 /* returns a new, initialized queue */
 struct queue *queue_init(void)
 {
   struct queue *q;
 
   CREATE(q, struct queue, 1);
+  q->now = pulse;
 
   return q;
 }
@@ -155,43 +297,14 @@ struct queue *queue_init(void)
 /* add data into the priority queue q with key */
 struct q_element *queue_enq(struct queue *q, void *data, long key)
 {
-  struct q_element *qe, *i;
-  int bucket;
+  struct q_element *qe;
 
-  CREATE(qe, struct q_element, 1);
+  queue_advance(q);
+
+  qe = q_element_alloc();
   qe->data = data;
   qe->key = key;
-
-  bucket = key % NUM_EVENT_QUEUES;   /* which queue does this go in */
-
-  if (!q->head[bucket]) { /* queue is empty */
-    q->head[bucket] = qe;
-    q->tail[bucket] = qe;
-  }
-
-  else {
-    for (i = q->tail[bucket]; i; i = i->prev) {
-
-      if (i->key < key) { /* found insertion point */
-	if (i == q->tail[bucket])
-	  q->tail[bucket] = qe;
-	else {
-	  qe->next = i->next;
-	  i->next->prev = qe;
-	}
-
-	qe->prev = i;
-	i->next = qe;
-	break;
-      }
-    }
-
-    if (i == NULL) { /* insertion point is front of list */
-      qe->next = q->head[bucket];
-      q->head[bucket] = qe;
-      qe->next->prev = qe;
-    }
-  }
+  queue_slot(q, qe);
 
   return qe;
 }
@@ -200,23 +313,17 @@ struct q_element *queue_enq(struct queue *q, void *data, long key)
 /* remove queue element qe from the priority queue q */
 void queue_deq(struct queue *q, struct q_element *qe)
 {
-  int i;
-
   assert(qe);
 
-  i = qe->key % NUM_EVENT_QUEUES;
-
   if (qe->prev == NULL)
-    q->head[i] = qe->next;
+    *qe->head = qe->next;
   else
     qe->prev->next = qe->next;
 
-  if (qe->next == NULL)
-    q->tail[i] = qe->prev;
-  else
+  if (qe->next)
     qe->next->prev = qe->prev;
 
-  free(qe);
+  q_element_release(qe);
 }
 
 
@@ -226,16 +333,16 @@ void queue_deq(struct queue *q, struct q_element *qe)
  */
 void *queue_head(struct queue *q)
 {
+  struct q_element *qe;
   void *dg_data;
-  int i;
 
-  i = pulse % NUM_EVENT_QUEUES;
+  queue_advance(q);
 
-  if (!q->head[i])
+  if (!(qe = q->slot[0][q->now & EVENT_WHEEL_MASK]))
     return NULL;
 
-  dg_data = q->head[i]->data;
-  queue_deq(q, q->head[i]);
+  dg_data = qe->data;
+  queue_deq(q, qe);
   return dg_data;
 }
 
@@ -246,12 +353,12 @@ void *queue_head(struct queue *q)
  */
 long queue_key(struct queue *q)
 {
-  int i;
+  struct q_element *qe;
 
-  i = pulse % NUM_EVENT_QUEUES;
+  queue_advance(q);
 
-  if (q->head[i])
-    return q->head[i]->key;
+  if ((qe = q->slot[0][q->now & EVENT_WHEEL_MASK]))
+    return qe->key;
   else
     return LONG_MAX;
 }
@@ -267,21 +374,21 @@ long queue_elmt_key(struct q_element *qe)
 /* free q and contents */
 void queue_free(struct queue *q)
 {
-  int i;
+  int lvl, i;
   struct q_element *qe, *next_qe;
   struct event *event;
 
-  for (i = 0; i < NUM_EVENT_QUEUES; i++)
-    for (qe = q->head[i]; qe; qe = next_qe) {
-      next_qe = qe->next;
-      if ((event = (struct event *) qe->data) != NULL) {
-       if (event->event_obj)
-         free(event->event_obj);
-       free(event);
+  for (lvl = 0; lvl < EVENT_WHEEL_LEVELS; lvl++)
+    for (i = 0; i < EVENT_WHEEL_SIZE; i++)
+      for (qe = q->slot[lvl][i]; qe; qe = next_qe) {
+        next_qe = qe->next;
+        if ((event = (struct event *) qe->data) != NULL) {
+         if (event->event_obj)
+           free(event->event_obj);
+         event_release(event);
+        }
+        q_element_release(qe);
       }
-      free(qe);
-    }
 
   free(q);
 }
-
@@ -19,6 +19,7 @@
 #include "db.h"
 #include "handler.h"
 #include "dg_event.h"
+#include "pool.h"
 
 
 /* frees memory associated with var */
@@ -36,6 +37,7 @@ void free_varlist(struct trig_var_data *vd)
 {
     struct trig_var_data *i, *j;
 
+    free_var_index(vd);
     for (i = vd; i;) {
 	j = i;
 	i = i->next;
@@ -49,20 +51,10 @@ void free_varlist(struct trig_var_data *vd)
  */
 int remove_var(struct trig_var_data **var_list, char *name)
 {
-  struct trig_var_data *i, *j;
-
-  for (j = NULL, i = *var_list; i && strcasecmp(name, i->name);
-       j = i, i = i->next);
-
-  if (i) {
-    if (j) {
-      j->next = i->next;
-      free_var_el(i);
-    } else {
-      *var_list = i->next;
-      free_var_el(i);
-    }
+  struct trig_var_data *i;
 
+  if ((i = find_var(*var_list, name))) {
+    delete_var(var_list, i);
     return 1;
   }
 
@@ -90,7 +82,7 @@ void free_trigger(struct trig_data *trig)
     if (GET_TRIG_WAIT(trig))
       event_cancel(GET_TRIG_WAIT(trig));
 
-    free(trig);
+    POOL_FREE(trig, trig_pool);
 }
 
 
@@ -139,6 +131,11 @@ void extract_script(void *thing, int type)
       break;
   }
 
+  if (type != WLD_TRIGGER)
+    room_trig_sync(thing, type);
+  else
+    periodic_trig_sync(thing, type);
+
 #if 1 /* debugging */
   {
     struct char_data *i = character_list;
@@ -165,7 +162,7 @@ void extract_script(void *thing, int type)
   /* Thanks to James Long for tracking down this memory leak */
   free_varlist(sc->global_vars);
 
-  free(sc);
+  POOL_FREE(sc, script_pool);
 }
 
 /* erase the script memory of a mob */
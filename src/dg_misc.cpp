@@ -135,8 +135,7 @@ void do_dg_cast(void *go, struct script_data *sc, trig_data *trig,
         strdup(((struct obj_data *)go)->short_description);
     else if (type==WLD_TRIGGER)
       caster->short_descr = strdup("The gods");
-    caster->next_in_room = caster_room->people;
-    caster_room->people = caster;
+    LINK_TO_LIST(caster, caster_room->people, next_in_room, prev_in_room);
     IN_ROOM(caster) = real_room(caster_room->number);
     call_magic(caster, tch, tobj, spellnum, DG_SPELL_LEVEL, CAST_SPELL, t);
     extract_char(caster);
@@ -45,6 +45,7 @@
 #include "constants.h"
 #include "act.wizard.h"
 #include "fight.h"
+#include "keywords.h"
 
 /*
  * Local functions.
@@ -282,7 +283,7 @@ ACMD(do_mjunk)
     } else {
         for (obj = ch->carrying; obj != NULL; obj = obj_next) {
             obj_next = obj->next_content;
-            if (arg[3] == '\0' || isname(arg+4, obj->name)) {
+            if (arg[3] == '\0' || isname_obj(arg+4, obj)) {
                 extract_obj(obj);
             }
         }
@@ -1025,9 +1026,23 @@ ACMD(do_mtransform)
     tmpmob.proto_script = ch->proto_script;
     tmpmob.script = ch->script;
     tmpmob.memory = ch->memory;
+    tmpmob.recog = ch->recog;
+    tmpmob.trig_types = ch->trig_types;
+    tmpmob.trig_room = ch->trig_room;
+    tmpmob.keywords = ch->keywords;
+    tmpmob.list_seq = ch->list_seq;
     tmpmob.next_in_room = ch->next_in_room;
+    tmpmob.prev_in_room = ch->prev_in_room;
     tmpmob.next = ch->next;
+    tmpmob.prev = ch->prev;
+    tmpmob.next_instance = ch->next_instance;
+    tmpmob.prev_instance = ch->prev_instance;
     tmpmob.next_fighting = ch->next_fighting;
+    tmpmob.next_affect = ch->next_affect;
+    tmpmob.prev_affect = ch->prev_affect;
+    tmpmob.next_affectv = ch->next_affectv;
+    tmpmob.prev_affectv = ch->prev_affectv;
+    tmpmob.next_extract = ch->next_extract;
     tmpmob.followers = ch->followers;
     tmpmob.master = ch->master;
 
@@ -1038,6 +1053,7 @@ ACMD(do_mtransform)
     IS_CARRYING_N(&tmpmob) = IS_CARRYING_N(ch);
     FIGHTING(&tmpmob) = FIGHTING(ch);
     memcpy(ch, &tmpmob, sizeof(*ch));
+    char_keywords_refresh(ch);
 
     for (pos = 0; pos < NUM_WEARS; pos++) {
       if (obj[pos])
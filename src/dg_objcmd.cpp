@@ -19,6 +19,7 @@
 #include "db.h"
 #include "constants.h"
 #include "act.wizard.h"
+#include "keywords.h"
 
 /*
  * Local functions
@@ -339,9 +340,19 @@ OCMD(do_otransform)
     tmpobj.id = obj->id;
     tmpobj.proto_script = obj->proto_script;
     tmpobj.script = obj->script;
+    tmpobj.trig_types = obj->trig_types;
+    tmpobj.trig_room = obj->trig_room;
+    tmpobj.keywords = obj->keywords;
+    tmpobj.list_seq = obj->list_seq;
     tmpobj.next_content = obj->next_content;
+    tmpobj.prev_content = obj->prev_content;
     tmpobj.next = obj->next;
+    tmpobj.prev = obj->prev;
+    memcpy(tmpobj.active_pos, obj->active_pos, sizeof(obj->active_pos));
+    obj_instance_remove(obj);
     memcpy(obj, &tmpobj, sizeof(*obj));
+    obj_instance_add(obj);
+    obj_keywords_refresh(obj);
 
     if (wearer) {
       equip_char(wearer, obj, pos);
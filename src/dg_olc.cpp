@@ -23,6 +23,7 @@
 #include "constants.h"
 #include "act.wizard.h"
 #include "modify.h"
+#include "pool.h"
 
 /* local functions */
 static void trigedit_disp_menu(struct descriptor_data *d);
@@ -147,7 +148,7 @@ void trigedit_setup_new(struct descriptor_data *d)
   /*
    * Allocate a scratch trigger structure
    */
-  CREATE(trig, struct trig_data, 1);
+  POOL_CREATE(trig, struct trig_data, trig_pool);
 
   trig->nr = NOWHERE;
 
@@ -174,7 +175,7 @@ void trigedit_setup_existing(struct descriptor_data *d, int rtrg_num)
   /*
    * Allocate a scratch trigger structure
    */
-  CREATE(trig, struct trig_data, 1);
+  POOL_CREATE(trig, struct trig_data, trig_pool);
 
   trig_data_copy(trig, trig_index[rtrg_num]->proto);
 
@@ -539,7 +540,7 @@ void trigedit_save(struct descriptor_data *d)
           new_index[rnum]->vnum = OLC_NUM(d);
           new_index[rnum]->number = 0;
           new_index[rnum]->func = NULL;
-          CREATE(proto, struct trig_data, 1);
+          POOL_CREATE(proto, struct trig_data, trig_pool);
           new_index[rnum]->proto = proto;
           trig_data_copy(proto, trig);
 
@@ -565,7 +566,7 @@ void trigedit_save(struct descriptor_data *d)
       new_index[rnum]->number = 0;
       new_index[rnum]->func = NULL;
 
-      CREATE(proto, struct trig_data, 1);
+      POOL_CREATE(proto, struct trig_data, trig_pool);
       new_index[rnum]->proto = proto;
       trig_data_copy(proto, trig);
     }
@@ -589,6 +590,9 @@ void trigedit_save(struct descriptor_data *d)
 
   }
 
+  /* The live triggers share the prototype's new command list. */
+  compile_cmdlist(trig);
+
   /* now write the trigger out to disk, along with the rest of the  */
   /* triggers for this zone, of course                              */
   /* note: we write this to disk NOW instead of letting the builder */
@@ -0,0 +1,226 @@
+/* ************************************************************************
+*   File: dg_profile.c                                  Part of CircleMUD *
+*  Usage: Per-trigger execution counts and times, for 'tprofile'          *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+/*
+ * With 'tprofile on', script_driver() times every run of a trigger and
+ * counts the lines it executed, the waits it scheduled and the %var%
+ * substitutions it made, and trig_prof_done() adds them up by trigger
+ * vnum (rnums move when trigedit adds a trigger).  A run resumed after a
+ * wait is a run of its own.  Time is the trigger's own: time spent in
+ * the triggers it sets off is charged to them instead.
+ *
+ * When it's off, script_driver() tests trig_prof_on and nothing more, and
+ * trig_prof_cur stays NULL so the counters in the script code are skipped.
+ *
+ * 'tprofile' lists the costliest triggers since profiling was turned on or
+ * last reset, and 'tprofile csv' writes all of them to a file in
+ * lib/misc for looking at elsewhere.
+ */
+
+#include "structs.h"
+#include "dg_scripts.h"
+#include "utils.h"
+#include "interpreter.h"
+#include "comm.h"
+#include "db.h"
+
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+#define TPROF_TOP	10	/* triggers to list if not told	*/
+#define TPROF_TOP_MAX	100	/* ... and the most we'll list	*/
+
+struct trig_prof {
+  unsigned long calls;
+  unsigned long lines;
+  unsigned long waits;
+  unsigned long substs;
+  unsigned long runaways;		/* runs stopped by the loop limit */
+  unsigned long long nsec;		/* summed over the calls	*/
+  unsigned long long max_nsec;		/* ... and the longest one	*/
+};
+
+bool trig_prof_on = FALSE;
+struct trig_prof_run *trig_prof_cur = NULL;
+
+static std::unordered_map<trig_vnum, struct trig_prof> trig_profs;
+static time_t trig_prof_since;		/* start of the window		*/
+
+ACMD(do_tprofile);
+
+
+/* File a finished run.  trig_prof_cur is back to whatever set it off. */
+void trig_prof_done(struct trig_prof_run *run, unsigned long long nsec)
+{
+  struct trig_prof *tp;
+
+  if (trig_prof_cur)
+    trig_prof_cur->child_nsec += nsec;
+
+  nsec = (run->child_nsec < nsec) ? nsec - run->child_nsec : 0;
+
+  tp = &trig_profs[run->vnum];
+  tp->calls++;
+  tp->lines += run->lines;
+  tp->waits += run->waits;
+  tp->substs += run->substs;
+  if (run->runaway)
+    tp->runaways++;
+  tp->nsec += nsec;
+  if (nsec > tp->max_nsec)
+    tp->max_nsec = nsec;
+}
+
+
+static void trig_prof_reset(void)
+{
+  trig_profs.clear();
+  trig_prof_since = time(0);
+}
+
+
+static const char *trig_prof_name(trig_vnum vnum)
+{
+  trig_rnum rnum = real_trigger(vnum);
+
+  if (rnum == NOTHING || !trig_index[rnum]->proto || !trig_index[rnum]->proto->name)
+    return ("<gone>");
+  return (trig_index[rnum]->proto->name);
+}
+
+
+typedef std::pair<trig_vnum, const struct trig_prof *> trig_prof_entry;
+
+static bool trig_prof_by_total(const trig_prof_entry &a, const trig_prof_entry &b)
+{
+  if (a.second->nsec != b.second->nsec)
+    return (a.second->nsec > b.second->nsec);
+  return (a.first < b.first);
+}
+
+static bool trig_prof_by_call(const trig_prof_entry &a, const trig_prof_entry &b)
+{
+  double ca = (double) a.second->nsec / a.second->calls;
+  double cb = (double) b.second->nsec / b.second->calls;
+
+  if (ca != cb)
+    return (ca > cb);
+  return (a.first < b.first);
+}
+
+
+static void trig_prof_list(struct char_data *ch, std::vector<trig_prof_entry> &all, int top,
+                           bool (*cmp)(const trig_prof_entry &, const trig_prof_entry &), const char *title)
+{
+  const struct trig_prof *tp;
+  size_t i, n = MIN((size_t) top, all.size());
+
+  std::partial_sort(all.begin(), all.begin() + n, all.end(), cmp);
+
+  send_to_char(ch, "\r\nTop %d by %s:\r\n"
+                   " Vnum   Name                      Calls  Lines/c  Waits  Subst  Runaway   Total ms  Per call us    Max us\r\n"
+                   "------- ------------------------ -------- ------- ------ ------- ------- ---------- ----------- ---------\r\n",
+               (int) n, title);
+  for (i = 0; i < n; i++) {
+    tp = all[i].second;
+    send_to_char(ch, "%7lld %-24.24s %8lu %7.1f %6lu %7lu %7lu %10.2f %11.1f %9.1f\r\n",
+                 (long long) all[i].first, trig_prof_name(all[i].first), tp->calls,
+                 (double) tp->lines / tp->calls, tp->waits, tp->substs, tp->runaways,
+                 tp->nsec / 1000000.0, tp->nsec / 1000.0 / tp->calls, tp->max_nsec / 1000.0);
+  }
+}
+
+
+static void trig_prof_show(struct char_data *ch, int top)
+{
+  std::vector<trig_prof_entry> all;
+  unsigned long long nsec = 0;
+  unsigned long calls = 0;
+  long secs;
+
+  for (const auto &it : trig_profs) {
+    all.push_back(trig_prof_entry(it.first, &it.second));
+    nsec += it.second.nsec;
+    calls += it.second.calls;
+  }
+
+  secs = trig_prof_since ? (long) (time(0) - trig_prof_since) : 0;
+  send_to_char(ch, "Trigger profiling is %s.  Over the last %ld:%02ld:%02ld, %d triggers ran %lu times "
+                   "for %.2f ms.\r\n", trig_prof_on ? "on" : "off", secs / 3600, (secs / 60) % 60,
+               secs % 60, (int) all.size(), calls, nsec / 1000000.0);
+  if (all.empty())
+    return;
+
+  trig_prof_list(ch, all, top, trig_prof_by_total, "total time");
+  trig_prof_list(ch, all, top, trig_prof_by_call, "time per call");
+}
+
+
+static void trig_prof_csv(struct char_data *ch, const char *name)
+{
+  char fname[MAX_INPUT_LENGTH];
+  FILE *fl;
+
+  if (!*name)
+    name = "tprofile.csv";
+  if (*name == '.' || strchr(name, '/')) {
+    send_to_char(ch, "Just a file name, please; it goes in %s.\r\n", LIB_MISC);
+    return;
+  }
+  snprintf(fname, sizeof(fname), "%s%s", LIB_MISC, name);
+
+  if (!(fl = fopen(fname, "w"))) {
+    log("SYSERR: Couldn't write trigger profile to %s: %s", fname, strerror(errno));
+    send_to_char(ch, "Couldn't open %s for writing.\r\n", fname);
+    return;
+  }
+
+  fprintf(fl, "vnum,name,calls,lines,waits,substs,runaways,total_ns,max_ns,window_s\n");
+  for (const auto &it : trig_profs) {
+    const struct trig_prof *tp = &it.second;
+    const char *p;
+
+    fprintf(fl, "%lld,\"", (long long) it.first);
+    for (p = trig_prof_name(it.first); *p; p++)
+      fprintf(fl, *p == '"' ? "\"\"" : "%c", *p);
+    fprintf(fl, "\",%lu,%lu,%lu,%lu,%lu,%llu,%llu,%ld\n", tp->calls, tp->lines, tp->waits,
+            tp->substs, tp->runaways, tp->nsec, tp->max_nsec,
+            trig_prof_since ? (long) (time(0) - trig_prof_since) : 0L);
+  }
+  fclose(fl);
+
+  send_to_char(ch, "Wrote %d triggers to %s.\r\n", (int) trig_profs.size(), fname);
+}
+
+
+ACMD(do_tprofile)
+{
+  char arg[MAX_INPUT_LENGTH], arg2[MAX_INPUT_LENGTH];
+
+  two_arguments(argument, arg, arg2);
+
+  if (!*arg)
+    trig_prof_show(ch, TPROF_TOP);
+  else if (is_number(arg))
+    trig_prof_show(ch, MAX(1, MIN(atoi(arg), TPROF_TOP_MAX)));
+  else if (!strcasecmp(arg, "on")) {
+    if (!trig_prof_on)
+      trig_prof_reset();
+    trig_prof_on = TRUE;
+    send_to_char(ch, "Triggers will be profiled.\r\n");
+  } else if (!strcasecmp(arg, "off")) {
+    trig_prof_on = FALSE;
+    send_to_char(ch, "Triggers will no longer be profiled; what's been gathered is kept.\r\n");
+  } else if (!strcasecmp(arg, "reset")) {
+    trig_prof_reset();
+    send_to_char(ch, "Trigger profile cleared.\r\n");
+  } else if (!strcasecmp(arg, "csv"))
+    trig_prof_csv(ch, arg2);
+  else
+    send_to_char(ch, "Usage: tprofile [<count> | on | off | reset | csv [<file>]]\r\n");
+}
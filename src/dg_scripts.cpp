@@ -16,6 +16,12 @@
 #include "handler.h"
 #include "constants.h"
 #include "comm.h"
+#include "keywords.h"
+#include "pool.h"
+#include "profile.h"
+
+#include <unordered_set>
+#include <set>
 
 #define PULSES_PER_MUD_HOUR     (SECS_PER_MUD_HOUR*PASSES_PER_SEC)
 
@@ -59,8 +65,26 @@ void extract_value(struct script_data *sc, trig_data *trig, char *cmd);
 void dg_letter_value(struct script_data *sc, trig_data *trig, char *cmd);
 struct cmdlist_element *
 find_case(struct trig_data *trig, struct cmdlist_element *cl,
-          void *go, struct script_data *sc, int type, char *cond);
+          void *go, struct script_data *sc, int type, char *result);
 struct cmdlist_element *find_done(struct cmdlist_element *cl);
+static int dg_if_cond(struct cmdlist_element *c, char *cond, void *go,
+                      struct script_data *sc, trig_data *trig, int type);
+static int dg_case_cond(struct cmdlist_element *c, char *value, char *label,
+                        void *go, struct script_data *sc, trig_data *trig);
+static int dg_command(const char *line, bool substituted);
+static struct cmdlist_element *compiled_else_end(trig_data *trig,
+                      struct cmdlist_element *cl, void *go,
+                      struct script_data *sc, int type);
+static struct cmdlist_element *compiled_case(trig_data *trig,
+                      struct cmdlist_element *cl, void *go,
+                      struct script_data *sc, char *result);
+static void dg_verify_line(trig_data *trig, struct cmdlist_element *cl);
+static void dg_verify_command(trig_data *trig, struct cmdlist_element *cl,
+                              int command, char *cmd);
+static void dg_verify_branch(trig_data *trig, struct cmdlist_element *cl,
+                             struct cmdlist_element *got, int depth_before,
+                             char *result);
+ACMD(do_tverify);
 int fgetline(FILE *file, char *p);
 struct char_data *find_char_by_uid_in_lookup_table(long uid);
 struct obj_data *find_obj_by_uid_in_lookup_table(long uid);
@@ -70,6 +94,74 @@ ACMD(do_detach);
 ACMD(do_vdelete);
 ACMD(do_tstat);
 
+/* which script command a DG_OP_COMMAND line runs */
+#define DG_CMD_DYNAMIC		0	/* can't tell until substituted	*/
+#define DG_CMD_EVAL		1
+#define DG_CMD_NOP		2
+#define DG_CMD_EXTRACT		3
+#define DG_CMD_DG_LETTER	4
+#define DG_CMD_MAKEUID		5
+#define DG_CMD_HALT		6
+#define DG_CMD_DG_CAST		7
+#define DG_CMD_DG_AFFECT	8
+#define DG_CMD_GLOBAL		9
+#define DG_CMD_CONTEXT		10
+#define DG_CMD_REMOTE		11
+#define DG_CMD_RDELETE		12
+#define DG_CMD_RETURN		13
+#define DG_CMD_SET		14
+#define DG_CMD_UNSET		15
+#define DG_CMD_WAIT		16
+#define DG_CMD_ATTACH		17
+#define DG_CMD_DETACH		18
+#define DG_CMD_VERSION		19
+#define DG_CMD_OTHER		20	/* a command for the interpreter */
+
+/* where find_else_end()/find_case() go on to from a line */
+#define DG_ARM_STOP		0	/* stop at arm			*/
+#define DG_ARM_ELSEIF		1	/* arm is an elseif to test	*/
+#define DG_ARM_ELSE		2	/* arm is an else to take	*/
+#define DG_ARM_CASE		3	/* arm is a case to test	*/
+
+/* in the order script_driver() used to try them */
+static const struct {
+  const char *word;
+  int command;
+} dg_commands[] = {
+  { "eval "	, DG_CMD_EVAL },
+  { "nop "	, DG_CMD_NOP },
+  { "extract "	, DG_CMD_EXTRACT },
+  { "dg_letter "	, DG_CMD_DG_LETTER },
+  { "makeuid "	, DG_CMD_MAKEUID },
+  { "halt"	, DG_CMD_HALT },
+  { "dg_cast "	, DG_CMD_DG_CAST },
+  { "dg_affect "	, DG_CMD_DG_AFFECT },
+  { "global "	, DG_CMD_GLOBAL },
+  { "context "	, DG_CMD_CONTEXT },
+  { "remote "	, DG_CMD_REMOTE },
+  { "rdelete "	, DG_CMD_RDELETE },
+  { "return "	, DG_CMD_RETURN },
+  { "set "	, DG_CMD_SET },
+  { "unset "	, DG_CMD_UNSET },
+  { "wait "	, DG_CMD_WAIT },
+  { "attach "	, DG_CMD_ATTACH },
+  { "detach "	, DG_CMD_DETACH },
+  { "version"	, DG_CMD_VERSION },
+  { NULL	, DG_CMD_OTHER }
+};
+
+/*
+ * With 'tverify on' every line the driver runs is checked against what
+ * the old text scanners make of it.  Branch conditions are noted as the
+ * driver tests them, and the scanners are replayed on those answers
+ * instead of evaluating anything twice.
+ */
+static int dg_verify_compiled = FALSE;
+static std::vector<std::pair<struct cmdlist_element *, int>> dg_conds;
+static size_t dg_replay_pos = 0;
+static bool dg_replaying = false, dg_replay_failed = false;
+static unsigned long dg_verified = 0, dg_mismatches = 0;
+
 /* Return pointer to first occurrence of string ct in */
 /* cs, or NULL if not present.  Case insensitive */
 char *str_str(char *cs, char *ct)
@@ -128,7 +220,7 @@ obj_data *get_obj_in_list(char *name, obj_data *list)
           return i;
     } else {
       for (i = list; i; i = i->next_content)
-        if (isname(name, i->name))
+        if (isname_obj(name, i))
           return i;
     }
 
@@ -163,7 +255,7 @@ obj_data *get_object_in_equip(char_data * ch, char *name)
 
     for (j = 0; (j < NUM_WEARS) && (n <= number); j++)
       if ((obj = GET_EQ(ch, j)))
-        if (isname(tmp, obj->name))
+        if (isname_obj(tmp, obj))
           if (++n == number)
             return (obj);
   }
@@ -291,6 +383,7 @@ room_data *find_room(long n)
 /* search the entire world for a char, and return a pointer */
 char_data *get_char(char *name)
 {
+  static std::vector<char_data *> found;
   char_data *i;
 
   if (*name == UID_CHAR) {
@@ -299,10 +392,11 @@ char_data *get_char(char *name)
     if (i && valid_dg_target(i, DG_ALLOW_GODS))
       return i;
   } else {
-    for (i = character_list; i; i = i->next)
-      if (isname(name, i->name) &&
-          valid_dg_target(i, DG_ALLOW_GODS))
-        return i;
+    keyword_find_chars(name, found);
+    for (auto vict : found)
+      if (isname_char(name, vict) &&
+          valid_dg_target(vict, DG_ALLOW_GODS))
+        return vict;
   }
 
   return NULL;
@@ -324,7 +418,7 @@ char_data *get_char_near_obj(obj_data *obj, char *name)
     room_rnum num;
     if ((num = obj_room(obj)) != NOWHERE)
       for (ch = world[num].people; ch; ch = ch->next_in_room)
-        if (isname(name, ch->name) &&
+        if (isname_char(name, ch) &&
             valid_dg_target(ch, DG_ALLOW_GODS))
           return ch;
   }
@@ -348,7 +442,7 @@ char_data *get_char_in_room(room_data *room, char *name)
       return ch;
   } else {
     for (ch = room->people; ch; ch = ch->next_in_room)
-      if (isname(name, ch->name) &&
+      if (isname_char(name, ch) &&
           valid_dg_target(ch, DG_ALLOW_GODS))
         return ch;
     }
@@ -379,7 +473,7 @@ obj_data *get_obj_near_obj(obj_data *obj, char *name)
 
       if (id == GET_ID(obj->in_obj))
         return obj->in_obj;
-    } else if (isname(name, obj->in_obj->name))
+    } else if (isname_obj(name, obj->in_obj))
       return obj->in_obj;
   }
   /* or worn ?*/
@@ -405,13 +499,14 @@ obj_data *get_obj_near_obj(obj_data *obj, char *name)
 /* returns the object in the world with name name, or NULL if not found */
 obj_data *get_obj(char *name)
 {
-  obj_data *obj;
+  static std::vector<obj_data *> found;
 
   if (*name == UID_CHAR)
     return find_obj(atoi(name + 1));
   else {
-    for (obj = object_list; obj; obj = obj->next)
-      if (isname(name, obj->name))
+    keyword_find_objs(name, found);
+    for (auto obj : found)
+      if (isname_obj(name, obj))
         return obj;
   }
 
@@ -439,6 +534,7 @@ room_data *get_room(char *name)
  */
 char_data *get_char_by_obj(obj_data *obj, char *name)
 {
+  static std::vector<char_data *> found;
   char_data *ch;
 
   if (*name == UID_CHAR) {
@@ -448,19 +544,20 @@ char_data *get_char_by_obj(obj_data *obj, char *name)
       return ch;
   } else {
     if (obj->carried_by &&
-        isname(name, obj->carried_by->name) &&
+        isname_char(name, obj->carried_by) &&
         valid_dg_target(obj->carried_by, DG_ALLOW_GODS))
       return obj->carried_by;
 
     if (obj->worn_by &&
-        isname(name, obj->worn_by->name) &&
+        isname_char(name, obj->worn_by) &&
         valid_dg_target(obj->worn_by, DG_ALLOW_GODS))
       return obj->worn_by;
 
-    for (ch = character_list; ch; ch = ch->next)
-      if (isname(name, ch->name) &&
-          valid_dg_target(ch, DG_ALLOW_GODS))
-        return ch;
+    keyword_find_chars(name, found);
+    for (auto vict : found)
+      if (isname_char(name, vict) &&
+          valid_dg_target(vict, DG_ALLOW_GODS))
+        return vict;
   }
 
   return NULL;
@@ -473,6 +570,7 @@ char_data *get_char_by_obj(obj_data *obj, char *name)
  */
 char_data *get_char_by_room(room_data *room, char *name)
 {
+  static std::vector<char_data *> found;
   char_data *ch;
 
   if (*name == UID_CHAR) {
@@ -482,14 +580,15 @@ char_data *get_char_by_room(room_data *room, char *name)
       return ch;
   } else {
     for (ch = room->people; ch; ch = ch->next_in_room)
-      if (isname(name, ch->name) &&
+      if (isname_char(name, ch) &&
           valid_dg_target(ch, DG_ALLOW_GODS))
         return ch;
 
-    for (ch = character_list; ch; ch = ch->next)
-      if (isname(name, ch->name) &&
-          valid_dg_target(ch, DG_ALLOW_GODS))
-        return ch;
+    keyword_find_chars(name, found);
+    for (auto vict : found)
+      if (isname_char(name, vict) &&
+          valid_dg_target(vict, DG_ALLOW_GODS))
+        return vict;
   }
 
   return NULL;
@@ -514,7 +613,7 @@ obj_data *get_obj_by_obj(obj_data *obj, char *name)
   if (obj->contains && (i = get_obj_in_list(name, obj->contains)))
     return i;
 
-  if (obj->in_obj && isname(name, obj->in_obj->name))
+  if (obj->in_obj && isname_obj(name, obj->in_obj))
       return obj->in_obj;
 
   if (obj->worn_by && (i = get_object_in_equip(obj->worn_by, name)))
@@ -544,7 +643,7 @@ obj_data *get_obj_in_room(room_data *room, char *name)
               return obj;
   } else {
       for (obj = room->contents; obj; obj = obj->next_content)
-          if (isname(name, obj->name))
+          if (isname_obj(name, obj))
               return obj;
   }
 
@@ -554,106 +653,147 @@ obj_data *get_obj_in_room(room_data *room, char *name)
 /* returns obj with name - searches room, then world */
 obj_data *get_obj_by_room(room_data *room, char *name)
 {
+  static std::vector<obj_data *> found;
   obj_data *obj;
 
   if (*name == UID_CHAR)
     return find_obj(atoi(name+1));
 
   for (obj = room->contents; obj; obj = obj->next_content)
-    if (isname(name, obj->name))
+    if (isname_obj(name, obj))
       return obj;
 
-  for (obj = object_list; obj; obj = obj->next)
-    if (isname(name, obj->name))
-      return obj;
+  keyword_find_objs(name, found);
+  for (auto thing : found)
+    if (isname_obj(name, thing))
+      return thing;
 
   return NULL;
 }
 
-/* checks every PULSE_SCRIPT for random triggers */
-void script_trigger_check(void)
-{
-  char_data *ch;
-  obj_data *obj;
-  struct room_data *room=NULL;
-  int nr;
-  struct script_data *sc;
-
-  for (ch = character_list; ch; ch = ch->next) {
-    if (SCRIPT(ch)) {
-      sc = SCRIPT(ch);
+/*
+ * Random and time triggers used to be found by walking every character,
+ * every object and every room each time round.  Now whatever holds one is
+ * filed here by periodic_trig_sync(), which is called wherever a script's
+ * trigger types change: mobs and objects through room_trig_sync(), rooms
+ * directly.  Mobs and objects are filed by address, as they are dropped
+ * when their script is extracted; rooms by vnum, since redit can move the
+ * world about, and a room that has lost its script is dropped when next
+ * looked at.
+ */
+struct periodic_trigs {
+  std::unordered_set<char_data *> mobs;
+  std::unordered_set<obj_data *> objs;
+  std::set<room_vnum> rooms;
+};
 
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_RANDOM) &&
-          (!is_empty(world[IN_ROOM(ch)].zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        random_mtrigger(ch);
-    }
-  }
+static struct periodic_trigs random_trigs, time_trigs;
 
-  for (obj = object_list; obj; obj = obj->next) {
-    if (SCRIPT(obj)) {
-      sc = SCRIPT(obj);
 
-      if (IS_SET(SCRIPT_TYPES(sc), OTRIG_RANDOM))
-        random_otrigger(obj);
-    }
+static void periodic_trig_file(struct periodic_trigs *pt, void *thing, int type, bool held)
+{
+  switch (type) {
+    case MOB_TRIGGER:
+      if (held)
+        pt->mobs.insert((char_data *) thing);
+      else
+        pt->mobs.erase((char_data *) thing);
+      break;
+    case OBJ_TRIGGER:
+      if (held)
+        pt->objs.insert((obj_data *) thing);
+      else
+        pt->objs.erase((obj_data *) thing);
+      break;
+    case WLD_TRIGGER:
+      if (held)
+        pt->rooms.insert(((room_data *) thing)->number);
+      else
+        pt->rooms.erase(((room_data *) thing)->number);
+      break;
   }
+}
 
-  for (nr = 0; nr <= top_of_world; nr++) {
-    if (SCRIPT(&world[nr])) {
-      room = &world[nr];
-      sc = SCRIPT(room);
 
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_RANDOM) &&
-          (!is_empty(room->zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        random_wtrigger(room);
-    }
+/* File a mob, object or room by the random and time triggers it holds. */
+void periodic_trig_sync(void *thing, int type)
+{
+  struct script_data *sc = NULL;
+
+  switch (type) {
+    case MOB_TRIGGER:  sc = SCRIPT((char_data *) thing);  break;
+    case OBJ_TRIGGER:  sc = SCRIPT((obj_data *) thing);   break;
+    case WLD_TRIGGER:  sc = SCRIPT((room_data *) thing);  break;
   }
+
+  /* the MTRIG_, OTRIG_ and WTRIG_ random and time bits are the same */
+  periodic_trig_file(&random_trigs, thing, type, sc && IS_SET(SCRIPT_TYPES(sc), WTRIG_RANDOM));
+  periodic_trig_file(&time_trigs, thing, type, sc && IS_SET(SCRIPT_TYPES(sc), WTRIG_TIME));
 }
 
-void check_time_triggers(void)
+
+/*
+ * Run one kind of periodic trigger.  A trigger can purge or load things,
+ * so each set is copied first, and anything dropped from it since is
+ * passed over.
+ */
+static void periodic_trig_run(struct periodic_trigs *pt, long bit, void (*mob_func)(char_data *),
+                              void (*obj_func)(obj_data *), void (*wld_func)(struct room_data *))
 {
-  char_data *ch;
-  obj_data *obj;
-  struct room_data *room=NULL;
-  int nr;
+  static std::vector<char_data *> mobs;
+  static std::vector<obj_data *> objs;
+  static std::vector<room_vnum> rooms;
   struct script_data *sc;
+  struct room_data *room;
+  room_rnum nr;
 
-  for (ch = character_list; ch; ch = ch->next) {
-    if (SCRIPT(ch)) {
-      sc = SCRIPT(ch);
+  mobs.assign(pt->mobs.begin(), pt->mobs.end());
+  for (auto ch : mobs) {
+    if (!pt->mobs.count(ch) || !(sc = SCRIPT(ch)) || IN_ROOM(ch) == NOWHERE)
+      continue;
 
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_TIME) &&
-          (!is_empty(world[IN_ROOM(ch)].zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        time_mtrigger(ch);
-    }
+    if (IS_SET(SCRIPT_TYPES(sc), bit) &&
+        (!is_empty(world[IN_ROOM(ch)].zone) ||
+         IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
+      mob_func(ch);
   }
 
-  for (obj = object_list; obj; obj = obj->next) {
-    if (SCRIPT(obj)) {
-      sc = SCRIPT(obj);
+  objs.assign(pt->objs.begin(), pt->objs.end());
+  for (auto obj : objs) {
+    if (!pt->objs.count(obj) || !(sc = SCRIPT(obj)))
+      continue;
 
-      if (IS_SET(SCRIPT_TYPES(sc), OTRIG_TIME))
-        time_otrigger(obj);
-    }
+    if (IS_SET(SCRIPT_TYPES(sc), bit))
+      obj_func(obj);
   }
 
-  for (nr = 0; nr <= top_of_world; nr++) {
-    if (SCRIPT(&world[nr])) {
-      room = &world[nr];
-      sc = SCRIPT(room);
-
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_TIME) &&
-          (!is_empty(room->zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        time_wtrigger(room);
+  rooms.assign(pt->rooms.begin(), pt->rooms.end());
+  for (auto vnum : rooms) {
+    if ((nr = real_room(vnum)) == NOWHERE || !(sc = SCRIPT(&world[nr])) ||
+        !IS_SET(SCRIPT_TYPES(sc), bit)) {
+      pt->rooms.erase(vnum);
+      continue;
     }
+    room = &world[nr];
+
+    if (!is_empty(room->zone) || IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL))
+      wld_func(room);
   }
 }
 
 
+/* checks every PULSE_SCRIPT for random triggers */
+void script_trigger_check(void)
+{
+  periodic_trig_run(&random_trigs, WTRIG_RANDOM, random_mtrigger, random_otrigger, random_wtrigger);
+}
+
+void check_time_triggers(void)
+{
+  periodic_trig_run(&time_trigs, WTRIG_TIME, time_mtrigger, time_otrigger, time_wtrigger);
+}
+
+
 EVENTFUNC(trig_wait_event)
 {
   struct wait_event_data *wait_event_obj = (struct wait_event_data *)event_obj;
@@ -941,8 +1081,9 @@ ACMD(do_attach)
     }
 
     if (!SCRIPT(victim))
-      CREATE(SCRIPT(victim), struct script_data, 1);
+      POOL_CREATE(SCRIPT(victim), struct script_data, script_pool);
     add_trigger(SCRIPT(victim), trig, loc);
+    room_trig_sync(victim, MOB_TRIGGER);
 
     send_to_char(ch, "Trigger %d (%s) attached to %s [%d].\r\n",
                  tn, GET_TRIG_NAME(trig), GET_SHORT(victim), GET_MOB_VNUM(victim));
@@ -979,8 +1120,9 @@ ACMD(do_attach)
     }
 
     if (!SCRIPT(object))
-      CREATE(SCRIPT(object), struct script_data, 1);
+      POOL_CREATE(SCRIPT(object), struct script_data, script_pool);
     add_trigger(SCRIPT(object), trig, loc);
+    room_trig_sync(object, OBJ_TRIGGER);
 
     send_to_char(ch, "Trigger %d (%s) attached to %s [%d].\r\n",
                  tn, GET_TRIG_NAME(trig),
@@ -1016,8 +1158,9 @@ ACMD(do_attach)
     room = &world[rnum];
 
     if (!SCRIPT(room))
-      CREATE(SCRIPT(room), struct script_data, 1);
+      POOL_CREATE(SCRIPT(room), struct script_data, script_pool);
     add_trigger(SCRIPT(room), trig, loc);
+    periodic_trig_sync(room, WLD_TRIGGER);
 
     send_to_char(ch, "Trigger %d (%s) attached to room %d.\r\n",
                  tn, GET_TRIG_NAME(trig), world[rnum].number);
@@ -1130,7 +1273,8 @@ ACMD(do_detach)
       send_to_char(ch, "Trigger removed.\r\n");
       if (!TRIGGERS(SCRIPT(room))) {
         extract_script(room, WLD_TRIGGER);
-      }
+      } else
+        periodic_trig_sync(room, WLD_TRIGGER);
     } else
       send_to_char(ch, "That trigger was not found.\r\n");
   }
@@ -1212,7 +1356,8 @@ ACMD(do_detach)
         send_to_char(ch, "Trigger removed.\r\n");
         if (!TRIGGERS(SCRIPT(victim))) {
           extract_script(victim, MOB_TRIGGER);
-        }
+        } else
+          room_trig_sync(victim, MOB_TRIGGER);
       } else
         send_to_char(ch, "That trigger was not found.\r\n");
     }
@@ -1236,7 +1381,8 @@ ACMD(do_detach)
         send_to_char(ch, "Trigger removed.\r\n");
         if (!TRIGGERS(SCRIPT(object))) {
           extract_script(object, OBJ_TRIGGER);
-        }
+        } else
+          room_trig_sync(object, OBJ_TRIGGER);
       } else
         send_to_char(ch, "That trigger was not found.\r\n");
     }
@@ -1615,7 +1761,7 @@ struct cmdlist_element *find_else_end(trig_data *trig,
       c = find_end(trig, c);
 
     else if (!strncasecmp("elseif ", p, 7)) {
-      if (process_if(p + 7, go, sc, trig, type)) {
+      if (dg_if_cond(c, p + 7, go, sc, trig, type)) {
         GET_TRIG_DEPTH(trig)++;
         return c;
       }
@@ -1806,22 +1952,25 @@ void process_attach(void *go, struct script_data *sc, trig_data *trig,
       return;
     }
     if (!SCRIPT(c))
-      CREATE(SCRIPT(c), struct script_data, 1);
+      POOL_CREATE(SCRIPT(c), struct script_data, script_pool);
     add_trigger(SCRIPT(c), newtrig, -1);
+    room_trig_sync(c, MOB_TRIGGER);
     return;
   }
 
   if (o) {
     if (!SCRIPT(o))
-      CREATE(SCRIPT(o), struct script_data, 1);
+      POOL_CREATE(SCRIPT(o), struct script_data, script_pool);
     add_trigger(SCRIPT(o), newtrig, -1);
+    room_trig_sync(o, OBJ_TRIGGER);
     return;
   }
 
   if (r) {
     if (!SCRIPT(r))
-      CREATE(SCRIPT(r), struct script_data, 1);
+      POOL_CREATE(SCRIPT(r), struct script_data, script_pool);
     add_trigger(SCRIPT(r), newtrig, -1);
+    periodic_trig_sync(r, WLD_TRIGGER);
     return;
   }
 
@@ -1883,7 +2032,8 @@ void process_detach(void *go, struct script_data *sc, trig_data *trig,
     if (remove_trigger(SCRIPT(c), trignum_s)) {
       if (!TRIGGERS(SCRIPT(c))) {
         extract_script(c, MOB_TRIGGER);
-      }
+      } else
+        room_trig_sync(c, MOB_TRIGGER);
     }
     return;
   }
@@ -1896,7 +2046,8 @@ void process_detach(void *go, struct script_data *sc, trig_data *trig,
     if (remove_trigger(SCRIPT(o), trignum_s)) {
       if (!TRIGGERS(SCRIPT(o))) {
         extract_script(o, OBJ_TRIGGER);
-      }
+      } else
+        room_trig_sync(o, OBJ_TRIGGER);
     }
     return;
   }
@@ -1909,7 +2060,8 @@ void process_detach(void *go, struct script_data *sc, trig_data *trig,
     if (remove_trigger(SCRIPT(r), trignum_s)) {
       if (!TRIGGERS(SCRIPT(r))) {
         extract_script(r, WLD_TRIGGER);
-      }
+      } else
+        periodic_trig_sync(r, WLD_TRIGGER);
     }
     return;
   }
@@ -2098,15 +2250,10 @@ void process_remote(struct script_data *sc, trig_data *trig, char *cmd)
   }
 
   /* find the locally owned variable */
-  for (vd = GET_TRIG_VARS(trig); vd; vd = vd->next)
-    if (!strcasecmp(vd->name, buf))
-      break;
+  vd = find_var(GET_TRIG_VARS(trig), buf);
 
   if (!vd)
-    for (vd = sc->global_vars; vd; vd = vd->next)
-      if (!strcasecmp(vd->name, var) &&
-          (vd->context==0 || vd->context==sc->context))
-        break;
+    vd = find_var_in_context(sc->global_vars, var, sc->context);
 
   if (!vd) {
     script_log("Trigger: %s, VNum %d. local var '%s' not found in remote call",
@@ -2150,7 +2297,7 @@ void process_remote(struct script_data *sc, trig_data *trig, char *cmd)
  */
 ACMD(do_vdelete)
 {
-  struct trig_var_data *vd, *vd_prev=NULL;
+  struct trig_var_data *vd;
   struct script_data *sc_remote=NULL;
   char *var, *uid_p;
   char buf[MAX_INPUT_LENGTH], buf2[MAX_INPUT_LENGTH];
@@ -2203,36 +2350,20 @@ ACMD(do_vdelete)
   }
 
   if (*var == '*' || is_abbrev(var, "all")) {
-    struct trig_var_data *vd_next;
-    for (vd = sc_remote->global_vars; vd; vd = vd_next) {
-      vd_next = vd->next;
-      free(vd->value);
-      free(vd->name);
-      free(vd);
-    }
+    free_varlist(sc_remote->global_vars);
     sc_remote->global_vars = NULL;
     send_to_char(ch, "All variables deleted from that id.\r\n");
     return;
   }
 
   /* find the global */
-  for (vd = sc_remote->global_vars; vd; vd_prev = vd, vd = vd->next)
-    if (!strcasecmp(vd->name, var))
-      break;
-
-  if (!vd) {
+  if (!(vd = find_var(sc_remote->global_vars, var))) {
     send_to_char(ch, "That variable cannot be located.\r\n");
     return;
   }
 
   /* ok, delete the variable */
-  if (vd_prev) vd_prev->next = vd->next;
-  else sc_remote->global_vars = vd->next;
-
-  /* and free up the space */
-  free(vd->value);
-  free(vd->name);
-  free(vd);
+  delete_var(&sc_remote->global_vars, vd);
 
   send_to_char(ch, "Deleted.\r\n");
 }
@@ -2252,7 +2383,7 @@ int perform_set_dg_var(struct char_data *ch, struct char_data *vict, char *val_a
 		return 0;
   }
   if (!SCRIPT(vict))
-     CREATE(SCRIPT(vict), struct script_data, 1);
+     POOL_CREATE(SCRIPT(vict), struct script_data, script_pool);
 
   add_var(&(SCRIPT(vict)->global_vars), var_name, var_value, 0);
   return 1;
@@ -2264,7 +2395,7 @@ int perform_set_dg_var(struct char_data *ch, struct char_data *vict, char *val_a
  */
 void process_rdelete(struct script_data *sc, trig_data *trig, char *cmd)
 {
-  struct trig_var_data *vd, *vd_prev=NULL;
+  struct trig_var_data *vd;
   struct script_data *sc_remote=NULL;
   char *line, *var, *uid_p;
   char arg[MAX_INPUT_LENGTH], buf[MAX_STRING_LENGTH], buf2[MAX_STRING_LENGTH];
@@ -2314,21 +2445,12 @@ void process_rdelete(struct script_data *sc, trig_data *trig, char *cmd)
   if (sc_remote->global_vars==NULL) return; /* no script globals */
 
   /* find the global */
-  for (vd = sc_remote->global_vars; vd; vd_prev = vd, vd = vd->next)
-    if (!strcasecmp(vd->name, var) &&
-        (vd->context==0 || vd->context==sc->context))
-      break;
+  vd = find_var_in_context(sc_remote->global_vars, var, sc->context);
 
   if (!vd) return; /* the variable doesn't exist, or is the wrong context */
 
   /* ok, delete the variable */
-  if (vd_prev) vd_prev->next = vd->next;
-  else sc_remote->global_vars = vd->next;
-
-  /* and free up the space */
-  free(vd->value);
-  free(vd->name);
-  free(vd);
+  delete_var(&sc_remote->global_vars, vd);
 }
 
 
@@ -2350,9 +2472,7 @@ void process_global(struct script_data *sc, trig_data *trig, char *cmd, long id)
     return;
   }
 
-  for (vd = GET_TRIG_VARS(trig); vd; vd = vd->next)
-    if (!strcasecmp(vd->name, var))
-      break;
+  vd = find_var(GET_TRIG_VARS(trig), var);
 
   if (!vd) {
     script_log("Trigger: %s, VNum %d. local var '%s' not found in global call",
@@ -2478,15 +2598,16 @@ void dg_letter_value(struct script_data *sc, trig_data *trig, char *cmd)
       TRIG_NEW     just started from dg_triggers.c
       TRIG_RESTART restarted after a 'wait'
 */
-int script_driver(void *go_adress, trig_data *trig, int type, int mode)
+static int script_run(void *go_adress, trig_data *trig, int type, int mode)
 {
   static int depth = 0;
   int ret_val = 1;
   struct cmdlist_element *cl;
-  char cmd[MAX_INPUT_LENGTH], *p;
+  char cmd[MAX_INPUT_LENGTH], result[MAX_INPUT_LENGTH], *p;
   struct script_data *sc = 0;
   struct cmdlist_element *temp;
   unsigned long loops = 0;
+  int command, depth_before;
   void *go = NULL;
 
   void obj_command_interpreter(obj_data *obj, char *argument);
@@ -2550,22 +2671,34 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
 
   dg_owner_purged = 0;
 
+  if (trig->cmdlist && trig->cmdlist->op == DG_OP_NONE)
+    compile_cmdlist(trig);
+
   for (cl = (mode == TRIG_NEW) ? trig->cmdlist : trig->curr_state;
        cl && GET_TRIG_DEPTH(trig); cl = cl->next) {
-    for (p = cl->cmd; *p && isspace(*p); p++);
+    p = cl->line;
+    TRIG_PROF_COUNT(lines);
 
-    if (*p == '*') /* comment */
+    if (dg_verify_compiled)
+      dg_verify_line(trig, cl);
+
+    if (cl->op == DG_OP_COMMENT)
       continue;
 
-    else if (!strncasecmp(p, "if ", 3)) {
+    else if (cl->op == DG_OP_IF) {
       if (process_if(p + 3, go, sc, trig, type))
         GET_TRIG_DEPTH(trig)++;
-      else
-        cl = find_else_end(trig, cl, go, sc, type);
+      else {
+        depth_before = GET_TRIG_DEPTH(trig);
+        dg_conds.clear();
+        temp = compiled_else_end(trig, cl, go, sc, type);
+        if (dg_verify_compiled)
+          dg_verify_branch(trig, cl, temp, depth_before, NULL);
+        cl = temp;
+      }
     }
 
-    else if (!strncasecmp("elseif ", p, 7) ||
-       !strncasecmp("else", p, 4)) {
+    else if (cl->op == DG_OP_ELSEIF || cl->op == DG_OP_ELSE) {
       /*
        * if not in an if-block, ignore the extra 'else[if]' and warn about it
        */
@@ -2574,10 +2707,10 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
                    GET_TRIG_VNUM(trig));
         continue;
       }
-      cl = find_end(trig, cl);
+      cl = cl->jump;
       GET_TRIG_DEPTH(trig)--;
-    } else if (!strncasecmp("while ", p, 6)) {
-      temp = find_done(cl);
+    } else if (cl->op == DG_OP_WHILE) {
+      temp = cl->jump;
       if (!temp) {
         script_log("Trigger VNum %lld has 'while' without 'done'.",
                    GET_TRIG_VNUM(trig));
@@ -2589,9 +2722,15 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
          cl = temp;
          loops = 0;
       }
-    } else if (!strncasecmp("switch ", p, 7)) {
-      cl = find_case(trig, cl, go, sc, type, p + 7);
-    } else if (!strncasecmp("end", p, 3)) {
+    } else if (cl->op == DG_OP_SWITCH) {
+      eval_expr(p + 7, result, go, sc, trig, type);
+      depth_before = GET_TRIG_DEPTH(trig);
+      dg_conds.clear();
+      temp = compiled_case(trig, cl, go, sc, result);
+      if (dg_verify_compiled)
+        dg_verify_branch(trig, cl, temp, depth_before, result);
+      cl = temp;
+    } else if (cl->op == DG_OP_END) {
       /*
        * if not in an if-block, ignore the extra 'end' and warn about it.
        */
@@ -2601,17 +2740,15 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
         continue;
       }
       GET_TRIG_DEPTH(trig)--;
-    } else if (!strncasecmp("done", p, 4)) {
+    } else if (cl->op == DG_OP_DONE) {
       /* if in a while loop, cl->original is non-NULL */
       if (cl->original) {
-      char *orig_cmd = cl->original->cmd;
-      while (*orig_cmd && isspace(*orig_cmd)) orig_cmd++;
-      if (cl->original && process_if(orig_cmd + 6, go, sc, trig,
-          type)) {
+      if (process_if(cl->original->line + 6, go, sc, trig, type)) {
         cl = cl->original;
         loops++;
         GET_TRIG_LOOPS(trig)++;
         if (loops == 40) {
+          TRIG_PROF_COUNT(waits);
           process_wait(go, trig, type, "wait 1", cl);
            depth--;
           return ret_val;
@@ -2619,15 +2756,17 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
           if (GET_TRIG_LOOPS(trig) >= 5000) {
           script_log("Trigger VNum %d has looped 5,000 times!!!",
             GET_TRIG_VNUM(trig));
+            if (trig_prof_cur)
+              trig_prof_cur->runaway = TRUE;
             break;
           }
         } else {
          /* if we're falling through a switch statement, this ends it. */
         }
       }
-    } else if (!strncasecmp("break", p, 5)) {
-      cl = find_done(cl);
-    } else if (!strncasecmp("case", p, 4)) {
+    } else if (cl->op == DG_OP_BREAK) {
+      cl = cl->jump;
+    } else if (cl->op == DG_OP_CASE) {
        /* Do nothing, this allows multiple cases to a single instance */
     }
 
@@ -2636,63 +2775,71 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
 
       var_subst(go, sc, trig, type, p, cmd);
 
-      if (!strncasecmp(cmd, "eval ", 5))
+      /* Only a line starting with a variable has to be looked at again. */
+      command = cl->command;
+      if (command == DG_CMD_DYNAMIC)
+        command = dg_command(cmd, TRUE);
+      if (dg_verify_compiled)
+        dg_verify_command(trig, cl, command, cmd);
+
+      if (command == DG_CMD_EVAL)
         process_eval(go, sc, trig, type, cmd);
 
-      else if (!strncasecmp(cmd, "nop ", 4)); /* nop: do nothing */
+      else if (command == DG_CMD_NOP); /* nop: do nothing */
 
-      else if (!strncasecmp(cmd, "extract ", 8))
+      else if (command == DG_CMD_EXTRACT)
         extract_value(sc, trig, cmd);
 
-      else if (!strncasecmp(cmd, "dg_letter ", 10))
+      else if (command == DG_CMD_DG_LETTER)
         dg_letter_value(sc, trig, cmd);
 
-      else if (!strncasecmp(cmd, "makeuid ", 8))
+      else if (command == DG_CMD_MAKEUID)
         makeuid_var(go, sc, trig, type, cmd);
 
-      else if (!strncasecmp(cmd, "halt", 4))
+      else if (command == DG_CMD_HALT)
         break;
 
-      else if (!strncasecmp(cmd, "dg_cast ", 8))
+      else if (command == DG_CMD_DG_CAST)
         do_dg_cast(go, sc, trig, type, cmd);
 
-      else if (!strncasecmp(cmd, "dg_affect ", 10))
+      else if (command == DG_CMD_DG_AFFECT)
         do_dg_affect(go, sc, trig, type, cmd);
 
-      else if (!strncasecmp(cmd, "global ", 7))
+      else if (command == DG_CMD_GLOBAL)
         process_global(sc, trig, cmd, sc->context);
 
-      else if (!strncasecmp(cmd, "context ", 8))
+      else if (command == DG_CMD_CONTEXT)
         process_context(sc, trig, cmd);
 
-      else if (!strncasecmp(cmd, "remote ", 7))
+      else if (command == DG_CMD_REMOTE)
         process_remote(sc, trig, cmd);
 
-      else if (!strncasecmp(cmd, "rdelete ", 8))
+      else if (command == DG_CMD_RDELETE)
         process_rdelete(sc, trig, cmd);
 
-      else if (!strncasecmp(cmd, "return ", 7))
+      else if (command == DG_CMD_RETURN)
         ret_val = process_return(trig, cmd);
 
-      else if (!strncasecmp(cmd, "set ", 4))
+      else if (command == DG_CMD_SET)
         process_set(sc, trig, cmd);
 
-      else if (!strncasecmp(cmd, "unset ", 6))
+      else if (command == DG_CMD_UNSET)
         process_unset(sc, trig, cmd);
 
-      else if (!strncasecmp(cmd, "wait ", 5)) {
+      else if (command == DG_CMD_WAIT) {
+        TRIG_PROF_COUNT(waits);
         process_wait(go, trig, type, cmd, cl);
         depth--;
         return ret_val;
       }
 
-      else if (!strncasecmp(cmd, "attach ", 7))
+      else if (command == DG_CMD_ATTACH)
         process_attach(go, sc, trig, type, cmd);
 
-      else if (!strncasecmp(cmd, "detach ", 7))
+      else if (command == DG_CMD_DETACH)
         process_detach(go, sc, trig, type, cmd);
 
-      else if (!strncasecmp(cmd, "version", 7))
+      else if (command == DG_CMD_VERSION)
         mudlog(NRM, ADMLVL_GOD, TRUE, "%s", DG_SCRIPT_VERSION);
 
       else {
@@ -2732,6 +2879,33 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
   return ret_val;
 }
 
+/*
+ * Runs a trigger.  With 'tprofile' on, the run is timed and counted too;
+ * the trigger may be gone by the time it returns, so its vnum is taken
+ * first.
+ */
+int script_driver(void *go_adress, trig_data *trig, int type, int mode)
+{
+  struct trig_prof_run run, *outer;
+  unsigned long long start;
+  int ret_val;
+
+  if (!trig_prof_on)
+    return script_run(go_adress, trig, type, mode);
+
+  memset(&run, 0, sizeof(run));
+  run.vnum = GET_TRIG_VNUM(trig);
+  outer = trig_prof_cur;
+  trig_prof_cur = &run;
+  start = prof_clock();
+
+  ret_val = script_run(go_adress, trig, type, mode);
+
+  trig_prof_cur = outer;
+  trig_prof_done(&run, prof_clock() - start);
+  return ret_val;
+}
+
 /* returns the real number of the trigger with given virtual number */
 trig_rnum real_trigger(trig_vnum vnum)
 {
@@ -2776,19 +2950,17 @@ ACMD(do_tstat)
 }
 
 /*
-* scans for a case/default instance
+* scans for a case/default instance matching 'result', the value of the
+* switch expression.
 * returns the line containg the correct case instance, or the last
 * line of the trigger if not found.
 */
 struct cmdlist_element *
 find_case(struct trig_data *trig, struct cmdlist_element *cl,
-          void *go, struct script_data *sc, int type, char *cond)
+          void *go, struct script_data *sc, int type, char *result)
 {
-  char result[MAX_INPUT_LENGTH];
   struct cmdlist_element *c;
-  char *p, *buf;
-
-  eval_expr(cond, result, go, sc, trig, type);
+  char *p;
 
   if (!(cl->next))
     return cl;
@@ -2796,16 +2968,13 @@ find_case(struct trig_data *trig, struct cmdlist_element *cl,
   for (c = cl->next; c->next; c = c->next) {
     for (p = c->cmd; *p && isspace(*p); p++);
 
-    if (!strncasecmp("while ", p, 6) || !strncasecmp("switch", p, 6))
+    if (!strncasecmp("while ", p, 6) || !strncasecmp("switch", p, 6)) {
       c = find_done(c);
-    else if (!strncasecmp("case ", p, 5)) {
-      buf = (char*)malloc(MAX_STRING_LENGTH);
-      eval_op("==", result, p + 5, buf, go, sc, trig);
-      if (*buf && *buf!='0') {
-        free(buf);
+      if (!c->next) /* no done: don't run off the end */
+        return c;
+    } else if (!strncasecmp("case ", p, 5)) {
+      if (dg_case_cond(c, result, p + 5, go, sc, trig))
         return c;
-      }
-      free(buf);
     } else if (!strncasecmp("default", p, 7))
       return c;
     else if (!strncasecmp("done", p, 3))
@@ -2818,7 +2987,6 @@ find_case(struct trig_data *trig, struct cmdlist_element *cl,
 * scans for end of while/switch-blocks.
 * returns the line containg 'end', or the last
 * line of the trigger if not found.
-* Malformed scripts may cause NULL to be returned.
 */
 struct cmdlist_element *find_done(struct cmdlist_element *cl)
 {
@@ -2828,12 +2996,14 @@ struct cmdlist_element *find_done(struct cmdlist_element *cl)
   if (!cl || !(cl->next))
     return cl;
 
-  for (c = cl->next; c && c->next; c = c->next) {
+  for (c = cl->next; c->next; c = c->next) {
     for (p = c->cmd; *p && isspace(*p); p++);
 
-    if (!strncasecmp("while ", p, 6) || !strncasecmp("switch ", p, 7))
+    if (!strncasecmp("while ", p, 6) || !strncasecmp("switch ", p, 7)) {
       c = find_done(c);
-    else if (!strncasecmp("done", p, 3))
+      if (!c->next) /* no done: don't run off the end */
+        return c;
+    } else if (!strncasecmp("done", p, 3))
       return c;
   }
 
@@ -2841,6 +3011,354 @@ struct cmdlist_element *find_done(struct cmdlist_element *cl)
 }
 
 
+/*
+ * Triggers are compiled once, when they're loaded or saved from trigedit:
+ * each line gets its DG_OP_ and, for commands, its DG_CMD_, and the
+ * matching end/done of every block and the next elseif/else/end or case
+ * an if or switch can go on to are found ahead of time, using the same
+ * scanners that used to run on every execution.  The instances of a
+ * trigger share its prototype's cmdlist, so they share the compiling.
+ */
+static int dg_line_op(const char *p)
+{
+  if (*p == '*')
+    return (DG_OP_COMMENT);
+  if (!strncasecmp(p, "if ", 3))
+    return (DG_OP_IF);
+  if (!strncasecmp("elseif ", p, 7))
+    return (DG_OP_ELSEIF);
+  if (!strncasecmp("else", p, 4))
+    return (DG_OP_ELSE);
+  if (!strncasecmp("while ", p, 6))
+    return (DG_OP_WHILE);
+  if (!strncasecmp("switch ", p, 7))
+    return (DG_OP_SWITCH);
+  if (!strncasecmp("end", p, 3))
+    return (DG_OP_END);
+  if (!strncasecmp("done", p, 4))
+    return (DG_OP_DONE);
+  if (!strncasecmp("break", p, 5))
+    return (DG_OP_BREAK);
+  if (!strncasecmp("case", p, 4))
+    return (DG_OP_CASE);
+  return (DG_OP_COMMAND);
+}
+
+
+/*
+ * The script command a line runs.  Before substitution only the text up
+ * to the first % is known, so a command word that reaches past it gives
+ * DG_CMD_DYNAMIC, and the driver asks again once it has substituted.
+ */
+static int dg_command(const char *line, bool substituted)
+{
+  const char *pct = substituted ? NULL : strchr(line, '%');
+  size_t len, known = pct ? (size_t) (pct - line) : (size_t) -1;
+  int i;
+
+  for (i = 0; dg_commands[i].word; i++) {
+    len = strlen(dg_commands[i].word);
+    if (strncasecmp(line, dg_commands[i].word, len < known ? len : known))
+      continue;
+    return (len <= known ? dg_commands[i].command : DG_CMD_DYNAMIC);
+  }
+
+  return (DG_CMD_OTHER);
+}
+
+
+/* Where find_else_end() goes on to from 'cl', with no conditions true. */
+static void compile_else_arm(trig_data *trig, struct cmdlist_element *cl)
+{
+  struct cmdlist_element *c;
+
+  cl->arm = cl;
+  cl->arm_how = DG_ARM_STOP;
+  if (!cl->next)
+    return;
+
+  for (c = cl->next; c->next; c = c->next) {
+    if (c->op == DG_OP_IF)
+      c = c->jump;
+    else if (c->op == DG_OP_ELSEIF || c->op == DG_OP_ELSE || c->op == DG_OP_END) {
+      cl->arm = c;
+      cl->arm_how = c->op == DG_OP_ELSEIF ? DG_ARM_ELSEIF : c->op == DG_OP_ELSE ? DG_ARM_ELSE : DG_ARM_STOP;
+      return;
+    }
+
+    if (!c->next) {
+      script_log("Trigger VNum %lld has 'if' without 'end'. (error 4)", GET_TRIG_VNUM(trig));
+      cl->arm = c;
+      return;
+    }
+  }
+
+  if (c->op != DG_OP_END)
+    script_log("Trigger VNum %lld has 'if' without 'end'. (error 5)", GET_TRIG_VNUM(trig));
+  cl->arm = c;
+}
+
+
+/* Where find_case() goes on to from 'cl', with no cases matching. */
+static void compile_case_arm(struct cmdlist_element *cl)
+{
+  struct cmdlist_element *c;
+
+  cl->arm = cl;
+  cl->arm_how = DG_ARM_STOP;
+  if (!cl->next)
+    return;
+
+  for (c = cl->next; c->next; c = c->next) {
+    if (!strncasecmp("while ", c->line, 6) || !strncasecmp("switch", c->line, 6)) {
+      c = find_done(c);
+      if (!c->next)
+        break;
+    } else if (!strncasecmp("case ", c->line, 5)) {
+      cl->arm = c;
+      cl->arm_how = DG_ARM_CASE;
+      return;
+    } else if (!strncasecmp("default", c->line, 7) || !strncasecmp("done", c->line, 3))
+      break;
+  }
+
+  cl->arm = c;
+}
+
+
+void compile_cmdlist(trig_data *trig)
+{
+  struct cmdlist_element *c;
+
+  for (c = trig->cmdlist; c; c = c->next) {
+    for (c->line = c->cmd; *c->line && isspace(*c->line); c->line++);
+    c->op = dg_line_op(c->line);
+    c->command = c->op == DG_OP_COMMAND ? dg_command(c->line, FALSE) : DG_CMD_DYNAMIC;
+    c->jump = c->arm = NULL;
+    c->arm_how = DG_ARM_STOP;
+  }
+
+  /* Every if needs its end before any else-arm can skip over it. */
+  for (c = trig->cmdlist; c; c = c->next) {
+    if (c->op == DG_OP_IF || c->op == DG_OP_ELSEIF || c->op == DG_OP_ELSE)
+      c->jump = find_end(trig, c);
+    else if (c->op == DG_OP_WHILE || c->op == DG_OP_BREAK)
+      c->jump = find_done(c);
+  }
+
+  for (c = trig->cmdlist; c; c = c->next) {
+    if (c->op == DG_OP_IF || c->op == DG_OP_ELSEIF)
+      compile_else_arm(trig, c);
+    else if (c->op == DG_OP_SWITCH || !strncasecmp("case ", c->line, 5))
+      compile_case_arm(c);
+  }
+}
+
+
+/* find_else_end(), following the arms worked out by compile_cmdlist(). */
+static struct cmdlist_element *compiled_else_end(trig_data *trig,
+                      struct cmdlist_element *cl, void *go,
+                      struct script_data *sc, int type)
+{
+  struct cmdlist_element *c;
+
+  for (c = cl; c->arm_how == DG_ARM_ELSEIF; c = c->arm)
+    if (dg_if_cond(c->arm, c->arm->line + 7, go, sc, trig, type)) {
+      GET_TRIG_DEPTH(trig)++;
+      return (c->arm);
+    }
+
+  if (c->arm_how == DG_ARM_ELSE)
+    GET_TRIG_DEPTH(trig)++;
+  return (c->arm);
+}
+
+
+/* find_case(), following the arms worked out by compile_cmdlist(). */
+static struct cmdlist_element *compiled_case(trig_data *trig,
+                      struct cmdlist_element *cl, void *go,
+                      struct script_data *sc, char *result)
+{
+  struct cmdlist_element *c;
+
+  for (c = cl; c->arm_how == DG_ARM_CASE; c = c->arm)
+    if (dg_case_cond(c->arm, result, c->arm->line + 5, go, sc, trig))
+      return (c->arm);
+
+  return (c->arm);
+}
+
+
+static int dg_replay_cond(struct cmdlist_element *c)
+{
+  if (dg_replay_pos >= dg_conds.size() || dg_conds[dg_replay_pos].first != c) {
+    dg_replay_failed = true;
+    return (FALSE);
+  }
+  return (dg_conds[dg_replay_pos++].second);
+}
+
+
+/* An elseif condition, as tested by either driver. */
+static int dg_if_cond(struct cmdlist_element *c, char *cond, void *go,
+                      struct script_data *sc, trig_data *trig, int type)
+{
+  int result;
+
+  if (dg_replaying)
+    return (dg_replay_cond(c));
+
+  result = process_if(cond, go, sc, trig, type);
+  if (dg_verify_compiled)
+    dg_conds.emplace_back(c, result);
+  return (result);
+}
+
+
+/* Does case 'label' match the switch's 'value'? */
+static int dg_case_cond(struct cmdlist_element *c, char *value, char *label,
+                        void *go, struct script_data *sc, trig_data *trig)
+{
+  char *buf;
+  int result;
+
+  if (dg_replaying)
+    return (dg_replay_cond(c));
+
+  buf = (char *) malloc(MAX_STRING_LENGTH);
+  eval_op("==", value, label, buf, go, sc, trig);
+  result = (*buf && *buf != '0');
+  free(buf);
+
+  if (dg_verify_compiled)
+    dg_conds.emplace_back(c, result);
+  return (result);
+}
+
+
+static void dg_mismatch(trig_data *trig, struct cmdlist_element *cl, const char *what)
+{
+  dg_mismatches++;
+  script_log("Trigger VNum %lld: compiled %s differs from the text, at '%s'.",
+             GET_TRIG_VNUM(trig), what, cl->cmd);
+}
+
+
+/* Check a line's compiled form against the text scanners. */
+static void dg_verify_line(trig_data *trig, struct cmdlist_element *cl)
+{
+  char *p;
+
+  dg_verified++;
+  for (p = cl->cmd; *p && isspace(*p); p++);
+
+  if (cl->line != p || cl->op != dg_line_op(p))
+    dg_mismatch(trig, cl, "op");
+  else if ((cl->op == DG_OP_IF || cl->op == DG_OP_ELSEIF || cl->op == DG_OP_ELSE) &&
+           cl->jump != find_end(trig, cl))
+    dg_mismatch(trig, cl, "end");
+  else if ((cl->op == DG_OP_WHILE || cl->op == DG_OP_BREAK) && cl->jump != find_done(cl))
+    dg_mismatch(trig, cl, "done");
+}
+
+
+static void dg_verify_command(trig_data *trig, struct cmdlist_element *cl,
+                              int command, char *cmd)
+{
+  if (command != dg_command(cmd, TRUE))
+    dg_mismatch(trig, cl, "command");
+}
+
+
+/*
+ * The compiled driver went from if/switch 'cl' to 'got', noting the
+ * conditions it tested in dg_conds.  Replay find_else_end() or, given
+ * the switch's 'result', find_case() on them and compare.
+ */
+static void dg_verify_branch(trig_data *trig, struct cmdlist_element *cl,
+                             struct cmdlist_element *got, int depth_before,
+                             char *result)
+{
+  struct cmdlist_element *want;
+  int depth_got = GET_TRIG_DEPTH(trig);
+
+  dg_replaying = true;
+  dg_replay_failed = false;
+  dg_replay_pos = 0;
+  GET_TRIG_DEPTH(trig) = depth_before;
+
+  if (result)
+    want = find_case(trig, cl, NULL, NULL, 0, result);
+  else
+    want = find_else_end(trig, cl, NULL, NULL, 0);
+
+  if (want != got || GET_TRIG_DEPTH(trig) != depth_got || dg_replay_failed ||
+      dg_replay_pos != dg_conds.size())
+    dg_mismatch(trig, cl, result ? "switch" : "if");
+
+  dg_replaying = false;
+  dg_conds.clear();
+  GET_TRIG_DEPTH(trig) = depth_got;
+}
+
+
+/* Every if and switch of a trigger, taken with no condition true. */
+static void dg_verify_arms(trig_data *trig)
+{
+  struct cmdlist_element *cl, *c;
+  int depth = GET_TRIG_DEPTH(trig);
+  bool is_case;
+
+  for (cl = trig->cmdlist; cl; cl = cl->next) {
+    dg_verify_line(trig, cl);
+    if (cl->op != DG_OP_IF && cl->op != DG_OP_SWITCH)
+      continue;
+
+    is_case = (cl->op == DG_OP_SWITCH);
+    dg_conds.clear();
+    for (c = cl; c->arm_how == DG_ARM_ELSEIF || c->arm_how == DG_ARM_CASE; c = c->arm)
+      dg_conds.emplace_back(c->arm, FALSE);
+    GET_TRIG_DEPTH(trig) = depth + (c->arm_how == DG_ARM_ELSE);
+    dg_verify_branch(trig, cl, c->arm, depth, is_case ? (char *) "" : NULL);
+  }
+
+  GET_TRIG_DEPTH(trig) = depth;
+}
+
+
+ACMD(do_tverify)
+{
+  char arg[MAX_INPUT_LENGTH];
+  unsigned long before;
+  int i;
+
+  one_argument(argument, arg);
+
+  if (!strcasecmp(arg, "on") || !strcasecmp(arg, "off")) {
+    dg_verify_compiled = !strcasecmp(arg, "on");
+    dg_verified = dg_mismatches = 0;
+    send_to_char(ch, "Running triggers will %sbe checked against their text.\r\n",
+                 dg_verify_compiled ? "" : "no longer ");
+    return;
+  } else if (*arg) {
+    send_to_char(ch, "Usage: tverify [on | off]\r\n");
+    return;
+  }
+
+  if (dg_verify_compiled)
+    send_to_char(ch, "Running triggers: %lu lines checked, %lu differences.\r\n",
+                 dg_verified, dg_mismatches);
+
+  before = dg_mismatches;
+  for (i = 0; i < top_of_trigt; i++)
+    if (trig_index[i]->proto && trig_index[i]->proto->cmdlist)
+      dg_verify_arms(trig_index[i]->proto);
+
+  send_to_char(ch, "Checked the compiled form of %d triggers: %lu difference%s (see the script log).\r\n",
+               top_of_trigt, dg_mismatches - before, dg_mismatches - before == 1 ? "" : "s");
+}
+
+
 /* read a line in from a file, return the number of chars read */
 int fgetline(FILE *file, char *p)
 {
@@ -2880,7 +3398,7 @@ void read_saved_vars(struct char_data *ch)
   /* create the space for the script structure which holds the vars */
   /* We need to do this first, because later calls to 'remote' will need */
   /* a script already assigned. */
-  CREATE(SCRIPT(ch), struct script_data, 1);
+  POOL_CREATE(SCRIPT(ch), struct script_data, script_pool);
 
   /* find the file that holds the saved variables and open it*/
   get_filename(fn, sizeof(fn), SCRIPT_VARS_FILE, GET_NAME(ch));
@@ -2967,7 +3485,7 @@ void read_saved_vars_ascii(FILE *file, struct char_data *ch, int count)
   /* create the space for the script structure which holds the vars */
   /* We need to do this first, because later calls to 'remote' will need */
   /* a script already assigned. */
-  CREATE(SCRIPT(ch), struct script_data, 1);
+  POOL_CREATE(SCRIPT(ch), struct script_data, script_pool);
 
   /* walk through each line in the file parsing variables */
   for (i = 0; i < count; i++)
@@ -3017,76 +3535,156 @@ void save_char_vars_ascii(FILE *file, struct char_data *ch)
 
 /* find_char() helpers */
 
-// Must be power of 2
-#define BUCKET_COUNT 64
-// to recognize an empty bucket
-#define UID_OUT_OF_RANGE 1000000000
+/*
+ * UIDs map to their char or obj through an open-addressing hash table
+ * with Robin Hood probing: an entry being placed takes the slot of any
+ * entry closer to its home slot than it is, so probe lengths stay short
+ * and even, and a lookup can stop as soon as it passes the distance the
+ * wanted UID could be at.  Removal shifts the following entries back
+ * instead of leaving tombstones.  The table doubles past
+ * LOOKUP_MAX_LOAD percent full.
+ */
+
+/* Must be power of 2 */
+#define LOOKUP_INITIAL_SIZE	1024
+#define LOOKUP_MAX_LOAD		80	/* percent				*/
+
+#define UID_TYPE_CHAR	1
+#define UID_TYPE_OBJ	2
 
 struct lookup_table_t {
   long uid;
-  void * c;
-  struct lookup_table_t *next;
+  void *c;		/* NULL if the slot is empty		*/
+  int type;		/* UID_TYPE_CHAR or UID_TYPE_OBJ	*/
 };
-struct lookup_table_t lookup_table[BUCKET_COUNT];
 
-void init_lookup_table(void)
+static struct lookup_table_t *lookup_table = NULL;
+static unsigned int lookup_size = 0, lookup_count = 0, lookup_shift = 64;
+static unsigned long lookup_misses = 0;
+
+static unsigned int lookup_home(long uid)
 {
-  int i;
-  for (i = 0; i < BUCKET_COUNT; i++) {
-    lookup_table[i].uid  = UID_OUT_OF_RANGE;
-    lookup_table[i].c    = NULL;
-    lookup_table[i].next = NULL;
+  /* Fibonacci hashing spreads the sequential UIDs over the whole table. */
+  return (unsigned int) (((unsigned long long) uid * 11400714819323198485ULL) >> lookup_shift);
+}
+
+static unsigned int lookup_dist(unsigned int slot)
+{
+  return (slot - lookup_home(lookup_table[slot].uid)) & (lookup_size - 1);
+}
+
+/* Place an entry known not to be in the table already. */
+static void lookup_place(struct lookup_table_t ent)
+{
+  unsigned int slot = lookup_home(ent.uid), dist = 0, d;
+  struct lookup_table_t tmp;
+
+  for (;; slot = (slot + 1) & (lookup_size - 1), dist++) {
+    if (!lookup_table[slot].c) {
+      lookup_table[slot] = ent;
+      return;
+    }
+    if ((d = lookup_dist(slot)) < dist) {
+      tmp = lookup_table[slot];
+      lookup_table[slot] = ent;
+      ent = tmp;
+      dist = d;
+    }
   }
 }
 
-struct char_data *find_char_by_uid_in_lookup_table(long uid)
+static void lookup_resize(unsigned int size)
+{
+  struct lookup_table_t *old = lookup_table;
+  unsigned int i, old_size = lookup_size;
+
+  CREATE(lookup_table, struct lookup_table_t, size);
+  lookup_size = size;
+  for (lookup_shift = 64; size > 1; size >>= 1)
+    lookup_shift--;
+
+  for (i = 0; i < old_size; i++)
+    if (old[i].c)
+      lookup_place(old[i]);
+
+  if (old)
+    free(old);
+}
+
+static int lookup_find(long uid)
 {
-  int bucket = (int) (uid & (BUCKET_COUNT - 1));
-  struct lookup_table_t *lt = &lookup_table[bucket];
+  unsigned int slot, dist;
 
-  for (;lt && lt->uid != uid ; lt = lt->next) ;
+  if (!lookup_size)
+    return (-1);
+  slot = lookup_home(uid);
 
-  if (lt)
-    return (struct char_data *)(lt->c);
+  for (dist = 0; lookup_table[slot].c; slot = (slot + 1) & (lookup_size - 1), dist++) {
+    if (lookup_table[slot].uid == uid)
+      return (slot);
+    if (lookup_dist(slot) < dist)
+      break;
+  }
+
+  return (-1);
+}
 
-  log("find_char_by_uid_in_lookup_table : No entity with number %ld in lookup table", uid);
+void init_lookup_table(void)
+{
+  if (!lookup_size)
+    lookup_resize(LOOKUP_INITIAL_SIZE);
+}
+
+struct char_data *find_char_by_uid_in_lookup_table(long uid)
+{
+  int slot = lookup_find(uid);
+
+  if (slot >= 0 && lookup_table[slot].type == UID_TYPE_CHAR)
+    return (struct char_data *)(lookup_table[slot].c);
+
+  lookup_misses++;
   return NULL;
 }
 
 struct obj_data *find_obj_by_uid_in_lookup_table(long uid)
 {
-  int bucket = (int) (uid & (BUCKET_COUNT - 1));
-  struct lookup_table_t *lt = &lookup_table[bucket];
+  int slot = lookup_find(uid);
 
-  for (;lt && lt->uid != uid ; lt = lt->next) ;
+  if (slot >= 0 && lookup_table[slot].type == UID_TYPE_OBJ)
+    return (struct obj_data *)(lookup_table[slot].c);
 
-  if (lt)
-    return (struct obj_data *)(lt->c);
-
-  log("find_obj_by_uid_in_lookup_table : No entity with number %ld in lookup table", uid);
+  lookup_misses++;
   return NULL;
 }
 
 void add_to_lookup_table(long uid, void *c)
 {
-  int bucket = (int) (uid & (BUCKET_COUNT - 1));
-  struct lookup_table_t *lt = &lookup_table[bucket];
+  struct lookup_table_t ent;
+  int slot;
 
-  for (;lt->next; lt = lt->next)
-  if (lt->c == c && lt->uid == uid) {
-      log ("Add_to_lookup failed. Already there. (uid = %ld)", uid);
-      return;
-    }
+  ent.uid = uid;
+  ent.c = c;
+  ent.type = (uid >= OBJ_ID_BASE ? UID_TYPE_OBJ : UID_TYPE_CHAR);
+
+  /* A UID names one thing; re-adding it just points it at the new one. */
+  if ((slot = lookup_find(uid)) >= 0) {
+    lookup_table[slot] = ent;
+    return;
+  }
+
+  if (!lookup_size)
+    init_lookup_table();
+  else if ((lookup_count + 1) * 100 > lookup_size * LOOKUP_MAX_LOAD)
+    lookup_resize(lookup_size * 2);
 
-  CREATE(lt->next, struct lookup_table_t, 1);
-  lt->next->uid = uid;
-  lt->next->c = c;
+  lookup_place(ent);
+  lookup_count++;
 }
 
 void remove_from_lookup_table(long uid)
 {
-  int bucket = (int) (uid & (BUCKET_COUNT - 1));
-  struct lookup_table_t *lt = &lookup_table[bucket], *flt = NULL;
+  unsigned int next;
+  int slot;
 
   /*
    * This is not supposed to happen. UID 0 is not used.
@@ -3097,19 +3695,41 @@ void remove_from_lookup_table(long uid)
   if (uid == 0)
     return;
 
-  for (;lt;lt = lt->next)
-    if (lt->uid == uid)
-      flt = lt;
-
-  if (flt) {
-    for (lt = &lookup_table[bucket];lt->next != flt;lt = lt->next)
-      ;
-    lt->next = flt->next;
-    free(flt);
+  if ((slot = lookup_find(uid)) < 0) {
+    log("remove_from_lookup. UID %ld not found.", uid);
     return;
   }
 
-  log("remove_from_lookup. UID %ld not found.", uid);
+  /* Pull the rest of the run back a slot over the hole. */
+  for (next = (slot + 1) & (lookup_size - 1); lookup_table[next].c && lookup_dist(next) > 0;
+       next = (next + 1) & (lookup_size - 1)) {
+    lookup_table[slot] = lookup_table[next];
+    slot = next;
+  }
+
+  lookup_table[slot].c = NULL;
+  lookup_table[slot].uid = 0;
+  lookup_count--;
+}
+
+/* For 'show stats': how full the UID table is and how far lookups probe. */
+void lookup_table_stats(int *entries, int *slots, int *max_probe, double *avg_probe, unsigned long *misses)
+{
+  unsigned int i, d, longest = 0;
+  unsigned long long total = 0;
+
+  for (i = 0; i < lookup_size; i++)
+    if (lookup_table[i].c) {
+      d = lookup_dist(i);
+      total += d;
+      longest = MAX(longest, d);
+    }
+
+  *entries = lookup_count;
+  *slots = lookup_size;
+  *max_probe = longest + 1;
+  *avg_probe = lookup_count ? 1.0 + (double) total / lookup_count : 0.0;
+  *misses = lookup_misses;
 }
 
 int check_flags_by_name_ar(int *array, int numflags, char *search, const char *namelist[])
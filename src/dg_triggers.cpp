@@ -221,6 +221,9 @@ int greet_mtrigger(char_data *actor, int dir)
   char buf[MAX_INPUT_LENGTH];
   int intermediate, final=TRUE;
 
+  if (!ROOM_MTRIG_CHECK(IN_ROOM(actor), MTRIG_GREET | MTRIG_GREET_ALL))
+    return TRUE;
+
   if (!valid_dg_target(actor, DG_ALLOW_GODS))
     return TRUE;
 
@@ -317,6 +320,9 @@ int command_mtrigger(char_data *actor, char *cmd, char *argument)
   trig_data *t;
   char buf[MAX_INPUT_LENGTH];
 
+  if (!ROOM_MTRIG_CHECK(IN_ROOM(actor), MTRIG_COMMAND))
+    return 0;
+
   /* prevent people we like from becoming trapped :P */
   if (!valid_dg_target(actor, 0))
     return 0;
@@ -361,6 +367,9 @@ void speech_mtrigger(char_data *actor, char *str)
   trig_data *t;
   char buf[MAX_INPUT_LENGTH];
 
+  if (!ROOM_MTRIG_CHECK(IN_ROOM(actor), MTRIG_SPEECH))
+    return;
+
   for (ch = world[IN_ROOM(actor)].people; ch; ch = ch_next)
   {
     ch_next = ch->next_in_room;
@@ -582,6 +591,9 @@ int leave_mtrigger(char_data *actor, int dir)
   char_data *ch;
   char buf[MAX_INPUT_LENGTH];
 
+  if (!ROOM_MTRIG_CHECK(IN_ROOM(actor), MTRIG_LEAVE))
+    return 1;
+
   if (!valid_dg_target(actor, DG_ALLOW_GODS))
     return 1;
 
@@ -765,6 +777,10 @@ int command_otrigger(char_data *actor, char *cmd, char *argument)
   obj_data *obj;
   int i;
 
+  /* the actor's own things are counted in the room too */
+  if (!ROOM_OTRIG_CHECK(IN_ROOM(actor), OTRIG_COMMAND))
+    return 0;
+
   /* prevent people we like from becoming trapped :P */
   if (!valid_dg_target(actor, 0))
     return 0;
@@ -954,6 +970,9 @@ int leave_otrigger(room_data *room, char_data *actor, int dir)
   int temp, final = 1;
   obj_data *obj, *obj_next;
 
+  if (!IS_SET(room->trig.obj_types, OTRIG_LEAVE))
+    return 1;
+
   if (!valid_dg_target(actor, DG_ALLOW_GODS))
     return 1;
 
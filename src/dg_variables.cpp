@@ -22,9 +22,140 @@
 #include "oasis.h"
 #include "class.h"
 #include "races.h"
+#include "keywords.h"
+#include "profile.h"
 
 /* Utility functions */
 
+/*
+ * Variable lists stay plain linked lists, newest first, so vstat and
+ * save_char_vars() see them in the same order as ever.  But a mob with a
+ * long quest history can carry hundreds of globals, and every %var%,
+ * remote and rdelete walked them all comparing names.  So once a list
+ * reaches VAR_INDEX_MIN vars, its head carries a var_index: the vars by
+ * name, each name's vars in list order.  The same name can be on a list
+ * more than once, under different contexts.  The index moves along when
+ * the head changes, and goes away when the list shrinks to half that.
+ */
+#define VAR_INDEX_MIN	16
+
+struct var_name_hash {
+  using is_transparent = void;
+  size_t operator()(std::string_view name) const
+  {
+    size_t h = 2166136261u;
+
+    for (char c : name)
+      h = (h ^ (unsigned char) LOWER(c)) * 16777619u;
+    return (h);
+  }
+};
+
+struct var_name_eq {
+  using is_transparent = void;
+  bool operator()(std::string_view a, std::string_view b) const
+  {
+    return (a.size() == b.size() && !strncasecmp(a.data(), b.data(), a.size()));
+  }
+};
+
+struct var_index {
+  std::unordered_map<std::string, std::vector<struct trig_var_data *>, var_name_hash, var_name_eq> names;
+  int count;				/* vars on the list		*/
+};
+
+
+static void build_var_index(struct trig_var_data *var_list)
+{
+  struct var_index *idx = new var_index();
+  struct trig_var_data *vd;
+
+  for (vd = var_list; vd; vd = vd->next) {
+    idx->names[vd->name].push_back(vd);
+    idx->count++;
+  }
+  var_list->index = idx;
+}
+
+
+void free_var_index(struct trig_var_data *var_list)
+{
+  if (var_list && var_list->index) {
+    delete var_list->index;
+    var_list->index = NULL;
+  }
+}
+
+
+/* The first var called 'name' on the list. */
+struct trig_var_data *find_var(struct trig_var_data *var_list, const char *name)
+{
+  struct trig_var_data *vd;
+
+  if (var_list && var_list->index) {
+    auto found = var_list->index->names.find(std::string_view(name));
+    return (found == var_list->index->names.end() ? NULL : found->second.front());
+  }
+
+  for (vd = var_list; vd && strcasecmp(vd->name, name); vd = vd->next);
+  return (vd);
+}
+
+
+/* The first var called 'name' on the list that's global or in 'context'. */
+struct trig_var_data *find_var_in_context(struct trig_var_data *var_list, const char *name, long context)
+{
+  struct trig_var_data *vd;
+
+  if (var_list && var_list->index) {
+    auto found = var_list->index->names.find(std::string_view(name));
+    if (found != var_list->index->names.end())
+      for (auto v : found->second)
+        if (v->context == 0 || v->context == context)
+          return (v);
+    return (NULL);
+  }
+
+  for (vd = var_list; vd; vd = vd->next)
+    if (!strcasecmp(vd->name, name) &&
+        (vd->context==0 || vd->context==context))
+      break;
+  return (vd);
+}
+
+
+/* Take 'vd' off the list and free it. */
+void delete_var(struct trig_var_data **var_list, struct trig_var_data *vd)
+{
+  struct var_index *idx = (*var_list)->index;
+  struct trig_var_data *prev;
+
+  if (vd == *var_list) {
+    *var_list = vd->next;
+    vd->index = NULL;
+    if (*var_list)
+      (*var_list)->index = idx;
+  } else {
+    for (prev = *var_list; prev->next != vd; prev = prev->next);
+    prev->next = vd->next;
+  }
+
+  if (idx) {
+    auto found = idx->names.find(std::string_view(vd->name));
+    found->second.erase(std::find(found->second.begin(), found->second.end(), vd));
+    if (found->second.empty())
+      idx->names.erase(found);
+    if (--idx->count < VAR_INDEX_MIN / 2) {
+      delete idx;
+      if (*var_list)
+        (*var_list)->index = NULL;
+    }
+  }
+
+  free_var_el(vd);
+}
+
+
 /*
  * Thanks to James Long for his assistance in plugging the memory leak
  * that used to be here.   -- Welcor
@@ -32,14 +163,20 @@
 /* adds a variable with given name and value to trigger */
 void add_var(struct trig_var_data **var_list, char *name, const char *value, long id)
 {
+  struct var_index *idx = *var_list ? (*var_list)->index : NULL;
   struct trig_var_data *vd;
+  int length = 0;
 
   if (strchr(name, '.')) {
     log("add_var() : Attempt to add illegal var: %s", name);
     return;
   }
 
-  for (vd = *var_list; vd && strcasecmp(vd->name, name); vd = vd->next);
+  if (idx)
+    vd = find_var(*var_list, name);
+  else
+    for (vd = *var_list; vd && strcasecmp(vd->name, name); vd = vd->next)
+      length++;
 
   if (vd && (!vd->context || vd->context==id)) {
     free(vd->value);
@@ -57,6 +194,15 @@ void add_var(struct trig_var_data **var_list, char *name, const char *value, lon
     vd->next = *var_list;
     vd->context = id;
     *var_list = vd;
+
+    if (idx) {
+      vd->next->index = NULL;
+      vd->index = idx;
+      auto &same = idx->names[vd->name];
+      same.insert(same.begin(), vd);
+      idx->count++;
+    } else if (length + 1 >= VAR_INDEX_MIN)
+      build_var_index(vd);
   }
 
   strcpy(vd->value, value);                            /* strcpy: ok*/
@@ -114,7 +260,7 @@ int item_in_list(char *item, obj_data *list)
     }
   } else {
     for (i = list; i; i = i->next_content) {
-      if (isname(item, i->name))
+      if (isname_obj(item, i))
         count++;
       if (GET_OBJ_TYPE(i) == ITEM_CONTAINER)
         count += item_in_list(item, i->contains);
@@ -133,93 +279,1527 @@ int item_in_list(char *item, obj_data *list)
    MUD -- 4dimensions.org:6000
 */
 
-int char_has_item(char *item, struct char_data *ch)
+int char_has_item(char *item, struct char_data *ch)
+{
+
+  /* If this works, no more searching needed */
+  if (get_object_in_equip(ch, item) != NULL)
+    return 1;
+
+  if (item_in_list(item, ch->carrying) == 0)
+    return 0;
+  else
+    return 1;
+}
+
+/*
+ * Looking up a %var.field% used to mean a chain of strcasecmp()s, up to
+ * a hundred or so for a field near the end.  Now each kind of thing (text,
+ * char, obj, room) has a table of its fields and their handlers, and each
+ * table has a perfect hash worked out by the compiler: the first seed for
+ * which every name in the table lands in a slot of its own.  A lookup is
+ * one hash, one compare against the only name that could be in that slot,
+ * and a call.  A name listed twice in a table will never get a seed, so
+ * it won't compile.
+ */
+#define DG_FIELD_ARGS	void *go, int type, char_data *c, obj_data *o, \
+			struct room_data *r, struct trig_var_data *vd, \
+			char *subfield, char *str, size_t slen
+#define DG_FIELD(name)	static void (name)(DG_FIELD_ARGS)
+
+typedef void (*dg_field_func)(DG_FIELD_ARGS);
+
+struct dg_field {
+  const char *name;
+  dg_field_func func;
+};
+
+/* Room for eight times the fields keeps the search for a seed short. */
+static constexpr size_t dg_field_slots(size_t fields)
+{
+  size_t slots = 1;
+
+  while (slots < 8 * fields)
+    slots <<= 1;
+  return (slots);
+}
+
+template <size_t N> struct dg_field_index {
+  static constexpr size_t slots = dg_field_slots(N);
+  unsigned int seed;
+  unsigned char slot[slots];	/* 1 + the field's place in the table, or 0 */
+};
+
+
+/* FNV-1a of the lower cased name, started from the seed. */
+static constexpr unsigned int dg_field_hash(const char *name, unsigned int seed)
+{
+  unsigned int h = 2166136261u ^ (seed * 0x9e3779b9u);
+
+  for (; *name; name++) {
+    h ^= (unsigned char) LOWER(*name);
+    h *= 16777619u;
+  }
+  return (h ^ (h >> 15));
+}
+
+
+template <size_t N> static constexpr struct dg_field_index<N> dg_field_index_build(const struct dg_field (&fields)[N])
+{
+  struct dg_field_index<N> idx = {};
+  size_t i;
+
+  static_assert(N < 256, "dg_field_index only has room for 255 fields");
+
+  for (idx.seed = 1; ; idx.seed++) {
+    for (auto &s : idx.slot)
+      s = 0;
+    for (i = 0; i < N; i++) {
+      unsigned char &s = idx.slot[dg_field_hash(fields[i].name, idx.seed) & (idx.slots - 1)];
+      if (s)
+        break;
+      s = i + 1;
+    }
+    if (i == N)
+      return (idx);
+  }
+}
+
+
+template <size_t N> static dg_field_func dg_field_find(const struct dg_field (&fields)[N],
+                      const struct dg_field_index<N> &idx, const char *name)
+{
+  int i = idx.slot[dg_field_hash(name, idx.seed) & (idx.slots - 1)];
+
+  if (i && !strcasecmp(fields[i - 1].name, name))
+    return (fields[i - 1].func);
+  return (NULL);
+}
+
+
+DG_FIELD(textfield_strlen)
+{
+  char limit[200];
+
+  sprintf(limit, "%"SZT, strlen(vd->value));
+  snprintf(str, slen, "%d", atoi(limit));
+}
+
+
+/* trim whitespace from ends */
+DG_FIELD(textfield_trim)
+{
+  char tmpvar[MAX_STRING_LENGTH];
+  char *p, *p2;
+
+  snprintf(tmpvar, sizeof(tmpvar)-1 , "%s", vd->value); /* -1 to use later*/
+  p = tmpvar;
+  p2 = tmpvar + strlen(tmpvar) - 1;
+  while (*p && isspace(*p)) p++;
+  while ((p<=p2) && isspace(*p2)) p2--;
+  if (p>p2) { /* nothing left */
+    *str = '\0';
+    return;
+  }
+  *(++p2) = '\0';                                         /* +1 ok (see above) */
+  snprintf(str, slen, "%s", p);
+}
+
+
+DG_FIELD(textfield_contains)
+{
+  if (str_str(vd->value, subfield))
+    strcpy(str, "1");
+  else
+    strcpy(str, "0");
+}
+
+
+DG_FIELD(textfield_car)
+{
+  char *car = vd->value;
+
+  while (*car && !isspace(*car))
+    *str++ = *car++;
+  *str = '\0';
+}
+
+
+DG_FIELD(textfield_cdr)
+{
+  char *cdr = vd->value;
+
+  while (*cdr && !isspace(*cdr)) cdr++; /* skip 1st field */
+  while (*cdr && isspace(*cdr)) cdr++;  /* skip to next */
+
+  snprintf(str, slen, "%s", cdr);
+}
+
+
+DG_FIELD(textfield_charat)
+{
+  size_t len = strlen(vd->value), dgindex = atoi(subfield);
+
+  if (dgindex > len || dgindex < 1)
+    strcpy(str, "");
+  else
+    snprintf(str, slen, "%c", vd->value[dgindex - 1]);
+}
+
+
+/* find the mud command returned from this text */
+DG_FIELD(textfield_mudcommand)
+{
+/* NOTE: you may need to replace "cmd_info" with "complete_cmd_info", */
+/* depending on what patches you've got applied.                      */
+  extern const struct command_info cmd_info[];
+/* on older source bases:    extern struct command_info *cmd_info; */
+  int length, cmd;
+
+  for (length = strlen(vd->value), cmd = 0;
+       *cmd_info[cmd].command != '\n'; cmd++)
+    if (!strncmp(cmd_info[cmd].command, vd->value, length))
+      break;
+
+  if (*cmd_info[cmd].command == '\n')
+    *str = '\0';
+  else
+    snprintf(str, slen, "%s", cmd_info[cmd].command);
+}
+
+
+static constexpr struct dg_field text_fields[] = {
+  { "strlen",		textfield_strlen },
+  { "trim",		textfield_trim },
+  { "contains",		textfield_contains },
+  { "car",		textfield_car },
+  { "cdr",		textfield_cdr },
+  { "charat",		textfield_charat },
+  { "mudcommand",	textfield_mudcommand },
+};
+static constexpr auto text_field_index = dg_field_index_build(text_fields);
+
+
+int text_processed(char *field, char *subfield, struct trig_var_data *vd,
+                   char *str, size_t slen)
+{
+  dg_field_func func = dg_field_find(text_fields, text_field_index, field);
+
+  if (!func)
+    return FALSE;
+
+  func(NULL, 0, NULL, NULL, NULL, vd, subfield, str, slen);
+  return TRUE;
+}
+
+
+DG_FIELD(charfield_aaaaa)
+{
+  strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_affect)
+{
+  if (subfield && *subfield) {
+    int affect = get_flag_by_name(affected_bits, subfield);
+    if (affect != NOFLAG && AFF_FLAGGED(c, affect))
+      strcpy(str, "1");
+    else
+      strcpy(str, "0");
+  } else
+    strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_alias)
+{
+  snprintf(str, slen, "%s", GET_PC_NAME(c));
+}
+
+
+DG_FIELD(charfield_align)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_ALIGNMENT(c) = MAX(-1000, MIN(addition, 1000));
+  }
+  snprintf(str, slen, "%d", GET_ALIGNMENT(c));
+}
+
+
+DG_FIELD(charfield_bank)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_BANK_GOLD(c) += addition;
+  }
+  snprintf(str, slen, "%d", GET_GOLD(c));
+}
+
+
+DG_FIELD(charfield_canbeseen)
+{
+  if ((type == MOB_TRIGGER) && !CAN_SEE(((char_data *)go), c))
+    strcpy(str, "0");
+  else
+    strcpy(str, "1");
+}
+
+
+DG_FIELD(charfield_carry)
+{
+  if (!IS_NPC(c) && CARRYING(c))
+   strcpy(str, "1");
+  else
+   strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_clan)
+{
+  if (GET_CLAN(c) != NULL && strstr(GET_CLAN(c), subfield))
+   strcpy(str, "1");
+  else
+   strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_class)
+{
+  if (!IS_NPC(c))
+   snprintf(str, slen, "%s", c->chclass->getName().c_str());
+  else
+   snprintf(str, slen, "blank");
+}
+
+
+DG_FIELD(charfield_con)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    int max = 100;
+    GET_CON(c) += addition;
+    if (GET_CON(c) > max) GET_CON(c) = max;
+    if (GET_CON(c) < 3) GET_CON(c) = 3;
+  }
+  snprintf(str, slen, "%d", GET_CON(c));
+}
+
+
+DG_FIELD(charfield_cha)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    int max = 100;
+    GET_CHA(c) += addition;
+    if (GET_CHA(c) > max) GET_CHA(c) = max;
+    if (GET_CHA(c) < 3) GET_CHA(c) = 3;
+  }
+  snprintf(str, slen, "%d", GET_CHA(c));
+}
+
+
+DG_FIELD(charfield_dead)
+{
+  if (AFF_FLAGGED(c, AFF_SPIRIT))
+   strcpy(str, "1");
+  else
+   strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_death)
+{
+  snprintf(str, slen, "%ld", GET_DTIME(c));
+}
+
+
+DG_FIELD(charfield_dex)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    int max = 100;
+    GET_DEX(c) += addition;
+    if (GET_DEX(c) > max) GET_DEX(c) = max;
+    if (GET_DEX(c) < 3) GET_DEX(c) = 3;
+  }
+  snprintf(str, slen, "%d", GET_DEX(c));
+}
+
+
+DG_FIELD(charfield_drag)
+{
+  if (!IS_NPC(c) && DRAGGING(c))
+   strcpy(str, "1");
+  else
+   strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_drunk)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_COND(c, DRUNK) = MAX(-1, MIN(addition, 24));
+  }
+  snprintf(str, slen, "%d", GET_COND(c, DRUNK));
+}
+
+
+DG_FIELD(charfield_eq)
+{
+  int pos, i, j;
+
+  if (!subfield || !*subfield)
+    *str = '\0';
+  else if (*subfield == '*') {
+    for (i = 0, j = 0; i < NUM_WEARS; i++)
+      if (GET_EQ(c, i)) {
+        j++;
+        break;
+      }
+    if (j > 0)
+      strcpy(str,"1");
+    else
+      *str = '\0';
+  } else if ((pos = find_eq_pos_script(subfield)) < 0 || !GET_EQ(c, pos))
+    *str = '\0';
+  else
+    snprintf(str, slen, "%c%d",UID_CHAR, GET_ID(GET_EQ(c, pos)));
+}
+
+
+DG_FIELD(charfield_exp)
+{
+  if (subfield && *subfield) {
+    int64_t addition = MIN(atoll(subfield), 2100000000);
+
+    gain_exp(c, addition);
+  }
+  snprintf(str, slen, "%" I64T "", GET_EXP(c));
+}
+
+
+DG_FIELD(charfield_fighting)
+{
+  if (FIGHTING(c))
+    snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(FIGHTING(c)));
+  else
+    *str = '\0';
+}
+
+
+DG_FIELD(charfield_flying)
+{
+  if (AFF_FLAGGED(c, AFF_FLYING))
+    strcpy(str, "1");
+  else
+    strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_follower)
+{
+  if (!c->followers || !c->followers->follower)
+    *str = '\0';
+  else
+    snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(c->followers->follower));
+}
+
+
+DG_FIELD(charfield_gold)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_GOLD(c) += addition;
+  }
+  snprintf(str, slen, "%d", GET_GOLD(c));
+}
+
+
+DG_FIELD(charfield_has_item)
+{
+  if (!(subfield && *subfield))
+    *str = '\0';
+  else
+    snprintf(str, slen, "%d", char_has_item(subfield, c));
+}
+
+
+DG_FIELD(charfield_hisher)
+{
+  snprintf(str, slen, "%s", HSHR(c));
+}
+
+
+DG_FIELD(charfield_heshe)
+{
+  snprintf(str, slen, "%s", HSSH(c));
+}
+
+
+DG_FIELD(charfield_himher)
+{
+  snprintf(str, slen, "%s", HMHR(c));
+}
+
+
+DG_FIELD(charfield_hitp)
+{
+  if (subfield && *subfield) {
+    int64_t addition = atoll(subfield);
+    if(addition > 0 ) {
+        c->incCurHealth(addition);
+    } else {
+        c->decCurHealth(addition);
+    }
+
+    update_pos(c);
+  }
+  snprintf(str, slen, "%" I64T "", GET_HIT(c));
+}
+
+
+DG_FIELD(charfield_hunger)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_COND(c, HUNGER) = MAX(-1, MIN(addition, 24));
+  }
+  snprintf(str, slen, "%d", GET_COND(c, HUNGER));
+}
+
+
+DG_FIELD(charfield_id)
+{
+  snprintf(str, slen, "%d", GET_ID(c));
+}
+
+
+DG_FIELD(charfield_is_pc)
+{
+  if (IS_NPC(c))
+    strcpy(str, "0");
+  else
+    strcpy(str, "1");
+}
+
+
+DG_FIELD(charfield_inventory)
+{
+  struct obj_data *obj;
+
+  if(subfield && *subfield) {
+    for (obj = c->carrying;obj;obj=obj->next_content) {
+      if(GET_OBJ_VNUM(obj)==atoi(subfield)) {
+        snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(obj)); /* arg given, found */
+        return;
+      }
+    }
+    if (!obj)
+      *str = '\0'; /* arg given, not found */
+  } else { /* no arg given */
+    if (c->carrying) {
+      snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(c->carrying));
+    } else {
+      *str = '\0';
+    }
+  }
+}
+
+
+DG_FIELD(charfield_is_killer)
+{
+  if (subfield && *subfield) {
+    if (!strcasecmp("on", subfield))
+      SET_BIT_AR(PLR_FLAGS(c), PLR_KILLER);
+    else if (!strcasecmp("off", subfield))
+      REMOVE_BIT_AR(PLR_FLAGS(c), PLR_KILLER);
+  }
+  if (PLR_FLAGGED(c, PLR_KILLER))
+    strcpy(str, "1");
+  else
+    strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_is_thief)
+{
+  if (subfield && *subfield) {
+    if (!strcasecmp("on", subfield))
+      SET_BIT_AR(PLR_FLAGS(c), PLR_THIEF);
+    else if (!strcasecmp("off", subfield))
+      REMOVE_BIT_AR(PLR_FLAGS(c), PLR_THIEF);
+  }
+  if (PLR_FLAGGED(c, PLR_THIEF))
+    strcpy(str, "1");
+  else
+    strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_int)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    int max = 100;
+    GET_INT(c) += addition;
+    if (GET_INT(c) > max) GET_INT(c) = max;
+    if (GET_INT(c) < 3) GET_INT(c) = 3;
+  }
+  snprintf(str, slen, "%d", GET_INT(c));
+}
+
+
+DG_FIELD(charfield_level)
+{
+  snprintf(str, slen, "%d", GET_LEVEL(c));
+}
+
+
+DG_FIELD(charfield_maxhitp)
+{
+  if (subfield && *subfield) {
+    int64_t addition = atoll(subfield);
+    //GET_MAX_HIT(c) = MAX(GET_MAX_HIT(c) + addition, 1);
+  }
+  snprintf(str, slen, "%" I64T "", GET_MAX_HIT(c));
+}
+
+
+DG_FIELD(charfield_mana)
+{
+  if (subfield && *subfield) {
+    int64_t addition = atoll(subfield);
+    if(addition > 0) {
+        c->incCurKI(addition);
+    } else {
+        c->decCurKI(addition);
+    }
+  }
+  snprintf(str, slen, "%" I64T "", (c->getCurKI()));
+}
+
+
+DG_FIELD(charfield_maxmana)
+{
+  if (subfield && *subfield) {
+    int64_t addition = atoll(subfield);
+    //GET_MAX_MANA(c) = MAX(GET_MAX_MANA(c) + addition, 1);
+  }
+  snprintf(str, slen, "%" I64T "", GET_MAX_MANA(c));
+}
+
+
+DG_FIELD(charfield_move)
+{
+  if (subfield && *subfield) {
+    int64_t addition = atoll(subfield);
+    if(addition > 0) {
+        c->incCurST(addition);
+    } else {
+        c->decCurST(addition);
+    }
+
+  }
+  snprintf(str, slen, "%" I64T "", (c->getCurST()));
+}
+
+
+DG_FIELD(charfield_maxmove)
+{
+  if (subfield && *subfield) {
+    int64_t addition = atoll(subfield);
+    //GET_MAX_MOVE(c) = MAX(GET_MAX_MOVE(c) + addition, 1);
+  }
+  snprintf(str, slen, "%" I64T "", GET_MAX_MOVE(c));
+}
+
+
+DG_FIELD(charfield_master)
+{
+  if (!c->master)
+    *str = '\0';
+  else
+    snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(c->master));
+}
+
+
+DG_FIELD(charfield_name)
+{
+  snprintf(str, slen, "%s", GET_NAME(c));
+}
+
+
+DG_FIELD(charfield_next_in_room)
+{
+  if (c->next_in_room)
+    snprintf(str, slen,"%c%d",UID_CHAR, GET_ID(c->next_in_room));
+  else
+    *str = '\0';
+}
+
+
+DG_FIELD(charfield_pos)
+{
+  int i;
+
+  if (subfield && *subfield) {
+    for (i = POS_SLEEPING; i <= POS_STANDING; i++) {
+      /* allows : Sleeping, Resting, Sitting, Fighting, Standing */
+      if (!strncasecmp(subfield, position_types[i], strlen(subfield))) {
+        GET_POS(c) = i;
+        break;
+      }
+    }
+  }
+  snprintf(str, slen, "%s", position_types[GET_POS(c)]);
+}
+
+
+DG_FIELD(charfield_prac)
+{
+  if (IS_NPC(c)) {
+   if (IN_ROOM(c) != NOWHERE) {
+    send_to_room(IN_ROOM(c), "Error!: Report this trigger error to the coding authorities!\r\n");
+   }
+  }
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_PRACTICES(c, GET_CLASS(c)) = MAX(0, GET_PRACTICES(c, GET_CLASS(c)) + addition);
+  }
+  snprintf(str, slen, "%d", GET_PRACTICES(c, GET_CLASS(c)));
+}
+
+
+DG_FIELD(charfield_plr)
+{
+  if (subfield && *subfield) {
+    int plr = get_flag_by_name(player_bits, subfield);
+    if (plr != NOFLAG && PLR_FLAGGED(c, plr))
+      strcpy(str, "1");
+    else
+      strcpy(str, "0");
+  } else
+    strcpy(str, "0");
+}
+
+
+DG_FIELD(charfield_pref)
+{
+  if (subfield && *subfield) {
+    int pref = get_flag_by_name(preference_bits, subfield);
+    if (pref != NOFLAG && PRF_FLAGGED(c, pref))
+      strcpy(str, "1");
+    else
+      strcpy(str, "0");
+  } else
+    strcpy(str, "0");
+}
+
+
+/* in NOWHERE, return the void */
+DG_FIELD(charfield_room)
+{
+/* see note in dg_scripts.h */
+#ifdef ACTOR_ROOM_IS_UID
+  snprintf(str, slen, "%c%d",UID_CHAR,
+     (IN_ROOM(c)!= NOWHERE) ? world[IN_ROOM(c)].number + ROOM_ID_BASE : ROOM_ID_BASE);
+#else
+  snprintf(str, slen, "%d", (IN_ROOM(c)!= NOWHERE) ? world[IN_ROOM(c)].number : 0);
+#endif
+}
+
+
+#ifdef GET_RACE
+DG_FIELD(charfield_race)
+{
+  snprintf(str, slen, "%s", c->race->getName().c_str());
+}
+#endif
+
+
+DG_FIELD(charfield_rpp)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_RP(c) += addition;
+  }
+
+  snprintf(str, slen, "%d", GET_RP(c));
+}
+
+
+DG_FIELD(charfield_sex)
+{
+  snprintf(str, slen, "%s", genders[(int)GET_SEX(c)]);
+}
+
+
+DG_FIELD(charfield_str)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    int max = 100;
+    GET_STR(c) += addition;
+    if (GET_STR(c) > max) GET_STR(c) = max;
+    if (GET_STR(c) < 3) GET_STR(c) = 3;
+  }
+  snprintf(str, slen, "%d", GET_STR(c));
+}
+
+
+DG_FIELD(charfield_size)
+{
+  if (subfield && *subfield) {
+    int ns;
+    if ((ns = search_block(subfield, size_names, FALSE)) > -1) {
+      (c)->size = ns;
+    }
+  }
+  sprinttype(get_size(c), size_names, str, slen);
+}
+
+
+DG_FIELD(charfield_skill)
+{
+  snprintf(str, slen, "%s", skill_percent(c, subfield));
+}
+
+
+DG_FIELD(charfield_skillset)
+{
+  if (!IS_NPC(c) && subfield && *subfield) {
+    char skillname[MAX_INPUT_LENGTH], *amount;
+    amount = one_word(subfield, skillname);
+    skip_spaces(&amount);
+    if (amount && *amount && is_number(amount)) {
+      int skillnum = find_skill_num(skillname, SKTYPE_SKILL);
+      if (skillnum > 0) {
+        int new_value = MAX(0, MIN(100, atoi(amount)));
+        SET_SKILL(c, skillnum, new_value);
+      }
+    }
+  }
+  *str = '\0'; /* so the parser know we recognize 'skillset' as a field */
+}
+
+
+DG_FIELD(charfield_saving_fortitude)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_SAVE_MOD(c, SAVING_FORTITUDE) += addition;
+  }
+  snprintf(str, slen, "%d", GET_SAVE_MOD(c, SAVING_FORTITUDE));
+}
+
+
+DG_FIELD(charfield_saving_reflex)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_SAVE_MOD(c, SAVING_REFLEX) += addition;
+  }
+  snprintf(str, slen, "%d", GET_SAVE_MOD(c, SAVING_REFLEX));
+}
+
+
+DG_FIELD(charfield_saving_will)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_SAVE_MOD(c, SAVING_WILL) += addition;
+  }
+  snprintf(str, slen, "%d", GET_SAVE_MOD(c, SAVING_WILL));
+}
+
+
+DG_FIELD(charfield_thirst)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_COND(c, THIRST) = MAX(-1, MIN(addition, 24));
+  }
+  snprintf(str, slen, "%d", GET_COND(c, THIRST));
+}
+
+
+DG_FIELD(charfield_tnl)
+{
+  snprintf(str, slen, "%d", level_exp(c, GET_LEVEL(c) + 1));
+}
+
+
+DG_FIELD(charfield_vnum)
+{
+  if (subfield && *subfield) {
+    snprintf(str, slen, "%d", IS_NPC(c) ? (int)(GET_MOB_VNUM(c) == atoi(subfield)) : -1 );
+  } else {
+    if (IS_NPC(c))
+      snprintf(str, slen, "%d", GET_MOB_VNUM(c));
+    else
+    /*
+     * for compatibility with unsigned indexes
+     * - this is deprecated - use %actor.is_pc% to check
+     * instead of %actor.vnum% == -1  --Welcor 09/03
+     */
+      strcpy(str, "-1");
+  }
+}
+
+
+DG_FIELD(charfield_varexists)
+{
+  struct trig_var_data *remote_vd;
+  strcpy(str, "0");
+  if (SCRIPT(c)) {
+    remote_vd = find_var(SCRIPT(c)->global_vars, subfield);
+    if (remote_vd) strcpy(str, "1");
+  }
+}
+
+
+DG_FIELD(charfield_weight)
+{
+  snprintf(str, slen, "%d", GET_WEIGHT(c));
+}
+
+
+DG_FIELD(charfield_wis)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    int max = 100;
+    GET_WIS(c) += addition;
+    if (GET_WIS(c) > max) GET_WIS(c) = max;
+    if (GET_WIS(c) < 3) GET_WIS(c) = 3;
+  }
+  snprintf(str, slen, "%d", GET_WIS(c));
+}
+
+
+DG_FIELD(charfield_zenni)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_GOLD(c) += addition;
+  }
+  snprintf(str, slen, "%d", GET_GOLD(c));
+}
+
+
+static constexpr struct dg_field char_fields[] = {
+  { "aaaaa",		charfield_aaaaa },
+  { "affect",		charfield_affect },
+  { "alias",		charfield_alias },
+  { "align",		charfield_align },
+  { "bank",		charfield_bank },
+  { "canbeseen",	charfield_canbeseen },
+  { "carry",		charfield_carry },
+  { "clan",		charfield_clan },
+  { "class",		charfield_class },
+  { "con",		charfield_con },
+  { "cha",		charfield_cha },
+  { "dead",		charfield_dead },
+  { "death",		charfield_death },
+  { "dex",		charfield_dex },
+  { "drag",		charfield_drag },
+  { "drunk",		charfield_drunk },
+  { "eq",		charfield_eq },
+  { "exp",		charfield_exp },
+  { "fighting",		charfield_fighting },
+  { "flying",		charfield_flying },
+  { "follower",		charfield_follower },
+  { "gold",		charfield_gold },
+  { "has_item",		charfield_has_item },
+  { "hisher",		charfield_hisher },
+  { "heshe",		charfield_heshe },
+  { "himher",		charfield_himher },
+  { "hitp",		charfield_hitp },
+  { "hunger",		charfield_hunger },
+  { "id",		charfield_id },
+  { "is_pc",		charfield_is_pc },
+  { "inventory",	charfield_inventory },
+  { "is_killer",	charfield_is_killer },
+  { "is_thief",		charfield_is_thief },
+  { "int",		charfield_int },
+  { "level",		charfield_level },
+  { "maxhitp",		charfield_maxhitp },
+  { "mana",		charfield_mana },
+  { "maxmana",		charfield_maxmana },
+  { "move",		charfield_move },
+  { "maxmove",		charfield_maxmove },
+  { "master",		charfield_master },
+  { "name",		charfield_name },
+  { "next_in_room",	charfield_next_in_room },
+  { "pos",		charfield_pos },
+  { "prac",		charfield_prac },
+  { "plr",		charfield_plr },
+  { "pref",		charfield_pref },
+  { "room",		charfield_room },
+#ifdef GET_RACE
+  { "race",		charfield_race },
+#endif
+  { "rpp",		charfield_rpp },
+  { "sex",		charfield_sex },
+  { "str",		charfield_str },
+  { "size",		charfield_size },
+  { "skill",		charfield_skill },
+  { "skillset",		charfield_skillset },
+  { "saving_fortitude",	charfield_saving_fortitude },
+  { "saving_reflex",	charfield_saving_reflex },
+  { "saving_will",	charfield_saving_will },
+  { "thirst",		charfield_thirst },
+  { "tnl",		charfield_tnl },
+  { "vnum",		charfield_vnum },
+  { "varexists",	charfield_varexists },
+  { "weight",		charfield_weight },
+  { "wis",		charfield_wis },
+  { "zenni",		charfield_zenni },
+};
+static constexpr auto char_field_index = dg_field_index_build(char_fields);
+
+
+DG_FIELD(objfield_affects)
+{
+  if (subfield && *subfield) {
+    if (check_flags_by_name_ar(GET_OBJ_PERM(o), NUM_AFF_FLAGS, subfield, affected_bits) > 0)
+      snprintf(str, slen, "1");
+    else
+      snprintf(str, slen, "0");
+  } else
+    snprintf(str, slen, "0");
+}
+
+
+DG_FIELD(objfield_cost)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_OBJ_COST(o) = MAX(0, addition + GET_OBJ_COST(o));
+  }
+  snprintf(str, slen, "%d", GET_OBJ_COST(o));
+}
+
+
+DG_FIELD(objfield_cost_per_day)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_OBJ_RENT(o) = MAX(0, addition + GET_OBJ_RENT(o));
+  }
+  snprintf(str, slen, "%d", GET_OBJ_RENT(o));
+}
+
+
+DG_FIELD(objfield_carried_by)
+{
+  if (o->carried_by)
+    snprintf(str, slen,"%c%d",UID_CHAR, GET_ID(o->carried_by));
+  else
+    *str = '\0';
+}
+
+
+DG_FIELD(objfield_contents)
+{
+  if (o->contains)
+    snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(o->contains));
+  else
+    *str = '\0';
+}
+
+
+DG_FIELD(objfield_count)
+{
+  if (GET_OBJ_TYPE(o) == ITEM_CONTAINER)
+    snprintf(str, slen, "%d", item_in_list(subfield, o->contains));
+  else
+    strcpy(str, "0");
+}
+
+
+DG_FIELD(objfield_extra)
+{
+  if (subfield && *subfield) {
+    if (check_flags_by_name_ar(GET_OBJ_EXTRA(o), NUM_ITEM_FLAGS, subfield, extra_bits) > 0)
+      snprintf(str, slen, "1");
+    else
+      snprintf(str, slen, "0");
+  } else
+    snprintf(str, slen, "0");
+}
+
+
+/* Any other field starting with an 'e' has always given the extra bits. */
+DG_FIELD(objfield_extra_bits)
+{
+  sprintbitarray(GET_OBJ_EXTRA(o), extra_bits, EF_ARRAY_MAX, str);
+}
+
+
+DG_FIELD(objfield_has_in)
+{
+  if (GET_OBJ_TYPE(o) == ITEM_CONTAINER)
+    snprintf(str, slen, "%s", (item_in_list(subfield, o->contains) ? "1" : "0"));
+  else
+    strcpy(str, "0");
+}
+
+
+DG_FIELD(objfield_health)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    GET_OBJ_VAL(o, VAL_ALL_HEALTH) = MAX(1, addition + GET_OBJ_VAL(o, VAL_ALL_HEALTH));
+    if (OBJ_FLAGGED(o, ITEM_BROKEN) && GET_OBJ_VAL(o, VAL_ALL_HEALTH) >= 100)
+      REMOVE_BIT_AR(GET_OBJ_EXTRA(o), ITEM_BROKEN);
+  }
+  snprintf(str, slen, "%d", GET_OBJ_VAL(o, VAL_ALL_HEALTH));
+}
+
+
+DG_FIELD(objfield_id)
+{
+  snprintf(str, slen, "%d", GET_ID(o));
+}
+
+
+DG_FIELD(objfield_is_inroom)
+{
+  if (IN_ROOM(o) != NOWHERE)
+    snprintf(str, slen,"%c%d",UID_CHAR, world[IN_ROOM(o)].number + ROOM_ID_BASE);
+  else
+    *str = '\0';
+}
+
+
+DG_FIELD(objfield_is_pc)
+{
+  strcpy(str, "-1");
+}
+
+
+DG_FIELD(objfield_itemflag)
+{
+  if (subfield && *subfield) {
+    int item = get_flag_by_name(extra_bits, subfield);
+    if (item != NOFLAG && OBJ_FLAGGED(o, item))
+      strcpy(str, "1");
+    else
+      strcpy(str, "0");
+  } else
+    strcpy(str, "0");
+}
+
+
+DG_FIELD(objfield_level)
+{
+  snprintf(str, slen, "%d", GET_OBJ_LEVEL(o));
+}
+
+
+DG_FIELD(objfield_name)
+{
+  if (!subfield || !*subfield)
+    snprintf(str, slen, "%s",  o->name);
+  else {
+    char blah[500];
+    sprintf(blah, "%s %s", o->name, subfield);
+    o->name = strdup(blah);
+    obj_keywords_refresh(o);
+  }
+}
+
+
+DG_FIELD(objfield_next_in_list)
+{
+  if (o->next_content)
+    snprintf(str, slen,"%c%d",UID_CHAR, GET_ID(o->next_content));
+  else
+    *str = '\0';
+}
+
+
+DG_FIELD(objfield_room)
+{
+  if (obj_room(o) != NOWHERE)
+    snprintf(str, slen,"%c%d",UID_CHAR, world[obj_room(o)].number + ROOM_ID_BASE);
+  else
+    *str = '\0';
+}
+
+
+DG_FIELD(objfield_shortdesc)
+{
+  if (!subfield || !*subfield)
+    snprintf(str, slen, "%s",  o->short_description);
+  else {
+    char blah[500];
+    sprintf(blah, "%s @wnicknamed @D(@C%s@D)@n", o->short_description, subfield);
+    o->short_description = strdup(blah);
+  }
+}
+
+
+DG_FIELD(objfield_setaffects)
+{
+  if (subfield && *subfield) {
+    int ns;
+    if ((ns = check_flags_by_name_ar(GET_OBJ_PERM(o), NUM_AFF_FLAGS, subfield, affected_bits)) > 0) {
+      TOGGLE_BIT_AR(GET_OBJ_PERM(o), ns);
+      snprintf(str, slen, "1");
+    }
+  }
+}
+
+
+DG_FIELD(objfield_setextra)
+{
+  if (subfield && *subfield) {
+    int ns;
+    if ((ns = check_flags_by_name_ar(GET_OBJ_EXTRA(o), NUM_ITEM_FLAGS, subfield, extra_bits)) > 0) {
+      TOGGLE_BIT_AR(GET_OBJ_EXTRA(o), ns);
+      snprintf(str, slen, "1");
+    }
+  }
+}
+
+
+DG_FIELD(objfield_size)
+{
+  if (subfield && *subfield) {
+    int ns;
+    if ((ns = search_block(subfield, size_names, FALSE)) > -1) {
+      (o)->size = ns;
+    }
+  }
+  sprinttype(GET_OBJ_SIZE(o), size_names, str, slen);
+}
+
+
+DG_FIELD(objfield_type)
+{
+  sprinttype(GET_OBJ_TYPE(o), item_types, str, slen);
+}
+
+
+DG_FIELD(objfield_timer)
+{
+  snprintf(str, slen, "%d", GET_OBJ_TIMER(o));
+}
+
+
+DG_FIELD(objfield_vnum)
+{
+  if (subfield && *subfield) {
+    snprintf(str, slen, "%d", (int)(GET_OBJ_VNUM(o) == atoi(subfield)));
+  } else {
+    snprintf(str, slen, "%d", GET_OBJ_VNUM(o));
+  }
+}
+
+
+DG_FIELD(objfield_val0)
+{
+  snprintf(str, slen, "%d", GET_OBJ_VAL(o, 0));
+}
+
+
+DG_FIELD(objfield_val1)
+{
+  snprintf(str, slen, "%d", GET_OBJ_VAL(o, 1));
+}
+
+
+DG_FIELD(objfield_val2)
+{
+  snprintf(str, slen, "%d", GET_OBJ_VAL(o, 2));
+}
+
+
+DG_FIELD(objfield_val3)
+{
+  snprintf(str, slen, "%d", GET_OBJ_VAL(o, 3));
+}
+
+
+DG_FIELD(objfield_val4)
+{
+  snprintf(str, slen, "%d", GET_OBJ_VAL(o, 4));
+}
+
+
+DG_FIELD(objfield_val5)
+{
+  snprintf(str, slen, "%d", GET_OBJ_VAL(o, 5));
+}
+
+
+DG_FIELD(objfield_val6)
+{
+  snprintf(str, slen, "%d", GET_OBJ_VAL(o, 6));
+}
+
+
+DG_FIELD(objfield_val7)
+{
+  snprintf(str, slen, "%d", GET_OBJ_VAL(o, 7));
+}
+
+
+DG_FIELD(objfield_weight)
+{
+  if (subfield && *subfield) {
+    int addition = atoi(subfield);
+    if (addition < 0 || addition > 0) {
+     GET_OBJ_WEIGHT(o) = MAX(0, addition + GET_OBJ_WEIGHT(o));
+    } else {
+     GET_OBJ_WEIGHT(o) = 0;
+    }
+  }
+  snprintf(str, slen, "%" I64T "", GET_OBJ_WEIGHT(o));
+}
+
+
+DG_FIELD(objfield_worn_by)
+{
+  if (o->worn_by)
+    snprintf(str, slen,"%c%d",UID_CHAR, GET_ID(o->worn_by));
+  else
+    *str = '\0';
+}
+
+
+static constexpr struct dg_field obj_fields[] = {
+  { "affects",		objfield_affects },
+  { "cost",		objfield_cost },
+  { "cost_per_day",	objfield_cost_per_day },
+  { "carried_by",	objfield_carried_by },
+  { "contents",		objfield_contents },
+  { "count",		objfield_count },
+  { "extra",		objfield_extra },
+  { "has_in",		objfield_has_in },
+  { "health",		objfield_health },
+  { "id",		objfield_id },
+  { "is_inroom",	objfield_is_inroom },
+  { "is_pc",		objfield_is_pc },
+  { "itemflag",		objfield_itemflag },
+  { "level",		objfield_level },
+  { "name",		objfield_name },
+  { "next_in_list",	objfield_next_in_list },
+  { "room",		objfield_room },
+  { "shortdesc",	objfield_shortdesc },
+  { "setaffects",	objfield_setaffects },
+  { "setextra",		objfield_setextra },
+  { "size",		objfield_size },
+  { "type",		objfield_type },
+  { "timer",		objfield_timer },
+  { "vnum",		objfield_vnum },
+  { "val0",		objfield_val0 },
+  { "val1",		objfield_val1 },
+  { "val2",		objfield_val2 },
+  { "val3",		objfield_val3 },
+  { "val4",		objfield_val4 },
+  { "val5",		objfield_val5 },
+  { "val6",		objfield_val6 },
+  { "val7",		objfield_val7 },
+  { "weight",		objfield_weight },
+  { "worn_by",		objfield_worn_by },
+};
+static constexpr auto obj_field_index = dg_field_index_build(obj_fields);
+
+
+DG_FIELD(roomfield_name)
+{
+  snprintf(str, slen, "%s",  r->name);
+}
+
+
+DG_FIELD(roomfield_sector)
+{
+  sprinttype(r->sector_type, sector_types, str, slen);
+}
+
+
+DG_FIELD(roomfield_gravity)
+{
+  snprintf(str, slen,"%d",r->gravity);
+}
+
+
+DG_FIELD(roomfield_vnum)
+{
+  if (subfield && *subfield) {
+    snprintf(str, slen, "%d", (int)(r->number == atoi(subfield)));
+  } else {
+    snprintf(str, slen,"%d",r->number);
+  }
+}
+
+
+DG_FIELD(roomfield_contents)
+{
+  struct obj_data *obj;
+
+  if (subfield && *subfield) {
+    for (obj = r->contents; obj; obj = obj->next_content) {
+      if (GET_OBJ_VNUM(obj) == atoi(subfield)) {
+        /* arg given, found */
+        snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(obj));
+        return;
+      }
+    }
+    if (!obj)
+      *str = '\0'; /* arg given, not found */
+  } else { /* no arg given */
+    if (r->contents) {
+      snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(r->contents));
+    } else {
+      *str = '\0';
+    }
+  }
+}
+
+
+DG_FIELD(roomfield_people)
+{
+  if (r->people)
+    snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(r->people));
+  else
+    *str = '\0';
+}
+
+
+DG_FIELD(roomfield_id)
+{
+  room_rnum rnum = real_room(r->number);
+  if (rnum != NOWHERE)
+    snprintf(str, slen, "%d", world[rnum].number + ROOM_ID_BASE);
+  else
+    *str = '\0';
+}
+
+
+DG_FIELD(roomfield_weather)
 {
+  const char *sky_look[] = {
+    "sunny",
+    "cloudy",
+    "rainy",
+    "lightning"
+  };
+
+  if (!IS_SET_AR(r->room_flags, ROOM_INDOORS))
+    snprintf(str, slen, "%s", sky_look[weather_info.sky]);
+  else
+    *str = '\0';
+}
 
-  /* If this works, no more searching needed */
-  if (get_object_in_equip(ch, item) != NULL)
-    return 1;
 
-  if (item_in_list(item, ch->carrying) == 0)
-    return 0;
+DG_FIELD(roomfield_fishing)
+{
+  room_rnum thisroom = real_room(r->number);
+  if (ROOM_FLAGGED(thisroom, ROOM_FISHING))
+    snprintf(str, slen, "1");
   else
-    return 1;
+    snprintf(str, slen, "0");
 }
 
-int text_processed(char *field, char *subfield, struct trig_var_data *vd,
-                   char *str, size_t slen)
+
+DG_FIELD(roomfield_zonenumber)
 {
-  char *p, *p2;
-  char tmpvar[MAX_STRING_LENGTH];
+  snprintf(str, slen, "%d",  zone_table[r->zone].number);
+}
 
-  if (!strcasecmp(field, "strlen")) {                     /* strlen    */
-    char limit[200];
-    sprintf(limit, "%"SZT, strlen(vd->value));
-    snprintf(str, slen, "%d", atoi(limit));
-    return TRUE;
-  } else if (!strcasecmp(field, "trim")) {                /* trim      */
-    /* trim whitespace from ends */
-    snprintf(tmpvar, sizeof(tmpvar)-1 , "%s", vd->value); /* -1 to use later*/
-    p = tmpvar;
-    p2 = tmpvar + strlen(tmpvar) - 1;
-    while (*p && isspace(*p)) p++;
-    while ((p<=p2) && isspace(*p2)) p2--;
-    if (p>p2) { /* nothing left */
-      *str = '\0';
-      return TRUE;
-    }
-    *(++p2) = '\0';                                         /* +1 ok (see above) */
-    snprintf(str, slen, "%s", p);
-    return TRUE;
-  } else if (!strcasecmp(field, "contains")) {            /* contains  */
-    if (str_str(vd->value, subfield))
-      strcpy(str, "1");
-    else
-      strcpy(str, "0");
-    return TRUE;
-  } else if (!strcasecmp(field, "car")) {                 /* car       */
-    char *car = vd->value;
-    while (*car && !isspace(*car))
-      *str++ = *car++;
-    *str = '\0';
-    return TRUE;
-
-  } else if (!strcasecmp(field, "cdr")) {                 /* cdr       */
-    char *cdr = vd->value;
-    while (*cdr && !isspace(*cdr)) cdr++; /* skip 1st field */
-    while (*cdr && isspace(*cdr)) cdr++;  /* skip to next */
-
-    snprintf(str, slen, "%s", cdr);
-    return TRUE;
-  } else if (!strcasecmp(field, "charat")) {              /* CharAt    */
-    size_t len = strlen(vd->value), dgindex = atoi(subfield);
-    if (dgindex > len || dgindex < 1)
-      strcpy(str, "");
-    else
-    	snprintf(str, slen, "%c", vd->value[dgindex - 1]);
-    return TRUE;
-  } else if (!strcasecmp(field, "mudcommand")) {
-    /* find the mud command returned from this text */
-/* NOTE: you may need to replace "cmd_info" with "complete_cmd_info", */
-/* depending on what patches you've got applied.                      */
-    extern const struct command_info cmd_info[];
-/* on older source bases:    extern struct command_info *cmd_info; */
-    int length, cmd;
-    for (length = strlen(vd->value), cmd = 0;
-         *cmd_info[cmd].command != '\n'; cmd++)
-      if (!strncmp(cmd_info[cmd].command, vd->value, length))
-        break;
 
-    if (*cmd_info[cmd].command == '\n')
-      *str = '\0';
+DG_FIELD(roomfield_zonename)
+{
+  snprintf(str, slen, "%s",  zone_table[r->zone].name);
+}
+
+
+DG_FIELD(roomfield_roomflag)
+{
+  if (subfield && *subfield) {
+    room_rnum thisroom = real_room(r->number);
+    if (check_flags_by_name_ar(ROOM_FLAGS(thisroom), NUM_ROOM_FLAGS, subfield, room_bits) > 0)
+      snprintf(str, slen, "1");
     else
-      snprintf(str, slen, "%s", cmd_info[cmd].command);
-    return TRUE;
-  }
+      snprintf(str, slen, "0");
+  } else
+    snprintf(str, slen, "0");
+}
 
-  return FALSE;
+
+/* The directions all work the same way, each on its own exit. */
+static void room_exit_field(struct room_data *r, int dir, char *subfield, char *str, size_t slen)
+{
+  if (R_EXIT(r, dir)) {
+    if (subfield && *subfield) {
+      if (!strcasecmp(subfield, "vnum"))
+        snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, dir)->to_room));
+      else if (!strcasecmp(subfield, "key"))
+        snprintf(str, slen, "%d", R_EXIT(r, dir)->key);
+      else if (!strcasecmp(subfield, "bits"))
+        sprintbit(R_EXIT(r, dir)->exit_info ,exit_bits, str, slen);
+      else if (!strcasecmp(subfield, "room")) {
+        if (R_EXIT(r, dir)->to_room != NOWHERE)
+          snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, dir)->to_room].number + ROOM_ID_BASE);
+        else
+          *str = '\0';
+      }
+    } else /* no subfield - default to bits */
+      sprintbit(R_EXIT(r, dir)->exit_info ,exit_bits, str, slen);
+  } else
+    *str = '\0';
 }
 
+DG_FIELD(roomfield_north)	{ room_exit_field(r, NORTH, subfield, str, slen); }
+DG_FIELD(roomfield_east)	{ room_exit_field(r, EAST, subfield, str, slen); }
+DG_FIELD(roomfield_south)	{ room_exit_field(r, SOUTH, subfield, str, slen); }
+DG_FIELD(roomfield_west)	{ room_exit_field(r, WEST, subfield, str, slen); }
+DG_FIELD(roomfield_up)		{ room_exit_field(r, UP, subfield, str, slen); }
+DG_FIELD(roomfield_down)	{ room_exit_field(r, DOWN, subfield, str, slen); }
+DG_FIELD(roomfield_northwest)	{ room_exit_field(r, NORTHWEST, subfield, str, slen); }
+DG_FIELD(roomfield_northeast)	{ room_exit_field(r, NORTHEAST, subfield, str, slen); }
+DG_FIELD(roomfield_southwest)	{ room_exit_field(r, SOUTHWEST, subfield, str, slen); }
+DG_FIELD(roomfield_southeast)	{ room_exit_field(r, SOUTHEAST, subfield, str, slen); }
+DG_FIELD(roomfield_inside)	{ room_exit_field(r, INDIR, subfield, str, slen); }
+DG_FIELD(roomfield_outside)	{ room_exit_field(r, OUTDIR, subfield, str, slen); }
+
+
+static constexpr struct dg_field room_fields[] = {
+  { "name",		roomfield_name },
+  { "sector",		roomfield_sector },
+  { "gravity",		roomfield_gravity },
+  { "vnum",		roomfield_vnum },
+  { "contents",		roomfield_contents },
+  { "people",		roomfield_people },
+  { "id",		roomfield_id },
+  { "weather",		roomfield_weather },
+  { "fishing",		roomfield_fishing },
+  { "zonenumber",	roomfield_zonenumber },
+  { "zonename",		roomfield_zonename },
+  { "roomflag",		roomfield_roomflag },
+  { "north",		roomfield_north },
+  { "east",		roomfield_east },
+  { "south",		roomfield_south },
+  { "west",		roomfield_west },
+  { "up",		roomfield_up },
+  { "down",		roomfield_down },
+  { "northwest",	roomfield_northwest },
+  { "northeast",	roomfield_northeast },
+  { "southwest",	roomfield_southwest },
+  { "southeast",	roomfield_southeast },
+  { "inside",		roomfield_inside },
+  { "outside",		roomfield_outside },
+};
+static constexpr auto room_field_index = dg_field_index_build(room_fields);
+
+
 
 /* sets str to be the value of var.field */
 void find_replacement(void *go, struct script_data *sc, trig_data *trig, int type, char *var, char *field, char *subfield, char *str, size_t slen)
@@ -229,7 +1809,8 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig, int typ
   obj_data *obj, *o = NULL;
   struct room_data *room, *r = NULL;
   char *name;
-  int num, count, i, j, doors;
+  int num, count, i, doors;
+  dg_field_func func;
 
   char *send_cmd[]       = {"msend ",       "osend ",       "wsend "      };
   char *echo_cmd[]       = {"mecho ",       "oecho ",       "wecho "      };
@@ -252,16 +1833,11 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig, int typ
 
   /* X.global() will have a NULL trig */
   if (trig)
-    for (vd = GET_TRIG_VARS(trig); vd; vd = vd->next)
-      if (!strcasecmp(vd->name, var))
-        break;
+    vd = find_var(GET_TRIG_VARS(trig), var);
 
   /* some evil waitstates could crash the mud if sent here with sc==NULL*/
   if (!vd && sc)
-    for (vd = sc->global_vars; vd; vd = vd->next)
-      if (!strcasecmp(vd->name, var) &&
-          (vd->context==0 || vd->context==sc->context))
-        break;
+    vd = find_var_in_context(sc->global_vars, var, sc->context);
 
   if (!*field) {
     if (vd)
@@ -386,11 +1962,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig, int typ
           script_log("Attempt to find global var. Apparently the void has no script.");
           return;
         }
-        for (vd = thescript->global_vars; vd ; vd = vd->next)
-          if (!strcasecmp(vd->name, field))
-            break;
-
-        if (vd)
+        if ((vd = find_var(thescript->global_vars, field)))
           snprintf(str, slen, "%s", vd->value);
 
         return;
@@ -479,655 +2051,100 @@ in the vault (vnum: 453) now and then. you can just use
             ch = (char_data *) go;
             for (c = world[IN_ROOM(ch)].people; c; c = c->next_in_room)
               if ((c != ch) && valid_dg_target(c, DG_ALLOW_GODS) &&
-                  CAN_SEE(ch, c)) {
-                if (!rand_number(0, count))
-                  rndm = c;
-                count++;
-              }
-          }
-
-          else if (type == OBJ_TRIGGER) {
-            for (c = world[obj_room((obj_data *) go)].people; c;
-                 c = c->next_in_room)
-              if (valid_dg_target(c, DG_ALLOW_GODS)) {
-                if (!rand_number(0, count))
-                  rndm = c;
-                count++;
-              }
-          }
-
-          else if (type == WLD_TRIGGER) {
-            for (c = ((struct room_data *) go)->people; c;
-                 c = c->next_in_room)
-              if (valid_dg_target(c, DG_ALLOW_GODS)) {
-
-                if (!rand_number(0, count))
-                  rndm = c;
-                count++;
-              }
-          }
-
-          if (rndm)
-            snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(rndm));
-          else
-            *str = '\0';
-        }
-
-        else if (!strcasecmp(field, "dir")) {
-          room_rnum in_room = NOWHERE;
-
-          switch (type) {
-            case WLD_TRIGGER:
-              in_room = real_room(((struct room_data *) go)->number);
-              break;
-            case OBJ_TRIGGER:
-              in_room = obj_room((struct obj_data *) go);
-              break;
-            case MOB_TRIGGER:
-              in_room = IN_ROOM((struct char_data *)go);
-              break;
-          }
-          if (in_room == NOWHERE) {
-            *str = '\0';
-          } else {
-            doors = 0;
-            room = &world[in_room];
-            for (i = 0; i < NUM_OF_DIRS ; i++)
-              if (R_EXIT(room, i))
-                doors++;
-
-            if (!doors) {
-              *str = '\0';
-            } else {
-              for ( ; ; ) {
-                doors = rand_number(0, NUM_OF_DIRS-1);
-                if (R_EXIT(room, doors))
-                  break;
-              }
-              snprintf(str, slen, "%s", dirs[doors]);
-            }
-          }
-        }
-        else
-          snprintf(str, slen, "%d", ((num = atoi(field)) > 0) ? rand_number(1, num) : 0);
-
-        return;
-      }
-    }
-
-    if (c) {
-      if (text_processed(field, subfield, vd, str, slen)) return;
-
-      else if (!strcasecmp(field, "global")) { /* get global of something else */
-        if (IS_NPC(c) && c->script) {
-          find_replacement(go, c->script, NULL, MOB_TRIGGER,
-            subfield, NULL, NULL, str, slen);
-        }
-      }
-      /* set str to some 'non-text' first */
-      *str = '\x1';
-
-      switch (LOWER(*field)) {
-        case 'a':
-          if (!strcasecmp(field, "aaaaa")) {
-               strcpy(str, "0");
-          }
-          else if (!strcasecmp(field, "affect")) {
-             if (subfield && *subfield) {
-               int affect = get_flag_by_name(affected_bits, subfield);
-               if (affect != NOFLAG && AFF_FLAGGED(c, affect))
-                 strcpy(str, "1");
-               else
-                 strcpy(str, "0");
-             } else
-               strcpy(str, "0");
-          }
-          else if (!strcasecmp(field, "alias"))
-            snprintf(str, slen, "%s", GET_PC_NAME(c));
-
-          else if (!strcasecmp(field, "align")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-             GET_ALIGNMENT(c) = MAX(-1000, MIN(addition, 1000));
-            }
-        	snprintf(str, slen, "%d", GET_ALIGNMENT(c));
-          }
-          break;
-        case 'b':
-          if (!strcasecmp(field, "bank")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_BANK_GOLD(c) += addition;
-            }
-            snprintf(str, slen, "%d", GET_GOLD(c));
-          }
-          break;
-        case 'c':
-          if (!strcasecmp(field, "canbeseen")) {
-            if ((type == MOB_TRIGGER) && !CAN_SEE(((char_data *)go), c))
-              strcpy(str, "0");
-            else
-              strcpy(str, "1");
-          }
-          else if (!strcasecmp(field, "carry")) {
-            if (!IS_NPC(c) && CARRYING(c))
-             strcpy(str, "1");
-            else
-             strcpy(str, "0");
-          }
-          else if (!strcasecmp(field, "clan")) {
-            if (GET_CLAN(c) != NULL && strstr(GET_CLAN(c), subfield))
-             strcpy(str, "1");
-            else
-             strcpy(str, "0");
-          }
-          else if (!strcasecmp(field, "class")) {
-           if (!IS_NPC(c))
-            snprintf(str, slen, "%s", c->chclass->getName().c_str());
-           else
-            snprintf(str, slen, "blank");
-          }
-
-          else if (!strcasecmp(field, "con")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              int max = 100;
-              GET_CON(c) += addition;
-              if (GET_CON(c) > max) GET_CON(c) = max;
-              if (GET_CON(c) < 3) GET_CON(c) = 3;
-            }
-            snprintf(str, slen, "%d", GET_CON(c));
-          }
-          else if (!strcasecmp(field, "cha")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              int max = 100;
-              GET_CHA(c) += addition;
-              if (GET_CHA(c) > max) GET_CHA(c) = max;
-              if (GET_CHA(c) < 3) GET_CHA(c) = 3;
-            }
-            snprintf(str, slen, "%d", GET_CHA(c));
-          }
-          break;
-        case 'd':
-          if (!strcasecmp(field, "dead")) {
-           if (AFF_FLAGGED(c, AFF_SPIRIT))
-            strcpy(str, "1");
-           else
-            strcpy(str, "0");
-          }
-          else if (!strcasecmp(field, "death")) {
-            snprintf(str, slen, "%ld", GET_DTIME(c));
-          }
-          else if (!strcasecmp(field, "dex")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              int max = 100;
-              GET_DEX(c) += addition;
-              if (GET_DEX(c) > max) GET_DEX(c) = max;
-              if (GET_DEX(c) < 3) GET_DEX(c) = 3;
-            }
-            snprintf(str, slen, "%d", GET_DEX(c));
-          }
-          else if (!strcasecmp(field, "drag")) {
-            if (!IS_NPC(c) && DRAGGING(c))
-             strcpy(str, "1");
-            else
-             strcpy(str, "0");
-          }
-          else if (!strcasecmp(field, "drunk")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-            GET_COND(c, DRUNK) = MAX(-1, MIN(addition, 24));
-            }
-            snprintf(str, slen, "%d", GET_COND(c, DRUNK));
-          }
-          break;
-        case 'e':
-          if (!strcasecmp(field, "eq")) {
-            int pos;
-            if (!subfield || !*subfield)
-              *str = '\0';
-            else if (*subfield == '*') {
-              for (i = 0, j = 0; i < NUM_WEARS; i++)
-                if (GET_EQ(c, i)) {
-                  j++;
-                  break;
-                }
-              if (j > 0)
-                strcpy(str,"1");
-              else
-                *str = '\0';
-            } else if ((pos = find_eq_pos_script(subfield)) < 0 || !GET_EQ(c, pos))
-              *str = '\0';
-            else
-              snprintf(str, slen, "%c%d",UID_CHAR, GET_ID(GET_EQ(c, pos)));
-          }
-          if (!strcasecmp(field, "exp")) {
-            if (subfield && *subfield) {
-              int64_t addition = MIN(atoll(subfield), 2100000000);
-
-              gain_exp(c, addition);
-            }
-            snprintf(str, slen, "%" I64T "", GET_EXP(c));
-          }
-          break;
-        case 'f':
-          if (!strcasecmp(field, "fighting")) {
-            if (FIGHTING(c))
-              snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(FIGHTING(c)));
-            else
-              *str = '\0';
-          }
-          else if (!strcasecmp(field, "flying")) {
-               if (AFF_FLAGGED(c, AFF_FLYING))
-                 strcpy(str, "1");
-               else
-                 strcpy(str, "0");
-          }
-          else if (!strcasecmp(field, "follower")) {
-            if (!c->followers || !c->followers->follower)
-              *str = '\0';
-            else
-              snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(c->followers->follower));
-          }
-          break;
-        case 'g':
-          if (!strcasecmp(field, "gold")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_GOLD(c) += addition;
-            }
-            snprintf(str, slen, "%d", GET_GOLD(c));
-          }
-          break;
-        case 'h':
-          if (!strcasecmp(field, "has_item")) {
-            if (!(subfield && *subfield))
-              *str = '\0';
-            else
-              snprintf(str, slen, "%d", char_has_item(subfield, c));
-          }
-          else if (!strcasecmp(field, "hisher"))
-            snprintf(str, slen, "%s", HSHR(c));
-
-          else if (!strcasecmp(field, "heshe"))
-            snprintf(str, slen, "%s", HSSH(c));
-
-          else if (!strcasecmp(field, "himher"))
-            snprintf(str, slen, "%s", HMHR(c));
-
-          else if (!strcasecmp(field, "hitp")) {
-            if (subfield && *subfield) {
-              int64_t addition = atoll(subfield);
-              if(addition > 0 ) {
-                  c->incCurHealth(addition);
-              } else {
-                  c->decCurHealth(addition);
-              }
-
-              update_pos(c);
-            }
-            snprintf(str, slen, "%" I64T "", GET_HIT(c));
-          }
-          else if (!strcasecmp(field, "hunger")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_COND(c, HUNGER) = MAX(-1, MIN(addition, 24));
-            }
-            snprintf(str, slen, "%d", GET_COND(c, HUNGER));
-          }
-          break;
-        case 'i':
-          if (!strcasecmp(field, "id"))
-            snprintf(str, slen, "%d", GET_ID(c));
-
-          /* new check for pc/npc status */
-          else if (!strcasecmp(field, "is_pc")) {
-            if (IS_NPC(c))
-              strcpy(str, "0");
-            else
-              strcpy(str, "1");
-          }
-
-          else if (!strcasecmp(field, "inventory")) {
-            if(subfield && *subfield) {
-              for (obj = c->carrying;obj;obj=obj->next_content) {
-                if(GET_OBJ_VNUM(obj)==atoi(subfield)) {
-                  snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(obj)); /* arg given, found */
-                  return;
-                }
-              }
-              if (!obj)
-                *str = '\0'; /* arg given, not found */
-            } else { /* no arg given */
-              if (c->carrying) {
-                snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(c->carrying));
-              } else {
-                *str = '\0';
-              }
-            }
-          }
-
-          else if (!strcasecmp(field, "is_killer")) {
-            if (subfield && *subfield) {
-              if (!strcasecmp("on", subfield))
-                SET_BIT_AR(PLR_FLAGS(c), PLR_KILLER);
-              else if (!strcasecmp("off", subfield))
-                REMOVE_BIT_AR(PLR_FLAGS(c), PLR_KILLER);
-            }
-            if (PLR_FLAGGED(c, PLR_KILLER))
-              strcpy(str, "1");
-            else
-              strcpy(str, "0");
-          }
-
-          else if (!strcasecmp(field, "is_thief")) {
-            if (subfield && *subfield) {
-              if (!strcasecmp("on", subfield))
-                SET_BIT_AR(PLR_FLAGS(c), PLR_THIEF);
-              else if (!strcasecmp("off", subfield))
-                REMOVE_BIT_AR(PLR_FLAGS(c), PLR_THIEF);
-            }
-            if (PLR_FLAGGED(c, PLR_THIEF))
-              strcpy(str, "1");
-            else
-              strcpy(str, "0");
-          }
-
-          else if (!strcasecmp(field, "int")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              int max = 100;
-              GET_INT(c) += addition;
-              if (GET_INT(c) > max) GET_INT(c) = max;
-              if (GET_INT(c) < 3) GET_INT(c) = 3;
-            }
-            snprintf(str, slen, "%d", GET_INT(c));
-          }
-          break;
-        case 'l':
-          if (!strcasecmp(field, "level"))
-            snprintf(str, slen, "%d", GET_LEVEL(c));
-          break;
-        case 'm':
-          if (!strcasecmp(field, "maxhitp")) {
-            if (subfield && *subfield) {
-              int64_t addition = atoll(subfield);
-              //GET_MAX_HIT(c) = MAX(GET_MAX_HIT(c) + addition, 1);
-            }
-            snprintf(str, slen, "%" I64T "", GET_MAX_HIT(c));
-          }
-
-          else if (!strcasecmp(field, "mana")) {
-            if (subfield && *subfield) {
-              int64_t addition = atoll(subfield);
-              if(addition > 0) {
-                  c->incCurKI(addition);
-              } else {
-                  c->decCurKI(addition);
-              }
-            }
-            snprintf(str, slen, "%" I64T "", (c->getCurKI()));
-          }
-          else if (!strcasecmp(field, "maxmana")) {
-            if (subfield && *subfield) {
-              int64_t addition = atoll(subfield);
-              //GET_MAX_MANA(c) = MAX(GET_MAX_MANA(c) + addition, 1);
-            }
-            snprintf(str, slen, "%" I64T "", GET_MAX_MANA(c));
-          }
-
-          else if (!strcasecmp(field, "move")) {
-            if (subfield && *subfield) {
-              int64_t addition = atoll(subfield);
-              if(addition > 0) {
-                  c->incCurST(addition);
-              } else {
-                  c->decCurST(addition);
-              }
-
-            }
-            snprintf(str, slen, "%" I64T "", (c->getCurST()));
-          }
-
-          else if (!strcasecmp(field, "maxmove")) {
-            if (subfield && *subfield) {
-              int64_t addition = atoll(subfield);
-              //GET_MAX_MOVE(c) = MAX(GET_MAX_MOVE(c) + addition, 1);
-            }
-            snprintf(str, slen, "%" I64T "", GET_MAX_MOVE(c));
-          }
-
-          else if (!strcasecmp(field, "master")) {
-            if (!c->master)
-              *str = '\0';
-            else
-              snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(c->master));
-          }
-          break;
-        case 'n':
-          if (!strcasecmp(field, "name")) {
-             snprintf(str, slen, "%s", GET_NAME(c));
-          }
-          else if (!strcasecmp(field, "next_in_room")) {
-            if (c->next_in_room)
-              snprintf(str, slen,"%c%d",UID_CHAR, GET_ID(c->next_in_room));
-            else
-              *str = '\0';
-          }
-          break;
-        case 'p':
-          /* Thanks to Christian Ejlertsen for this idea
-             And to Ken Ray for speeding the implementation up :)*/
-          if (!strcasecmp(field, "pos")) {
-            if (subfield && *subfield) {
-              for (i = POS_SLEEPING; i <= POS_STANDING; i++) {
-                /* allows : Sleeping, Resting, Sitting, Fighting, Standing */
-                if (!strncasecmp(subfield, position_types[i], strlen(subfield))) {
-                  GET_POS(c) = i;
-                  break;
-                }
-              }
-            }
-            snprintf(str, slen, "%s", position_types[GET_POS(c)]);
-          }
-          else if (!strcasecmp(field, "prac")) {
-            if (IS_NPC(c)) {
-             if (IN_ROOM(c) != NOWHERE) {
-              send_to_room(IN_ROOM(c), "Error!: Report this trigger error to the coding authorities!\r\n");
-             }
-            }
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_PRACTICES(c, GET_CLASS(c)) = MAX(0, GET_PRACTICES(c, GET_CLASS(c)) + addition);
-            }
-            snprintf(str, slen, "%d", GET_PRACTICES(c, GET_CLASS(c)));
-          }
-          else if (!strcasecmp(field, "plr")) {
-             if (subfield && *subfield) { 
-               int plr = get_flag_by_name(player_bits, subfield); 
-               if (plr != NOFLAG && PLR_FLAGGED(c, plr)) 
-                 strcpy(str, "1"); 
-               else 
-                 strcpy(str, "0"); 
-             } else 
-               strcpy(str, "0"); 
-           }
-          else if (!strcasecmp(field, "pref")) {
-             if (subfield && *subfield) { 
-               int pref = get_flag_by_name(preference_bits, subfield); 
-               if (pref != NOFLAG && PRF_FLAGGED(c, pref)) 
-                 strcpy(str, "1"); 
-               else 
-                 strcpy(str, "0"); 
-             } else 
-               strcpy(str, "0"); 
-           }
-          break;
-        case 'r':
-          if (!strcasecmp(field, "room")) {  /* in NOWHERE, return the void */
-/* see note in dg_scripts.h */
-#ifdef ACTOR_ROOM_IS_UID
-            snprintf(str, slen, "%c%d",UID_CHAR,
-               (IN_ROOM(c)!= NOWHERE) ? world[IN_ROOM(c)].number + ROOM_ID_BASE : ROOM_ID_BASE);
-#else
-            snprintf(str, slen, "%d", (IN_ROOM(c)!= NOWHERE) ? world[IN_ROOM(c)].number : 0);
-#endif
-          }
-#ifdef GET_RACE
-          else if (!strcasecmp(field, "race")) {
-                snprintf(str, slen, "%s", c->race->getName().c_str());
-          }
-#endif
-          else if (!strcasecmp(field, "rpp")) {
-           if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_RP(c) += addition;
-            }
-
-            snprintf(str, slen, "%d", GET_RP(c));
-          }
-
-          break;
-        case 's':
-          if (!strcasecmp(field, "sex"))
-            snprintf(str, slen, "%s", genders[(int)GET_SEX(c)]);
-
-          else if (!strcasecmp(field, "str")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              int max = 100;
-              GET_STR(c) += addition;
-              if (GET_STR(c) > max) GET_STR(c) = max;
-              if (GET_STR(c) < 3) GET_STR(c) = 3;
-            }
-            snprintf(str, slen, "%d", GET_STR(c));
+                  CAN_SEE(ch, c)) {
+                if (!rand_number(0, count))
+                  rndm = c;
+                count++;
+              }
           }
 
-          else if (!strcasecmp(field, "size")) {
-            if (subfield && *subfield) {
-              int ns;
-              if ((ns = search_block(subfield, size_names, FALSE)) > -1) {
-                (c)->size = ns;
+          else if (type == OBJ_TRIGGER) {
+            for (c = world[obj_room((obj_data *) go)].people; c;
+                 c = c->next_in_room)
+              if (valid_dg_target(c, DG_ALLOW_GODS)) {
+                if (!rand_number(0, count))
+                  rndm = c;
+                count++;
               }
-            }
-          sprinttype(get_size(c), size_names, str, slen);
           }
 
-          else if (!strcasecmp(field, "skill"))
-            snprintf(str, slen, "%s", skill_percent(c, subfield));
-
-          else if (!strcasecmp(field, "skillset")) {
-            if (!IS_NPC(c) && subfield && *subfield) {
-              char skillname[MAX_INPUT_LENGTH], *amount;
-              amount = one_word(subfield, skillname);
-              skip_spaces(&amount);
-              if (amount && *amount && is_number(amount)) {
-                int skillnum = find_skill_num(skillname, SKTYPE_SKILL);
-                if (skillnum > 0) {
-                  int new_value = MAX(0, MIN(100, atoi(amount)));
-                  SET_SKILL(c, skillnum, new_value);
-                }
+          else if (type == WLD_TRIGGER) {
+            for (c = ((struct room_data *) go)->people; c;
+                 c = c->next_in_room)
+              if (valid_dg_target(c, DG_ALLOW_GODS)) {
+
+                if (!rand_number(0, count))
+                  rndm = c;
+                count++;
               }
-            }
-            *str = '\0'; /* so the parser know we recognize 'skillset' as a field */
-          }
-          else if (!strcasecmp(field, "saving_fortitude")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_SAVE_MOD(c, SAVING_FORTITUDE) += addition;
-            }
-            snprintf(str, slen, "%d", GET_SAVE_MOD(c, SAVING_FORTITUDE));
-          }
-          else if (!strcasecmp(field, "saving_reflex")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_SAVE_MOD(c, SAVING_REFLEX) += addition;
-            }
-            snprintf(str, slen, "%d", GET_SAVE_MOD(c, SAVING_REFLEX));
-          }
-          else if (!strcasecmp(field, "saving_will")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_SAVE_MOD(c, SAVING_WILL) += addition;
-            }
-            snprintf(str, slen, "%d", GET_SAVE_MOD(c, SAVING_WILL));
           }
 
-          break;
-        case 't':
-          if (!strcasecmp(field, "thirst")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_COND(c, THIRST) = MAX(-1, MIN(addition, 24));
-            }
-            snprintf(str, slen, "%d", GET_COND(c, THIRST));
-          }
-          else if (!strcasecmp(field, "tnl")) {
-            snprintf(str, slen, "%d", level_exp(c, GET_LEVEL(c) + 1));
-          }
-         break;
-        case 'v':
-          if (!strcasecmp(field, "vnum")) {
-            if (subfield && *subfield) {
-              snprintf(str, slen, "%d", IS_NPC(c) ? (int)(GET_MOB_VNUM(c) == atoi(subfield)) : -1 );
-            } else {
-              if (IS_NPC(c))
-                snprintf(str, slen, "%d", GET_MOB_VNUM(c));
-              else
-              /*
-               * for compatibility with unsigned indexes
-               * - this is deprecated - use %actor.is_pc% to check
-               * instead of %actor.vnum% == -1  --Welcor 09/03
-               */
-                strcpy(str, "-1");
-            }
+          if (rndm)
+            snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(rndm));
+          else
+            *str = '\0';
+        }
+
+        else if (!strcasecmp(field, "dir")) {
+          room_rnum in_room = NOWHERE;
+
+          switch (type) {
+            case WLD_TRIGGER:
+              in_room = real_room(((struct room_data *) go)->number);
+              break;
+            case OBJ_TRIGGER:
+              in_room = obj_room((struct obj_data *) go);
+              break;
+            case MOB_TRIGGER:
+              in_room = IN_ROOM((struct char_data *)go);
+              break;
           }
+          if (in_room == NOWHERE) {
+            *str = '\0';
+          } else {
+            doors = 0;
+            room = &world[in_room];
+            for (i = 0; i < NUM_OF_DIRS ; i++)
+              if (R_EXIT(room, i))
+                doors++;
 
-          else if (!strcasecmp(field, "varexists")) {
-            struct trig_var_data *remote_vd;
-            strcpy(str, "0");
-            if (SCRIPT(c)) {
-              for (remote_vd = SCRIPT(c)->global_vars; remote_vd; remote_vd = remote_vd->next) {
-                if (!strcasecmp(remote_vd->name, subfield)) break;
+            if (!doors) {
+              *str = '\0';
+            } else {
+              for ( ; ; ) {
+                doors = rand_number(0, NUM_OF_DIRS-1);
+                if (R_EXIT(room, doors))
+                  break;
               }
-              if (remote_vd) strcpy(str, "1");
+              snprintf(str, slen, "%s", dirs[doors]);
             }
           }
+        }
+        else
+          snprintf(str, slen, "%d", ((num = atoi(field)) > 0) ? rand_number(1, num) : 0);
 
-          break;
-        case 'w':
-          if (!strcasecmp(field, "weight"))
-            snprintf(str, slen, "%d", GET_WEIGHT(c));
-          else if (!strcasecmp(field, "wis")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              int max = 100;
-              GET_WIS(c) += addition;
-              if (GET_WIS(c) > max) GET_WIS(c) = max;
-              if (GET_WIS(c) < 3) GET_WIS(c) = 3;
-            }
-            snprintf(str, slen, "%d", GET_WIS(c));
-          }
-          break;
-        case 'z':
-          if (!strcasecmp(field, "zenni")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_GOLD(c) += addition;
-            }
-            snprintf(str, slen, "%d", GET_GOLD(c));
-          }
-        break;
-      } /* switch *field */
+        return;
+      }
+    }
+
+    if (c) {
+      if (text_processed(field, subfield, vd, str, slen)) return;
+
+      else if (!strcasecmp(field, "global")) { /* get global of something else */
+        if (IS_NPC(c) && c->script) {
+          find_replacement(go, c->script, NULL, MOB_TRIGGER,
+            subfield, NULL, NULL, str, slen);
+        }
+      }
+      /* set str to some 'non-text' first */
+      *str = '\x1';
+
+      if ((func = dg_field_find(char_fields, char_field_index, field)))
+        func(go, type, c, NULL, NULL, vd, subfield, str, slen);
 
-      if (*str == '\x1') { /* no match found in switch */
+      if (*str == '\x1') { /* no such field */
         if (SCRIPT(c)) {
-          for (vd = (SCRIPT(c))->global_vars; vd; vd = vd->next)
-            if (!strcasecmp(vd->name, field))
-              break;
-          if (vd)
+          if ((vd = find_var(SCRIPT(c)->global_vars, field)))
             snprintf(str, slen, "%s", vd->value);
           else {
             *str = '\0';
@@ -1146,247 +2163,14 @@ in the vault (vnum: 453) now and then. you can just use
       if (text_processed(field, subfield, vd, str, slen)) return;
 
       *str = '\x1';
-      switch (LOWER(*field)) {
-        case 'a':
-          if (!strcasecmp(field, "affects")) {
-            if (subfield && *subfield) {
-              if (check_flags_by_name_ar(GET_OBJ_PERM(o), NUM_AFF_FLAGS, subfield, affected_bits) > 0)
-                snprintf(str, slen, "1");
-              else
-                snprintf(str, slen, "0");
-            } else
-              snprintf(str, slen, "0");
-          }
-          break;
-        case 'c':
-          if (!strcasecmp(field, "cost")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_OBJ_COST(o) = MAX(0, addition + GET_OBJ_COST(o));
-            }
-            snprintf(str, slen, "%d", GET_OBJ_COST(o));
-          }
-
-          else if (!strcasecmp(field, "cost_per_day")) {
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_OBJ_RENT(o) = MAX(0, addition + GET_OBJ_RENT(o));
-            }
-            snprintf(str, slen, "%d", GET_OBJ_RENT(o));
-          }
-
-          else if (!strcasecmp(field, "carried_by")) {
-            if (o->carried_by)
-              snprintf(str, slen,"%c%d",UID_CHAR, GET_ID(o->carried_by));
-            else
-              *str = '\0';
-          }
-
-          else if (!strcasecmp(field, "contents")) {
-            if (o->contains)
-              snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(o->contains));
-            else
-              *str = '\0';
-          }
-          /* thanks to Jamie Nelson (Mordecai of 4 Dimensions MUD) */
-          else if (!strcasecmp(field, "count")) {
-            if (GET_OBJ_TYPE(o) == ITEM_CONTAINER)
-              snprintf(str, slen, "%d", item_in_list(subfield, o->contains));
-            else
-              strcpy(str, "0");
-          }
-          break;
-        case 'e':
-          if (!strcasecmp(field, "extra")) {
-            if (subfield && *subfield) {
-              if (check_flags_by_name_ar(GET_OBJ_EXTRA(o), NUM_ITEM_FLAGS, subfield, extra_bits) > 0)
-                snprintf(str, slen, "1");
-              else
-                snprintf(str, slen, "0");
-            } else 
-              snprintf(str, slen, "0");
-          } else {
-            sprintbitarray(GET_OBJ_EXTRA(o), extra_bits, EF_ARRAY_MAX, str);
-          }
-          break;
-        case 'h':
-          /* thanks to Jamie Nelson (Mordecai of 4 Dimensions MUD) */
-          if (!strcasecmp(field, "has_in")) {
-            if (GET_OBJ_TYPE(o) == ITEM_CONTAINER)
-              snprintf(str, slen, "%s", (item_in_list(subfield, o->contains) ? "1" : "0"));
-            else
-            	strcpy(str, "0");
-          }
-          if (!strcasecmp(field, "health")) {
-           if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              GET_OBJ_VAL(o, VAL_ALL_HEALTH) = MAX(1, addition + GET_OBJ_VAL(o, VAL_ALL_HEALTH));
-              if (OBJ_FLAGGED(o, ITEM_BROKEN) && GET_OBJ_VAL(o, VAL_ALL_HEALTH) >= 100)
-               REMOVE_BIT_AR(GET_OBJ_EXTRA(o), ITEM_BROKEN);
-           }
-             snprintf(str, slen, "%d", GET_OBJ_VAL(o, VAL_ALL_HEALTH));
-          }
-          break;
-        case 'i':
-          if (!strcasecmp(field, "id"))
-            snprintf(str, slen, "%d", GET_ID(o));
-
-          else if (!strcasecmp(field, "is_inroom")) {
-            if (IN_ROOM(o) != NOWHERE)
-              snprintf(str, slen,"%c%d",UID_CHAR, world[IN_ROOM(o)].number + ROOM_ID_BASE);
-            else
-              *str = '\0';
-          }
-          else if (!strcasecmp(field, "is_pc")) {
-            strcpy(str, "-1");
-          }
-          else if (!strcasecmp(field, "itemflag")) {
-             if (subfield && *subfield) {
-               int item = get_flag_by_name(extra_bits, subfield);
-               if (item != NOFLAG && OBJ_FLAGGED(o, item))
-                 strcpy(str, "1");
-               else
-                 strcpy(str, "0");
-             } else
-               strcpy(str, "0");
-           }
-          break;
-        case 'l':
-          if (!strcasecmp(field, "level"))
-            snprintf(str, slen, "%d", GET_OBJ_LEVEL(o));
-          break;
-
-        case 'n':
-          if (!strcasecmp(field, "name")) {
-           if (!subfield || !*subfield)
-            snprintf(str, slen, "%s",  o->name);
-           else {
-            char blah[500];
-            sprintf(blah, "%s %s", o->name, subfield);
-            o->name = strdup(blah);
-           }
-          }
-          else if (!strcasecmp(field, "next_in_list")) {
-            if (o->next_content)
-              snprintf(str, slen,"%c%d",UID_CHAR, GET_ID(o->next_content));
-            else
-              *str = '\0';
-          }
-          break;
-        case 'r':
-          if (!strcasecmp(field, "room")) {
-            if (obj_room(o) != NOWHERE)
-              snprintf(str, slen,"%c%d",UID_CHAR, world[obj_room(o)].number + ROOM_ID_BASE);
-            else
-              *str = '\0';
-          }
-          break;
-        case 's':
-          if (!strcasecmp(field, "shortdesc")) {
-           if (!subfield || !*subfield)
-            snprintf(str, slen, "%s",  o->short_description);
-           else {
-            char blah[500];
-            sprintf(blah, "%s @wnicknamed @D(@C%s@D)@n", o->short_description, subfield);
-            o->short_description = strdup(blah);
-           }
-          }
-          else if (!strcasecmp(field, "setaffects")) {
-            if (subfield && *subfield) {
-              int ns;
-              if ((ns = check_flags_by_name_ar(GET_OBJ_PERM(o), NUM_AFF_FLAGS, subfield, affected_bits)) > 0) {
-                TOGGLE_BIT_AR(GET_OBJ_PERM(o), ns);
-                snprintf(str, slen, "1");
-              }
-            }
-          }
-          else if (!strcasecmp(field, "setextra")) {
-            if (subfield && *subfield) {
-              int ns;
-              if ((ns = check_flags_by_name_ar(GET_OBJ_EXTRA(o), NUM_ITEM_FLAGS, subfield, extra_bits)) > 0) {
-                TOGGLE_BIT_AR(GET_OBJ_EXTRA(o), ns);
-                snprintf(str, slen, "1");
-              }
-            }
-          }
-
-          else if (!strcasecmp(field, "size")) {
-            if (subfield && *subfield) {
-              int ns;
-              if ((ns = search_block(subfield, size_names, FALSE)) > -1) {
-                (o)->size = ns;
-              }
-            }
-          sprinttype(GET_OBJ_SIZE(o), size_names, str, slen);
-          }
-          break;
-        case 't':
-          if (!strcasecmp(field, "type"))
-            sprinttype(GET_OBJ_TYPE(o), item_types, str, slen);
-
-          else if (!strcasecmp(field, "timer"))
-            snprintf(str, slen, "%d", GET_OBJ_TIMER(o));
-          break;
-        case 'v':
-          if (!strcasecmp(field, "vnum"))
-            if (subfield && *subfield) {
-              snprintf(str, slen, "%d", (int)(GET_OBJ_VNUM(o) == atoi(subfield)));
-            } else {
-              snprintf(str, slen, "%d", GET_OBJ_VNUM(o));
-            }
-          else if (!strcasecmp(field, "val0"))
-            snprintf(str, slen, "%d", GET_OBJ_VAL(o, 0));
-
-          else if (!strcasecmp(field, "val1"))
-            snprintf(str, slen, "%d", GET_OBJ_VAL(o, 1));
-
-          else if (!strcasecmp(field, "val2"))
-            snprintf(str, slen, "%d", GET_OBJ_VAL(o, 2));
-
-          else if (!strcasecmp(field, "val3"))
-            snprintf(str, slen, "%d", GET_OBJ_VAL(o, 3));
-
-          else if (!strcasecmp(field, "val4"))
-            snprintf(str, slen, "%d", GET_OBJ_VAL(o, 4));
-
-          else if (!strcasecmp(field, "val5"))
-            snprintf(str, slen, "%d", GET_OBJ_VAL(o, 5));
-
-          else if (!strcasecmp(field, "val6"))
-            snprintf(str, slen, "%d", GET_OBJ_VAL(o, 6));
-
-          else if (!strcasecmp(field, "val7"))
-            snprintf(str, slen, "%d", GET_OBJ_VAL(o, 7));
-          break;
-        case 'w':
-          if (!strcasecmp(field, "weight")){
-            if (subfield && *subfield) {
-              int addition = atoi(subfield);
-              if (addition < 0 || addition > 0) {
-               GET_OBJ_WEIGHT(o) = MAX(0, addition + GET_OBJ_WEIGHT(o));
-              } else {
-               GET_OBJ_WEIGHT(o) = 0;
-              }
-            }
-            snprintf(str, slen, "%" I64T "", GET_OBJ_WEIGHT(o));
-          }
-
-          else if (!strcasecmp(field, "worn_by")) {
-            if (o->worn_by)
-              snprintf(str, slen,"%c%d",UID_CHAR, GET_ID(o->worn_by));
-            else
-              *str = '\0';
-          }
-          break;
-      } /* switch *field */
+      if ((func = dg_field_find(obj_fields, obj_field_index, field)))
+        func(go, type, NULL, o, NULL, vd, subfield, str, slen);
+      else if (LOWER(*field) == 'e')
+        objfield_extra_bits(go, type, NULL, o, NULL, vd, subfield, str, slen);
 
-
-      if (*str == '\x1') { /* no match in switch */
+      if (*str == '\x1') { /* no such field */
         if (SCRIPT(o)) { /* check for global var */
-          for (vd = (SCRIPT(o))->global_vars; vd; vd = vd->next)
-            if (!strcasecmp(vd->name, field))
-              break;
-          if (vd)
+          if ((vd = find_var(SCRIPT(o)->global_vars, field)))
             snprintf(str, slen, "%s", vd->value);
           else {
             *str = '\0';
@@ -1415,344 +2199,18 @@ in the vault (vnum: 453) now and then. you can just use
           script_log("Trigger: %s, Vnum %d, type %d. Trying to access Global var list of void. Apparently this has not been set up!",
                      GET_TRIG_NAME(trig), GET_TRIG_VNUM(trig), type);
         } else {
-          for (vd = (SCRIPT(r))->global_vars; vd; vd = vd->next)
-            if (!strcasecmp(vd->name, field))
-              break;
-          if (vd)
+          if ((vd = find_var(SCRIPT(r)->global_vars, field)))
             snprintf(str, slen, "%s", vd->value);
           else
             *str = '\0';
         }
       }
 
-      else if (!strcasecmp(field, "name"))
-        snprintf(str, slen, "%s",  r->name);
-
-      else if (!strcasecmp(field, "sector"))
-        sprinttype(r->sector_type, sector_types, str, slen);
-     
-      else if (!strcasecmp(field, "gravity"))
-        snprintf(str, slen,"%d",r->gravity);
-
-      else if (!strcasecmp(field, "vnum")) {
-        if (subfield && *subfield) {
-          snprintf(str, slen, "%d", (int)(r->number == atoi(subfield)));
-        } else {
-          snprintf(str, slen,"%d",r->number);
-        }
-      } else if (!strcasecmp(field, "contents")) {
-        if (subfield && *subfield) {
-          for (obj = r->contents; obj; obj = obj->next_content) {
-            if (GET_OBJ_VNUM(obj) == atoi(subfield)) {
-              /* arg given, found */
-              snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(obj));
-              return;
-            }
-          }
-          if (!obj)
-            *str = '\0'; /* arg given, not found */
-        } else { /* no arg given */
-          if (r->contents) {
-            snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(r->contents));
-          } else {
-            *str = '\0';
-          }
-        }
-      }
-
-      else if (!strcasecmp(field, "people")) {
-        if (r->people)
-          snprintf(str, slen, "%c%d", UID_CHAR, GET_ID(r->people));
-        else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "id")) {
-        room_rnum rnum = real_room(r->number);
-        if (rnum != NOWHERE)
-          snprintf(str, slen, "%d", world[rnum].number + ROOM_ID_BASE);
-        else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "weather")) {
-        const char *sky_look[] = {
-          "sunny",
-          "cloudy",
-          "rainy",
-          "lightning"
-        };
-
-        if (!IS_SET_AR(r->room_flags, ROOM_INDOORS))
-          snprintf(str, slen, "%s", sky_look[weather_info.sky]);
-        else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "fishing")) {
-       room_rnum thisroom = real_room(r->number);
-       if (ROOM_FLAGGED(thisroom, ROOM_FISHING))
-         snprintf(str, slen, "1");
-       else
-         snprintf(str, slen, "0");  
-      }
-      else if (!strcasecmp(field, "zonenumber"))
-        snprintf(str, slen, "%d",  zone_table[r->zone].number);
-      else if (!strcasecmp(field, "zonename"))
-        snprintf(str, slen, "%s",  zone_table[r->zone].name);
-      else if (!strcasecmp(field, "roomflag")) {
-        if (subfield && *subfield) {
-          room_rnum thisroom = real_room(r->number);
-          if (check_flags_by_name_ar(ROOM_FLAGS(thisroom), NUM_ROOM_FLAGS, subfield, room_bits) > 0)
-            snprintf(str, slen, "1");
-          else
-            snprintf(str, slen, "0");
-        } else
-          snprintf(str, slen, "0");
-      }
-      else if (!strcasecmp(field, "north")) {
-        if (R_EXIT(r, NORTH)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, NORTH)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, NORTH)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, NORTH)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, NORTH)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, NORTH)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, NORTH)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "east")) {
-        if (R_EXIT(r, EAST)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, EAST)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, EAST)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, EAST)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, EAST)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, EAST)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, EAST)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "south")) {
-        if (R_EXIT(r, SOUTH)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, SOUTH)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, SOUTH)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, SOUTH)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, SOUTH)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, SOUTH)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, SOUTH)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "west")) {
-        if (R_EXIT(r, WEST)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, WEST)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, WEST)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, WEST)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, WEST)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, WEST)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, WEST)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "up")) {
-        if (R_EXIT(r, UP)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, UP)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, UP)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, UP)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, UP)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, UP)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, UP)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "down")) {
-        if (R_EXIT(r, DOWN)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, DOWN)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, DOWN)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, DOWN)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, DOWN)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, DOWN)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, DOWN)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "northwest")) {
-        if (R_EXIT(r, NORTHWEST)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, NORTHWEST)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, NORTHWEST)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, NORTHWEST)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, NORTHWEST)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, NORTHWEST)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, NORTHWEST)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "northeast")) {
-        if (R_EXIT(r, NORTHEAST)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, NORTHEAST)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, NORTHEAST)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, NORTHEAST)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, NORTHEAST)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, NORTHEAST)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, NORTHEAST)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "southwest")) {
-        if (R_EXIT(r, SOUTHWEST)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, SOUTHWEST)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, SOUTHWEST)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, SOUTHWEST)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, SOUTHWEST)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, SOUTHWEST)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, SOUTHWEST)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "southeast")) {
-        if (R_EXIT(r, SOUTHEAST)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, SOUTHEAST)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, SOUTHEAST)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, SOUTHEAST)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, SOUTHEAST)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, SOUTHEAST)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, SOUTHEAST)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "inside")) {
-        if (R_EXIT(r, INDIR)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, INDIR)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, INDIR)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, INDIR)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, INDIR)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, INDIR)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, INDIR)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
-      else if (!strcasecmp(field, "outside")) {
-        if (R_EXIT(r, OUTDIR)) {
-          if (subfield && *subfield) {
-            if (!strcasecmp(subfield, "vnum"))
-              snprintf(str, slen, "%d", GET_ROOM_VNUM(R_EXIT(r, OUTDIR)->to_room));
-            else if (!strcasecmp(subfield, "key"))
-              snprintf(str, slen, "%d", R_EXIT(r, OUTDIR)->key);
-            else if (!strcasecmp(subfield, "bits"))
-              sprintbit(R_EXIT(r, OUTDIR)->exit_info ,exit_bits, str, slen);
-            else if (!strcasecmp(subfield, "room")) {
-              if (R_EXIT(r, OUTDIR)->to_room != NOWHERE)
-                snprintf(str, slen, "%c%d", UID_CHAR, world[R_EXIT(r, OUTDIR)->to_room].number + ROOM_ID_BASE);
-              else
-                *str = '\0';
-            }
-          } else /* no subfield - default to bits */
-            sprintbit(R_EXIT(r, OUTDIR)->exit_info ,exit_bits, str, slen);
-        } else
-          *str = '\0';
-      }
+      else if ((func = dg_field_find(room_fields, room_field_index, field)))
+        func(go, type, NULL, NULL, r, vd, subfield, str, slen);
       else {
         if (SCRIPT(r)) { /* check for global var */
-          for (vd = (SCRIPT(r))->global_vars; vd; vd = vd->next)
-            if (!strcasecmp(vd->name, field))
-              break;
-          if (vd)
+          if ((vd = find_var(SCRIPT(r)->global_vars, field)))
             snprintf(str, slen, "%s", vd->value);
           else {
             *str = '\0';
@@ -1841,6 +2299,7 @@ void var_subst(void *go, struct script_data *sc, trig_data *trig,
         for (field = p; *p && ((*p != '%')||(paren_count > 0) || (dots)); p++) {
           if (dots > 0) {
             *subfield_p = '\0';
+            TRIG_PROF_COUNT(substs);
             find_replacement(go, sc, trig, type, var, field, subfield, repl_str, sizeof(repl_str));
             if (*repl_str) {
               snprintf(tmp2, sizeof(tmp2), "eval tmpvr %s", repl_str); //temp var
@@ -1874,6 +2333,7 @@ void var_subst(void *go, struct script_data *sc, trig_data *trig,
         strcpy(subfield, tmp2);
       }
 
+      TRIG_PROF_COUNT(substs);
       find_replacement(go, sc, trig, type, var, field, subfield, repl_str, sizeof(repl_str));
 
       strncat(buf, repl_str, left);
@@ -1883,3 +2343,115 @@ void var_subst(void *go, struct script_data *sc, trig_data *trig,
     } /* else if *p .. */
   } /* while *p .. */
 }
+
+
+/*
+ * The old strcasecmp() chains, to measure the tables against: the text
+ * fields first, then for chars and objs the fields starting with the same
+ * letter (the chains were in a switch on it), and for rooms all of them.
+ */
+template <size_t N> static dg_field_func dg_field_scan(const struct dg_field (&fields)[N],
+                      const char *name, bool by_letter)
+{
+  size_t i;
+
+  for (i = 0; i < sizeof(text_fields) / sizeof(text_fields[0]); i++)
+    if (!strcasecmp(text_fields[i].name, name))
+      return (text_fields[i].func);
+
+  for (i = 0; i < N; i++)
+    if ((!by_letter || LOWER(*fields[i].name) == LOWER(*name)) && !strcasecmp(fields[i].name, name))
+      return (fields[i].func);
+  return (NULL);
+}
+
+
+#define FIELD_BENCH_ROUNDS	200
+
+/* Time both lookups of 'words' as fields of one kind of thing. */
+template <size_t N> static void dg_field_bench_run(struct char_data *ch, const char *label,
+                      const struct dg_field (&fields)[N], const struct dg_field_index<N> &idx,
+                      bool by_letter, std::vector<std::string> &words)
+{
+  unsigned long long start, scanned, hashed;
+  int r, known = 0, wrong = 0;
+  dg_field_func func;
+  uintptr_t sum = 0;
+
+  for (auto &w : words) {
+    if (!(func = dg_field_find(text_fields, text_field_index, w.c_str())))
+      func = dg_field_find(fields, idx, w.c_str());
+    if (func)
+      known++;
+    if (func != dg_field_scan(fields, w.c_str(), by_letter))
+      wrong++;
+  }
+
+  start = prof_clock();
+  for (r = 0; r < FIELD_BENCH_ROUNDS; r++)
+    for (auto &w : words)
+      sum += (uintptr_t) dg_field_scan(fields, w.c_str(), by_letter);
+  scanned = prof_clock() - start;
+
+  start = prof_clock();
+  for (r = 0; r < FIELD_BENCH_ROUNDS; r++)
+    for (auto &w : words) {
+      if (!(func = dg_field_find(text_fields, text_field_index, w.c_str())))
+        func = dg_field_find(fields, idx, w.c_str());
+      sum += (uintptr_t) func;
+    }
+  hashed = prof_clock() - start;
+
+  send_to_char(ch, "%-6s %6d %6d %5d  %10.1f  %10.1f  %6.1fx\r\n", label, (int) N, (int) words.size(), known,
+               (double) scanned / (FIELD_BENCH_ROUNDS * words.size()),
+               (double) hashed / (FIELD_BENCH_ROUNDS * words.size()),
+               hashed ? (double) scanned / hashed : 0.0);
+
+  if (wrong)
+    send_to_char(ch, "@R%d %s field lookup%s disagreed with the old chain!@n\r\n", wrong, label, wrong == 1 ? "" : "s");
+  if (sum == 1)	/* keep the loops from being optimised away */
+    send_to_char(ch, "\r\n");
+}
+
+
+/* Every %var.field% (and .field after that) in the loaded triggers. */
+static void dg_field_corpus(std::vector<std::string> &words)
+{
+  struct cmdlist_element *cl;
+  const char *p, *start;
+  int i;
+
+  for (i = 0; i < top_of_trigt; i++)
+    for (cl = trig_index[i]->proto->cmdlist; cl; cl = cl->next)
+      for (p = cl->cmd; (p = strchr(p, '%')); ) {
+        for (p++; isalnum(*p) || *p == '_'; p++);
+        while (*p == '.') {
+          for (start = ++p; isalnum(*p) || *p == '_'; p++);
+          if (p > start)
+            words.emplace_back(start, p - start);
+        }
+      }
+}
+
+
+void dg_field_bench(struct char_data *ch)
+{
+  std::vector<std::string> words;
+
+  dg_field_corpus(words);
+  if (words.empty()) {
+    for (auto &f : char_fields)
+      words.push_back(f.name);
+    for (auto &f : obj_fields)
+      words.push_back(f.name);
+    for (auto &f : room_fields)
+      words.push_back(f.name);
+    send_to_char(ch, "No fields in the loaded triggers; using the field tables.\r\n");
+  }
+
+  send_to_char(ch, "Field lookup over %d field references, ns per lookup:\r\n", (int) words.size());
+  send_to_char(ch, "%-6s %6s %6s %5s  %10s  %10s  %7s\r\n", "As", "Fields", "Words", "Known", "Old chain", "Hashed", "Speedup");
+  dg_field_bench_run(ch, "char", char_fields, char_field_index, true, words);
+  dg_field_bench_run(ch, "obj", obj_fields, obj_field_index, true, words);
+  dg_field_bench_run(ch, "room", room_fields, room_field_index, false, words);
+}
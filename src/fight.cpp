@@ -25,6 +25,7 @@
 #include "class.h"
 #include "dg_scripts.h"
 #include "objsave.h"
+#include "keywords.h"
 
 /* Structures */
 struct char_data *combat_list = NULL;	/* head of l-list of fighting chars */
@@ -1582,6 +1583,7 @@ static void handle_corpse_condition(struct obj_data *corpse, struct char_data *c
      *buf2 = '\0';
      snprintf(buf2, sizeof(buf2), "headless corpse %s", GET_NAME(ch));
      corpse->name = strdup(buf2);
+     obj_keywords_refresh(corpse);
       
      *descBuf = '\0'; 
      snprintf(descBuf, sizeof(descBuf), "The headless corpse of %s is lying here", GET_NAME(ch));
@@ -1596,6 +1598,7 @@ static void handle_corpse_condition(struct obj_data *corpse, struct char_data *c
      *buf2 = '\0';
      snprintf(buf2, sizeof(buf2), "half corpse %s", GET_NAME(ch));
      corpse->name = strdup(buf2);
+     obj_keywords_refresh(corpse);
       
      *descBuf = '\0'; 
      snprintf(descBuf, sizeof(descBuf), "Half of %s's corpse is lying here", GET_NAME(ch));
@@ -1609,6 +1612,7 @@ static void handle_corpse_condition(struct obj_data *corpse, struct char_data *c
      *buf2 = '\0';
      snprintf(buf2, sizeof(buf2), "burnt chunks corpse %s", GET_NAME(ch));
      corpse->name = strdup(buf2);
+     obj_keywords_refresh(corpse);
       
      *descBuf = '\0'; 
      snprintf(descBuf, sizeof(descBuf), "The burnt chunks of %s's corpse are scattered here", GET_NAME(ch));
@@ -1622,6 +1626,7 @@ static void handle_corpse_condition(struct obj_data *corpse, struct char_data *c
      *buf2 = '\0';
      snprintf(buf2, sizeof(buf2), "beaten bloody corpse %s", GET_NAME(ch));
      corpse->name = strdup(buf2);
+     obj_keywords_refresh(corpse);
       
      *descBuf = '\0'; 
      snprintf(descBuf, sizeof(descBuf), "The bloody and beaten corpse of %s is lying here", GET_NAME(ch));
@@ -1634,6 +1639,7 @@ static void handle_corpse_condition(struct obj_data *corpse, struct char_data *c
    default:
      snprintf(buf2, sizeof(buf2), "corpse %s", GET_NAME(ch));
      corpse->name = strdup(buf2);
+     obj_keywords_refresh(corpse);
       
      *descBuf = '\0'; 
      snprintf(descBuf, sizeof(descBuf), "The corpse of %s is lying here", GET_NAME(ch));
@@ -1726,6 +1732,7 @@ static void make_corpse(struct char_data *ch, struct char_data *tch)
      sprintf(nick3, "@wA @Rraw %s@R steak@w is lying here@n", GET_NAME(ch));
      meat->short_description = strdup(nick);
      meat->name = strdup(nick2);
+     obj_keywords_refresh(meat);
      meat->description = strdup(nick3);
      GET_OBJ_MATERIAL(meat) = 14;
     }
@@ -1854,14 +1861,10 @@ static void final_combat_resolve(struct char_data *ch)
     }
     if (!IS_NPC(ch) && GET_CLONES(ch) > 0) {
      struct char_data *clone = NULL;
-     for (clone = character_list; clone; clone = clone->next) {
-       if (IS_NPC(clone)) {
-        if (GET_MOB_VNUM(clone) == 25) {
-         if (GET_ORIGINAL(clone) == ch) {
-          handle_multi_merge(clone);
-         }
-        }
-      }
+     for (clone = mob_instances(25); clone; clone = clone->next_instance) {
+       if (GET_ORIGINAL(clone) == ch) {
+        handle_multi_merge(clone);
+       }
      }
     }
     if (CARRYING(ch)) {
@@ -10,7 +10,7 @@
 #include "genolc.h"
 #include "shop.h"
 #include "genzon.h"
-#include "htree.h"
+#include "vnum_index.h"
 #include "guild.h"
 #include "dg_scripts.h"
 #include "handler.h"
@@ -66,13 +66,14 @@ int add_mobile(struct char_data *mob, mob_vnum vnum)
       mob_index[i].vnum = vnum;
       mob_index[i].number = 0;
       mob_index[i].func = 0;
+      mob_index[i].mobs = NULL;
       found = i;
       break;
     }
     mob_index[i] = mob_index[i - 1];
     mob_proto[i] = mob_proto[i - 1];
     mob_proto[i].nr++;
-    htree_add(mob_htree, mob_index[i].vnum, i);
+    vnum_index_add(mob_vindex, mob_index[i].vnum, i);
   }
   if (!found) {
     mob_proto[0] = *mob;
@@ -81,8 +82,9 @@ int add_mobile(struct char_data *mob, mob_vnum vnum)
     mob_index[0].vnum = vnum;
     mob_index[0].number = 0;
     mob_index[0].func = 0;
-    htree_add(mob_htree, mob_index[0].vnum, 0);
+    mob_index[0].mobs = NULL;
   }
+  vnum_index_add(mob_vindex, vnum, found);
 
   log("GenOLC: add_mobile: Added mobile %d at index #%d.", vnum, found);
 
@@ -132,10 +134,9 @@ void extract_mobile_all(mob_vnum vnum)
 {
   struct char_data *next, *ch;
 
-  for (ch = character_list; ch; ch = next) {
-    next = ch->next;
-    if (GET_MOB_VNUM(ch) == vnum)
-      extract_char(ch);
+  for (ch = mob_instances(vnum); ch; ch = next) {
+    next = ch->next_instance;
+    extract_char(ch);
   }
 }
 
@@ -157,11 +158,20 @@ int delete_mobile(mob_rnum refpt)
 
   vnum = mob_index[refpt].vnum;
   extract_mobile_all(vnum);
+  vnum_index_del(mob_vindex, vnum);
+
+  /*
+   * They're only marked for extraction, and their rnum is about to go, so
+   * take them off the instance list now.
+   */
+  while (mob_index[refpt].mobs)
+    mob_instance_remove(mob_index[refpt].mobs);
 
   for (counter = refpt; counter < top_of_mobt; counter++) {
     mob_index[counter] = mob_index[counter + 1];
     mob_proto[counter] = mob_proto[counter + 1];
     mob_proto[counter].nr = counter;
+    vnum_index_add(mob_vindex, mob_index[counter].vnum, counter);
   }
 
   top_of_mobt--;
@@ -10,9 +10,10 @@
 #include "genzon.h"
 #include "utils.h"
 #include "handler.h"
-#include "htree.h"
+#include "vnum_index.h"
 #include "dg_olc.h"
 #include "shop.h"
+#include "keywords.h"
 
 static int copy_object_main(struct obj_data *to, struct obj_data *from, int free_object);
 
@@ -70,7 +71,18 @@ int update_objects(struct obj_data *refobj)
     obj->in_obj = swap.in_obj;
     obj->contains = swap.contains;
     obj->next_content = swap.next_content;
+    obj->prev_content = swap.prev_content;
     obj->next = swap.next;
+    obj->prev = swap.prev;
+    obj->next_instance = swap.next_instance;
+    obj->prev_instance = swap.prev_instance;
+    memcpy(obj->active_pos, swap.active_pos, sizeof(obj->active_pos));
+    obj->trig_types = swap.trig_types;
+    obj->trig_room = swap.trig_room;
+    obj->keywords = swap.keywords;
+    obj->list_seq = swap.list_seq;
+    room_trig_sync(obj, OBJ_TRIGGER);
+    obj_keywords_refresh(obj);
   }
 
   return count;
@@ -161,7 +173,7 @@ obj_rnum insert_object(struct obj_data *obj, obj_vnum ovnum)
     obj_index[i] = obj_index[i - 1];
     obj_proto[i] = obj_proto[i - 1];
     obj_proto[i].item_number = i;
-    htree_add(obj_htree, obj_index[i].vnum, i);
+    vnum_index_add(obj_vindex, obj_index[i].vnum, i);
   }
 
   /* Not found, place at 0. */
@@ -183,11 +195,12 @@ obj_rnum index_object(struct obj_data *obj, obj_vnum ovnum, obj_rnum ornum)
   obj_index[ornum].vnum = ovnum;
   obj_index[ornum].number = 0;
   obj_index[ornum].func = NULL;
+  obj_index[ornum].objs = NULL;
 
   copy_object_preserve(&obj_proto[ornum], obj);
   obj_proto[ornum].in_room = NOWHERE;
 
-  htree_add(obj_htree, obj_index[ornum].vnum, ornum);
+  vnum_index_add(obj_vindex, obj_index[ornum].vnum, ornum);
 
   return ornum;
 }
@@ -459,7 +472,7 @@ int delete_object(obj_rnum rnum)
 
   zrnum = real_zone_by_thing(GET_OBJ_VNUM(obj));
 
-  htree_del(obj_htree, obj->item_number);
+  vnum_index_del(obj_vindex, GET_OBJ_VNUM(obj));
 
   /* This is something you might want to read about in the logs. */
   log("GenOLC: delete_object: Deleting object #%d (%s).", GET_OBJ_VNUM(obj), obj->short_description);
@@ -504,6 +517,7 @@ int delete_object(obj_rnum rnum)
     obj_index[i] = obj_index[i + 1];
     obj_proto[i] = obj_proto[i + 1];
     obj_proto[i].item_number = i;
+    vnum_index_add(obj_vindex, obj_index[i].vnum, i);
   }
 
   top_of_objt--;
@@ -15,7 +15,7 @@
 #include "genzon.h"
 #include "shop.h"
 #include "dg_olc.h"
-#include "htree.h"
+#include "vnum_index.h"
 
 
 /*
@@ -26,6 +26,7 @@ room_rnum add_room(struct room_data *room)
 {
   struct char_data *tch;
   struct obj_data *tobj;
+  struct trig_presence trig;
   int j, found = FALSE;
   room_rnum i;
 
@@ -37,9 +38,11 @@ room_rnum add_room(struct room_data *room)
       extract_script(&world[i], WLD_TRIGGER);
     tch = world[i].people; 
     tobj = world[i].contents;
+    trig = world[i].trig;
     copy_room(&world[i], room);
     world[i].people = tch;
     world[i].contents = tobj;
+    world[i].trig = trig;
     add_to_save_list(zone_table[room->zone].number, SL_WLD);
     log("GenOLC: add_room: Updated existing room #%d.", room->number);
     return i;
@@ -67,12 +70,14 @@ room_rnum add_room(struct room_data *room)
       for (tobj = world[i].contents; tobj; tobj = tobj->next_content)
 	IN_ROOM(tobj) += (IN_ROOM(tobj) != NOWHERE);
     }
-    htree_add(room_htree, world[i].number, i);
+    vnum_index_add(room_vindex, world[i].number, i);
   }
   if (!found) {
     world[0] = *room;	/* Last place, in front. */
     copy_room_strings(&world[0], room);
   }
+  memset(&world[found].trig, 0, sizeof(world[found].trig));
+  vnum_index_add(room_vindex, room->number, found);
 
   log("GenOLC: add_room: Added room %d at index #%d.", room->number, found);
 
@@ -146,8 +151,8 @@ int delete_room(room_rnum rnum)
 
   add_to_save_list(zone_table[room->zone].number, SL_WLD);
 
-  /* remove from realnum lookup tree */
-  htree_del(room_htree, room->number);
+  /* remove from realnum lookup index */
+  vnum_index_del(room_vindex, room->number);
 
   /* This is something you might want to read about in the logs. */
   log("GenOLC: delete_room: Deleting room #%d (%s).", room->number, room->name);
@@ -263,6 +268,7 @@ int delete_room(room_rnum rnum)
   for (i = rnum; i < top_of_world; i++) {
     world[i] = world[i + 1];
     update_wait_events(&world[i], &world[i+1]);
+    vnum_index_add(room_vindex, world[i].number, i);
 
     for (ppl = world[i].people; ppl; ppl = ppl->next_in_room)
       IN_ROOM(ppl) -= (IN_ROOM(ppl) != NOWHERE);	/* Redundant check? */
@@ -252,6 +252,9 @@ zone_rnum create_new_zone(zone_vnum vzone_num, room_vnum bottom, room_vnum top,
     else
       world[i].zone = real_zone_by_thing(GET_ROOM_VNUM(i)); 
 
+  /* Zone rnums have shifted under the occupancy counts; start them over. */
+  zone_occupancy_rebuild();
+
   add_to_save_list(zone->number, SL_ZON);
   return rznum;
 }
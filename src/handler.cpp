@@ -22,9 +22,12 @@
 #include "fight.h"
 #include "races.h"
 #include "act.informative.h"
+#include "keywords.h"
+#include "pool.h"
 
 /* local vars */
-static int extractions_pending = 0;
+static struct char_data *extract_queue = NULL;	/* for extract_pending_chars() */
+static struct char_data **extract_tail = &extract_queue;
 
 /* external vars */
 
@@ -48,12 +51,9 @@ SPECIAL(shop_keeper);
 
 /* For Getting An Intro Name */
 const char *get_i_name(struct char_data *ch, struct char_data *vict) {
-  char fname[40], filler[50], scrap[100], line[256];
   static char name[50];
-  int known = FALSE;
-  FILE *fl;
 
-  /* Read Introduction File */
+  /* Read Introduction Memory */
   if (vict == NULL) {
     return ("");
   }
@@ -66,27 +66,17 @@ const char *get_i_name(struct char_data *ch, struct char_data *vict) {
     return ("");
   }
 
-  if (!get_filename(fname, sizeof(fname), INTRO_FILE, GET_NAME(ch))) {
-    return (RACE(vict));
-  }
-  else if (!(fl = fopen(fname, "r"))) {
+  if (!load_intro_memory(ch)) {
     return (RACE(vict));
   }
 
-  while (!feof(fl)) {
-    get_line(fl, line);
-    sscanf(line, "%s %s\n", filler, scrap);
-    if (!strcasecmp(GET_NAME(vict), filler)) {
-     sprintf(name, "%s", scrap);
-     known = TRUE;
-    }
-  }
-  fclose(fl);
+  auto known = ch->recog->intro.find(std::string_view(GET_NAME(vict)));
 
-   if (known == TRUE)
-    return (name);
-   else
+  if (known == ch->recog->intro.end())
     return (RACE(vict));
+
+  snprintf(name, sizeof(name), "%s", known->second.c_str());
+  return (name);
 }
 
 char *fname(const char *namelist)
@@ -506,12 +496,10 @@ void affect_to_char(struct char_data *ch, struct affected_type *af)
 {
   struct affected_type *affected_alloc;
 
-  CREATE(affected_alloc, struct affected_type, 1);
+  POOL_CREATE(affected_alloc, struct affected_type, affect_pool);
 
-  if (!ch->affected) {
-    ch->next_affect = affect_list;
-    affect_list = ch;
-  }
+  if (!ch->affected)
+    LINK_TO_LIST(ch, affect_list, next_affect, prev_affect);
   *affected_alloc = *af;
   affected_alloc->next = ch->affected;
   ch->affected = affected_alloc;
@@ -538,11 +526,10 @@ void affect_remove(struct char_data *ch, struct affected_type *af)
 
   affect_modify(ch, af->location, af->modifier, af->specific, af->bitvector, FALSE);
   REMOVE_FROM_LIST(af, ch->affected, next, cmtemp);
-  free(af);
+  POOL_FREE(af, affect_pool);
   affect_total(ch);
   if (!ch->affected) {
-    struct char_data *temp;
-    REMOVE_FROM_LIST(ch, affect_list, next_affect, temp);
+    UNLINK_FROM_LIST(ch, affect_list, next_affect, prev_affect);
     ch->next_affect = NULL;
   }
 }
@@ -641,10 +628,139 @@ void affect_join(struct char_data *ch, struct affected_type *af,
 }
 
 
+/*
+ * Each room counts the trigger types among the mobs in it and among the
+ * objects lying in it or carried or worn by someone in it, so the command,
+ * speech, greet and leave dispatchers can tell at once that nobody here
+ * has such a trigger and skip walking the room.  A scripted mob or object
+ * remembers which types it added to which room (by vnum, since redit can
+ * renumber the world) and takes exactly those back off when it leaves.
+ * Anything that changes a mob's or object's SCRIPT_TYPES calls
+ * room_trig_sync() to have it counted again, and filed again for the
+ * random and time trigger checks.
+ */
+static void room_trig_count(unsigned short *count, long *types, long bits, int delta)
+{
+  int i;
+
+  for (i = 0; bits; i++, bits >>= 1) {
+    if (!(bits & 1))
+      continue;
+    if (delta > 0)
+      count[i]++;
+    else if (count[i])
+      count[i]--;
+    if (count[i])
+      SET_BIT(*types, 1L << i);
+    else
+      REMOVE_BIT(*types, 1L << i);
+  }
+}
+
+
+static void obj_trig_leave(struct obj_data *obj)
+{
+  room_rnum room;
+
+  if (!obj->trig_types)
+    return;
+  if ((room = real_room(obj->trig_room)) != NOWHERE)
+    room_trig_count(world[room].trig.obj_count, &world[room].trig.obj_types, obj->trig_types, -1);
+  obj->trig_types = 0;
+}
+
+
+static void obj_trig_enter(struct obj_data *obj, room_rnum room)
+{
+  obj_trig_leave(obj);
+  if (room == NOWHERE || !SCRIPT(obj) || !SCRIPT_TYPES(SCRIPT(obj)))
+    return;
+  /* a bad flag in a trigger file can set bits past the counts */
+  obj->trig_types = SCRIPT_TYPES(SCRIPT(obj)) & ((1L << NUM_OTRIG_TYPES) - 1);
+  obj->trig_room = GET_ROOM_VNUM(room);
+  room_trig_count(world[room].trig.obj_count, &world[room].trig.obj_types, obj->trig_types, 1);
+}
+
+
+static void mob_trig_leave(struct char_data *ch)
+{
+  room_rnum room;
+
+  if (!ch->trig_types)
+    return;
+  if ((room = real_room(ch->trig_room)) != NOWHERE)
+    room_trig_count(world[room].trig.mob_count, &world[room].trig.mob_types, ch->trig_types, -1);
+  ch->trig_types = 0;
+}
+
+
+static void mob_trig_enter(struct char_data *ch, room_rnum room)
+{
+  mob_trig_leave(ch);
+  if (room == NOWHERE || !SCRIPT(ch) || !SCRIPT_TYPES(SCRIPT(ch)))
+    return;
+  ch->trig_types = SCRIPT_TYPES(SCRIPT(ch)) & ((1L << NUM_MTRIG_TYPES) - 1);
+  ch->trig_room = GET_ROOM_VNUM(room);
+  room_trig_count(world[room].trig.mob_count, &world[room].trig.mob_types, ch->trig_types, 1);
+}
+
+
+/* A character and everything it holds arrive in, or leave, a room. */
+static void char_trig_move(struct char_data *ch, room_rnum room)
+{
+  struct obj_data *obj;
+  int i;
+
+  if (room == NOWHERE)
+    mob_trig_leave(ch);
+  else
+    mob_trig_enter(ch, room);
+
+  for (i = 0; i < NUM_WEARS; i++)
+    if (GET_EQ(ch, i)) {
+      if (room == NOWHERE)
+        obj_trig_leave(GET_EQ(ch, i));
+      else
+        obj_trig_enter(GET_EQ(ch, i), room);
+    }
+
+  for (obj = ch->carrying; obj; obj = obj->next_content) {
+    if (room == NOWHERE)
+      obj_trig_leave(obj);
+    else
+      obj_trig_enter(obj, room);
+  }
+}
+
+
+/* Recount a mob or object whose script's trigger types may have changed. */
+void room_trig_sync(void *thing, int type)
+{
+  struct char_data *ch;
+  struct obj_data *obj;
+
+  periodic_trig_sync(thing, type);
+
+  if (type == MOB_TRIGGER) {
+    ch = (struct char_data *) thing;
+    mob_trig_enter(ch, IN_ROOM(ch));
+  } else if (type == OBJ_TRIGGER) {
+    obj = (struct obj_data *) thing;
+    if (IN_ROOM(obj) != NOWHERE)
+      obj_trig_enter(obj, IN_ROOM(obj));
+    else if (obj->carried_by)
+      obj_trig_enter(obj, IN_ROOM(obj->carried_by));
+    else if (obj->worn_by)
+      obj_trig_enter(obj, IN_ROOM(obj->worn_by));
+    else
+      obj_trig_leave(obj);
+  }
+}
+
+
 /* move a player out of a room */
 void char_from_room(struct char_data *ch)
 {
-  struct char_data *temp;
   int i;
 
   if (ch == NULL || IN_ROOM(ch) == NOWHERE) {
@@ -666,9 +782,11 @@ void char_from_room(struct char_data *ch)
  if (PLR_FLAGGED(ch, PLR_AURALIGHT))
    world[IN_ROOM(ch)].light--;
 
-  REMOVE_FROM_LIST(ch, world[IN_ROOM(ch)].people, next_in_room, temp);
+  char_trig_move(ch, NOWHERE);
+  UNLINK_FROM_LIST(ch, world[IN_ROOM(ch)].people, next_in_room, prev_in_room);
   IN_ROOM(ch) = NOWHERE;
   ch->next_in_room = NULL;
+  zone_occupancy_sync(ch);
 }
 
 
@@ -681,9 +799,11 @@ void char_to_room(struct char_data *ch, room_rnum room)
     log("SYSERR: Illegal value(s) passed to char_to_room. (Room: %d/%d Ch: %p",
 		room, top_of_world, ch);
   else {
-    ch->next_in_room = world[room].people;
-    world[room].people = ch;
+    LINK_TO_LIST(ch, world[room].people, next_in_room, prev_in_room);
     IN_ROOM(ch) = room;
+    zone_occupancy_sync(ch);
+    char_trig_move(ch, room);
+    char_keywords_refresh(ch);
 
     for (i = 0; i < NUM_WEARS; i++)
       if (GET_EQ(ch, i))
@@ -713,10 +833,11 @@ void char_to_room(struct char_data *ch, room_rnum room)
 void obj_to_char(struct obj_data *object, struct char_data *ch)
 {
   if (object && ch) {
-    object->next_content = ch->carrying;
-    ch->carrying = object;
+    LINK_TO_LIST(object, ch->carrying, next_content, prev_content);
     object->carried_by = ch;
     IN_ROOM(object) = NOWHERE;
+    obj_trig_enter(object, IN_ROOM(ch));
+    obj_keywords_refresh(object);
     IS_CARRYING_W(ch) += GET_OBJ_WEIGHT(object);
     IS_CARRYING_N(ch)++;
     if ((GET_KAIOKEN(ch) <= 0 && !AFF_FLAGGED(ch, AFF_METAMORPH)) && !OBJ_FLAGGED(object, ITEM_THROW)) {
@@ -745,13 +866,12 @@ void obj_to_char(struct obj_data *object, struct char_data *ch)
 /* take an object from a char */
 void obj_from_char(struct obj_data *object)
 {
-  struct obj_data *temp;
-
   if (object == NULL) {
     log("SYSERR: NULL object passed to obj_from_char.");
     return;
   }
-  REMOVE_FROM_LIST(object, object->carried_by->carrying, next_content, temp);
+  UNLINK_FROM_LIST(object, object->carried_by->carrying, next_content, prev_content);
+  obj_trig_leave(object);
 
   /* set flag for crash-save system, but not on mobs! */
   if (!IS_NPC(object->carried_by))
@@ -853,6 +973,8 @@ void equip_char(struct char_data *ch, struct obj_data *obj, int pos)
   GET_EQ(ch, pos) = obj;
   obj->worn_by = ch;
   obj->worn_on = pos;
+  obj_trig_enter(obj, IN_ROOM(ch));
+  obj_keywords_refresh(obj);
 
   if (GET_OBJ_TYPE(obj) == ITEM_ARMOR)
     GET_ARMOR(ch) += apply_ac(ch, pos);
@@ -888,6 +1010,7 @@ struct obj_data *unequip_char(struct char_data *ch, int pos)
   obj = GET_EQ(ch, pos);
   obj->worn_by = NULL;
   obj->worn_on = -1;
+  obj_trig_leave(obj);
 
   if (GET_OBJ_TYPE(obj) == ITEM_ARMOR)
     GET_ARMOR(ch) -= apply_ac(ch, pos);
@@ -954,13 +1077,169 @@ struct obj_data *get_obj_in_list_num(int num, struct obj_data *list)
 /* search the entire world for an object number, and return a pointer  */
 struct obj_data *get_obj_num(obj_rnum nr)
 {
-  struct obj_data *i;
+  if (nr == NOTHING || nr > top_of_objt)
+    return (NULL);
 
-  for (i = object_list; i; i = i->next)
-    if (GET_OBJ_RNUM(i) == nr)
-      return (i);
+  return (obj_index[nr].objs);
+}
 
-  return (NULL);
+
+/*
+ * Every live object and mob made from a prototype is also on a list of
+ * the others made from it, headed in its obj_index or mob_index entry, so
+ * code looking for a few vnums needn't walk all of object_list or
+ * character_list.  read_object() and read_mobile() put them on, and
+ * extract_obj() and extract_char_final() take them off.  Lists are newest
+ * first, the same order the whole-world lists are in.
+ */
+void obj_instance_add(struct obj_data *obj)
+{
+  struct index_data *idx;
+
+  obj->next_instance = obj->prev_instance = NULL;
+  if (GET_OBJ_RNUM(obj) == NOTHING)
+    return;
+
+  idx = &obj_index[GET_OBJ_RNUM(obj)];
+  if ((obj->next_instance = idx->objs))
+    idx->objs->prev_instance = obj;
+  idx->objs = obj;
+}
+
+
+void obj_instance_remove(struct obj_data *obj)
+{
+  if (obj->prev_instance)
+    obj->prev_instance->next_instance = obj->next_instance;
+  else if (GET_OBJ_RNUM(obj) != NOTHING && obj_index[GET_OBJ_RNUM(obj)].objs == obj)
+    obj_index[GET_OBJ_RNUM(obj)].objs = obj->next_instance;
+  else
+    return;	/* wasn't on one */
+
+  if (obj->next_instance)
+    obj->next_instance->prev_instance = obj->prev_instance;
+  obj->next_instance = obj->prev_instance = NULL;
+}
+
+
+/* The newest live object of a vnum; follow next_instance for the rest. */
+struct obj_data *obj_instances(obj_vnum vnum)
+{
+  obj_rnum rnum = real_object(vnum);
+
+  return (rnum == NOTHING ? NULL : obj_index[rnum].objs);
+}
+
+
+/*
+ * Objects that need an update to visit them every few pulses, like ki
+ * attacks in flight, are put in one of the active sets when they start
+ * ticking, so the update walks a short vector instead of object_list.
+ * Each object remembers its slot, and leaving a set moves the last
+ * object into the hole.  While an update has a set locked, leaving it
+ * just empties the slot; the holes are filled when it's unlocked, so the
+ * walk neither skips anything nor sees a freed object.
+ */
+std::vector<struct obj_data *> active_objs[NUM_ACTIVE_SETS];
+static int active_locks[NUM_ACTIVE_SETS];
+static bool active_holes[NUM_ACTIVE_SETS];
+
+
+void obj_activate(struct obj_data *obj, int set)
+{
+  if (obj->active_pos[set])
+    return;
+
+  active_objs[set].push_back(obj);
+  obj->active_pos[set] = active_objs[set].size();
+}
+
+
+static void active_remove_slot(int set, size_t slot)
+{
+  std::vector<struct obj_data *> &objs = active_objs[set];
+
+  objs[slot] = objs.back();
+  objs.pop_back();
+  if (slot < objs.size() && objs[slot])
+    objs[slot]->active_pos[set] = slot + 1;
+}
+
+
+void obj_deactivate(struct obj_data *obj, int set)
+{
+  size_t slot;
+
+  if (!obj->active_pos[set])
+    return;
+
+  slot = obj->active_pos[set] - 1;
+  obj->active_pos[set] = 0;
+
+  if (active_locks[set]) {
+    active_objs[set][slot] = NULL;
+    active_holes[set] = TRUE;
+  } else
+    active_remove_slot(set, slot);
+}
+
+
+void active_lock(int set)
+{
+  active_locks[set]++;
+}
+
+
+void active_unlock(int set)
+{
+  size_t i;
+
+  if (--active_locks[set] || !active_holes[set])
+    return;
+
+  /* From the end, so whatever fills a hole has already been checked. */
+  for (i = active_objs[set].size(); i-- > 0; )
+    if (!active_objs[set][i])
+      active_remove_slot(set, i);
+  active_holes[set] = FALSE;
+}
+
+
+void mob_instance_add(struct char_data *ch)
+{
+  struct index_data *idx;
+
+  ch->next_instance = ch->prev_instance = NULL;
+  if (GET_MOB_RNUM(ch) == NOBODY)
+    return;
+
+  idx = &mob_index[GET_MOB_RNUM(ch)];
+  if ((ch->next_instance = idx->mobs))
+    idx->mobs->prev_instance = ch;
+  idx->mobs = ch;
+}
+
+
+void mob_instance_remove(struct char_data *ch)
+{
+  if (ch->prev_instance)
+    ch->prev_instance->next_instance = ch->next_instance;
+  else if (GET_MOB_RNUM(ch) != NOBODY && mob_index[GET_MOB_RNUM(ch)].mobs == ch)
+    mob_index[GET_MOB_RNUM(ch)].mobs = ch->next_instance;
+  else
+    return;	/* wasn't on one */
+
+  if (ch->next_instance)
+    ch->next_instance->prev_instance = ch->prev_instance;
+  ch->next_instance = ch->prev_instance = NULL;
+}
+
+
+struct char_data *mob_instances(mob_vnum vnum)
+{
+  mob_rnum rnum = real_mobile(vnum);
+
+  return (rnum == NOBODY ? NULL : mob_index[rnum].mobs);
 }
 
 
@@ -980,7 +1259,7 @@ struct char_data *get_char_room(char *name, int *number, room_rnum room)
     return (NULL);
 
   for (i = world[room].people; i && *number; i = i->next_in_room)
-    if (isname(name, i->name))
+    if (isname_char(name, i))
       if (--(*number) == 0)
 	return (i);
 
@@ -992,13 +1271,10 @@ struct char_data *get_char_room(char *name, int *number, room_rnum room)
 /* search all over the world for a char num, and return a pointer if found */
 struct char_data *get_char_num(mob_rnum nr)
 {
-  struct char_data *i;
-
-  for (i = character_list; i; i = i->next)
-    if (GET_MOB_RNUM(i) == nr)
-      return (i);
+  if (nr == NOBODY || nr > top_of_mobt)
+    return (NULL);
 
-  return (NULL);
+  return (mob_index[nr].mobs);
 }
 
 
@@ -1022,10 +1298,11 @@ void obj_to_room(struct obj_data *object, room_rnum room)
     if (room == real_room(80)) {
      auc_load(object);
     }
-    object->next_content = world[room].contents;
-    world[room].contents = object;
+    LINK_TO_LIST(object, world[room].contents, next_content, prev_content);
     IN_ROOM(object) = room;
     object->carried_by = NULL;
+    obj_trig_enter(object, room);
+    obj_keywords_refresh(object);
     GET_LAST_LOAD(object) = time(0);
     if (GET_OBJ_TYPE(object) == ITEM_VEHICLE && !OBJ_FLAGGED(object, ITEM_UNBREAKABLE) && GET_OBJ_VNUM(object) > 19199) {
       SET_BIT_AR(GET_OBJ_EXTRA(object), ITEM_UNBREAKABLE);
@@ -1055,6 +1332,7 @@ void obj_to_room(struct obj_data *object, room_rnum room)
         }
         sprintf(nick3, "%s is resting here@w", nick2);
         vehicle->name = strdup(nick);
+        obj_keywords_refresh(vehicle);
         vehicle->short_description = strdup(nick2);
         vehicle->description = strdup(nick3);
        }
@@ -1096,8 +1374,6 @@ void obj_to_room(struct obj_data *object, room_rnum room)
 /* Take an object from a room */
 void obj_from_room(struct obj_data *object)
 {
-  struct obj_data *temp;
-
   if (!object || IN_ROOM(object) == NOWHERE) {
     log("SYSERR: NULL object (%p) or obj not in a room (%d) passed to obj_from_room",
 	object, IN_ROOM(object));
@@ -1117,7 +1393,8 @@ void obj_from_room(struct obj_data *object)
    GET_OBJ_POSTTYPE(object) = 0;
   }
 
-  REMOVE_FROM_LIST(object, world[IN_ROOM(object)].contents, next_content, temp);
+  UNLINK_FROM_LIST(object, world[IN_ROOM(object)].contents, next_content, prev_content);
+  obj_trig_leave(object);
 
   if (ROOM_FLAGGED(IN_ROOM(object), ROOM_HOUSE))
     SET_BIT_AR(ROOM_FLAGS(IN_ROOM(object)), ROOM_HOUSE_CRASH);
@@ -1137,9 +1414,9 @@ void obj_to_obj(struct obj_data *obj, struct obj_data *obj_to)
     return;
   }
 
-  obj->next_content = obj_to->contains;
-  obj_to->contains = obj;
+  LINK_TO_LIST(obj, obj_to->contains, next_content, prev_content);
   obj->in_obj = obj_to;
+  obj_keywords_refresh(obj);
   tmp_obj = obj->in_obj;
 
   /* Only add weight to container, or back to carrier for non-eternal
@@ -1171,7 +1448,7 @@ void obj_from_obj(struct obj_data *obj)
   }
   obj_from = obj->in_obj;
   temp = obj->in_obj;
-  REMOVE_FROM_LIST(obj, obj_from->contains, next_content, temp);
+  UNLINK_FROM_LIST(obj, obj_from->contains, next_content, prev_content);
 
   /* Subtract weight from containers container */
   /* Only worry about weight for non-eternal containers
@@ -1210,8 +1487,8 @@ void object_list_new_owner(struct obj_data *list, struct char_data *ch)
 /* Extract an object from the world */
 void extract_obj(struct obj_data *obj)
 {
-  struct obj_data *temp;
   struct char_data *ch;
+  int i;
 
   if (obj->worn_by != NULL)
     if (unequip_char(obj->worn_by, obj->worn_on) != obj)
@@ -1252,7 +1529,11 @@ void extract_obj(struct obj_data *obj)
   while (obj->contains)
     extract_obj(obj->contains);
 
-  REMOVE_FROM_LIST(obj, object_list, next, temp);
+  UNLINK_FROM_LIST(obj, object_list, next, prev);
+  keyword_unfile_obj(obj);
+  obj_instance_remove(obj);
+  for (i = 0; i < NUM_ACTIVE_SETS; i++)
+    obj_deactivate(obj, i);
 
   if (GET_OBJ_RNUM(obj) != NOTHING)
     (obj_index[GET_OBJ_RNUM(obj)].number)--;
@@ -1388,13 +1669,9 @@ void extract_char_final(struct char_data *ch)
 
   if (!IS_NPC(ch) && GET_CLONES(ch) > 0) {
    struct char_data *clone = NULL;
-    for (clone = character_list; clone; clone = clone->next) {
-     if (IS_NPC(clone)) {
-      if (GET_MOB_VNUM(clone) == 25) {
-       if (GET_ORIGINAL(clone) == ch) {
-        handle_multi_merge(clone);
-       }
-      }
+    for (clone = mob_instances(25); clone; clone = clone->next_instance) {
+     if (GET_ORIGINAL(clone) == ch) {
+      handle_multi_merge(clone);
      }
     }
   }
@@ -1498,8 +1775,10 @@ void extract_char_final(struct char_data *ch)
   char_from_room(ch);
 
   if (IS_NPC(ch)) {
-    if (GET_MOB_RNUM(ch) != NOTHING)	/* prototyped */
+    if (GET_MOB_RNUM(ch) != NOTHING) {	/* prototyped */
       mob_index[GET_MOB_RNUM(ch)].number--;
+      mob_instance_remove(ch);
+    }
     clearMemory(ch);
     if (SCRIPT(ch))
       extract_script(ch, MOB_TRIGGER);
@@ -1570,55 +1849,41 @@ void extract_char(struct char_data *ch)
     }
   }
 
-  extractions_pending++;
+  ch->next_extract = NULL;
+  *extract_tail = ch;
+  extract_tail = &ch->next_extract;
 }
 
 
 /*
- * I'm not particularly pleased with the MOB/PLR
- * hoops that have to be jumped through but it
- * hardly calls for a completely new variable.
- * Ideally it would be its own list, but that
- * would change the '->next' pointer, potentially
- * confusing some code. Ugh. -gg 3/15/2001
- *
- * NOTE: This doesn't handle recursive extractions.
+ * extract_char() queues the characters it marks, so this only visits
+ * those, in the order they died.  Anyone extract_char_final() marks in
+ * turn goes on the end of the queue and is handled in the same pass.
  */
 void extract_pending_chars(void)
 {
-  struct char_data *vict, *next_vict, *prev_vict, *temp;
-
-  if (extractions_pending < 0)
-    log("SYSERR: Negative (%d) extractions pending.", extractions_pending);
+  struct char_data *vict;
 
-  for (vict = character_list, prev_vict = NULL; vict && extractions_pending; vict = next_vict) {
-    next_vict = vict->next;
+  while ((vict = extract_queue)) {
+    if (!(extract_queue = vict->next_extract))
+      extract_tail = &extract_queue;
+    vict->next_extract = NULL;
 
     if (MOB_FLAGGED(vict, MOB_NOTDEADYET))
       REMOVE_BIT_AR(MOB_FLAGS(vict), MOB_NOTDEADYET);
     else if (PLR_FLAGGED(vict, PLR_NOTDEADYET))
       REMOVE_BIT_AR(PLR_FLAGS(vict), PLR_NOTDEADYET);
     else {
-      /* Last non-free'd character to continue chain from. */
-      prev_vict = vict;
+      log("SYSERR: %s queued for extraction but not marked.", GET_NAME(vict));
       continue;
     }
 
-    REMOVE_FROM_LIST(vict, affect_list, next_affect, temp);
-    REMOVE_FROM_LIST(vict, affectv_list, next_affectv, temp);
+    UNLINK_FROM_LIST(vict, affect_list, next_affect, prev_affect);
+    UNLINK_FROM_LIST(vict, affectv_list, next_affectv, prev_affectv);
+    UNLINK_FROM_LIST(vict, character_list, next, prev);
+    keyword_unfile_char(vict);
     extract_char_final(vict);
-    extractions_pending--;
-
-    if (prev_vict)
-      prev_vict->next = next_vict;
-    else
-      character_list = next_vict;
   }
-
-  if (extractions_pending > 0)
-    log("SYSERR: Couldn't find %d extractions as counted.", extractions_pending);
-
-  extractions_pending = 0;
 }
 
 
@@ -1704,12 +1969,12 @@ struct char_data *get_char_room_vis(struct char_data *ch, char *name, int *numbe
         if (--(*number) == 0)
           return (i);
     }
-    else if (isname(name, i->name) && (IS_NPC(i) || IS_NPC(ch) || GET_ADMLEVEL(i) > 0 || GET_ADMLEVEL(ch) > 0) && i != ch) {
+    else if (isname_char(name, i) && (IS_NPC(i) || IS_NPC(ch) || GET_ADMLEVEL(i) > 0 || GET_ADMLEVEL(ch) > 0) && i != ch) {
       if (CAN_SEE(ch, i))
 	if (--(*number) == 0)
 	  return (i);
     }
-    else if (isname(name, i->name) && i == ch) {
+    else if (isname_char(name, i) && i == ch) {
       if (CAN_SEE(ch, i))
         if (--(*number) == 0)
           return (i);
@@ -1830,7 +2095,7 @@ struct obj_data *get_obj_in_list_vis(struct char_data *ch, char *name, int *numb
     return (NULL);
 
   for (i = list; i && *number; i = i->next_content)
-    if (isname(name, i->name))
+    if (isname_obj(name, i))
       if (CAN_SEE_OBJ(ch, i) || (GET_OBJ_TYPE(i) == ITEM_LIGHT))
 	if (--(*number) == 0)
 	  return (i);
@@ -1842,6 +2107,7 @@ struct obj_data *get_obj_in_list_vis(struct char_data *ch, char *name, int *numb
 /* search the entire world for an object, and return a pointer  */
 struct obj_data *get_obj_vis(struct char_data *ch, char *name, int *number)
 {
+  static std::vector<struct obj_data *> found;
   struct obj_data *i;
   int num;
 
@@ -1861,12 +2127,13 @@ struct obj_data *get_obj_vis(struct char_data *ch, char *name, int *number)
   if ((i = get_obj_in_list_vis(ch, name, number, world[IN_ROOM(ch)].contents)) != NULL)
     return (i);
 
-  /* ok.. no luck yet. scan the entire obj list   */
-  for (i = object_list; i && *number; i = i->next)
-    if (isname(name, i->name))
-      if (CAN_SEE_OBJ(ch, i))
+  /* ok.. no luck yet. scan the objects filed under the name */
+  keyword_find_objs(name, found);
+  for (auto obj : found)
+    if (isname_obj(name, obj))
+      if (CAN_SEE_OBJ(ch, obj))
 	if (--(*number) == 0)
-	  return (i);
+	  return (obj);
 
   return (NULL);
 }
@@ -1885,7 +2152,7 @@ struct obj_data *get_obj_in_equip_vis(struct char_data *ch, char *arg, int *numb
     return (NULL);
 
   for (j = 0; j < NUM_WEARS; j++)
-    if (equipment[j] && CAN_SEE_OBJ(ch, equipment[j]) && isname(arg, equipment[j]->name))
+    if (equipment[j] && CAN_SEE_OBJ(ch, equipment[j]) && isname_obj(arg, equipment[j]))
       if (--(*number) == 0)
         return (equipment[j]);
 
@@ -1906,7 +2173,7 @@ int get_obj_pos_in_equip_vis(struct char_data *ch, char *arg, int *number, struc
     return (-1);
 
   for (j = 0; j < NUM_WEARS; j++)
-    if (equipment[j] && CAN_SEE_OBJ(ch, equipment[j]) && isname(arg, equipment[j]->name))
+    if (equipment[j] && CAN_SEE_OBJ(ch, equipment[j]) && isname_obj(arg, equipment[j]))
       if (--(*number) == 0)
         return (j);
 
@@ -2055,7 +2322,7 @@ int generic_find(char *arg, bitvector_t bitvector, struct char_data *ch,
 
   if (IS_SET(bitvector, FIND_OBJ_EQUIP)) {
     for (found = FALSE, i = 0; i < NUM_WEARS && !found; i++)
-      if (GET_EQ(ch, i) && isname(name, GET_EQ(ch, i)->name) && --number == 0) {
+      if (GET_EQ(ch, i) && isname_obj(name, GET_EQ(ch, i)) && --number == 0) {
 	*tar_obj = GET_EQ(ch, i);
 	found = TRUE;
       }
@@ -2098,12 +2365,10 @@ void affectv_to_char(struct char_data *ch, struct affected_type *af)
 {
   struct affected_type *affected_alloc;
 
-  CREATE(affected_alloc, struct affected_type, 1);
+  POOL_CREATE(affected_alloc, struct affected_type, affect_pool);
 
-  if (!ch->affectedv) {
-    ch->next_affectv = affectv_list;
-    affectv_list = ch;
-  }
+  if (!ch->affectedv)
+    LINK_TO_LIST(ch, affectv_list, next_affectv, prev_affectv);
   *affected_alloc = *af;
   affected_alloc->next = ch->affectedv;
   ch->affectedv = affected_alloc;
@@ -2123,11 +2388,10 @@ void affectv_remove(struct char_data *ch, struct affected_type *af)
 
   affect_modify(ch, af->location, af->modifier, af->specific, af->bitvector, FALSE);
   REMOVE_FROM_LIST(af, ch->affectedv, next, cmtemp);
-  free(af);
+  POOL_FREE(af, affect_pool);
   affect_total(ch);
   if (!ch->affectedv) {
-    struct char_data *temp;
-    REMOVE_FROM_LIST(ch, affectv_list, next_affectv, temp);
+    UNLINK_FROM_LIST(ch, affectv_list, next_affectv, prev_affectv);
     ch->next_affectv = NULL;
   }
 }
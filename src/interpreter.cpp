@@ -38,6 +38,9 @@
 #include "ban.h"
 #include "assedit.h"
 #include "obj_edit.h"
+#include "profile.h"
+#include "keywords.h"
+#include "pool.h"
 
 /* local global variables */
 DISABLED_DATA *disabled_first = NULL;
@@ -49,12 +52,12 @@ int opp_bonus(struct char_data *ch, int value, int type);
 int perform_dupe_check(struct descriptor_data *d);
 struct alias_data *find_alias(struct alias_data *alias_list, char *str);
 void free_alias(struct alias_data *a);
-void perform_complex_alias(struct txt_q *input_q, char *orig, struct alias_data *a);
+int perform_complex_alias(struct input_q *input_q, char *orig, struct alias_data *a);
 int reserved_word(char *argument);
 void display_bonus_menu(struct char_data *ch, int type);
 int parse_bonuses(const char *arg);
 void exchange_ccpoints(struct char_data *ch, int value);
-int command_pass(char *cmd, struct char_data *ch);
+int command_pass(const char *cmd, struct char_data *ch);
 void payout(int num);
 
 
@@ -437,6 +440,9 @@ ACMD(do_zanzoken);
 ACMD(do_zreset);
 ACMD(do_zpurge);
 ACMD(do_tailhide);
+ACMD(do_tasks);
+ACMD(do_profile);
+ACMD(do_pools);
 ACMD(do_nogrow);
 ACMD(do_restring);
 
@@ -445,6 +451,8 @@ ACMD(do_attach);
 ACMD(do_detach);
 ACMD(do_tlist);
 ACMD(do_tstat);
+ACMD(do_tverify);
+ACMD(do_tprofile);
 ACMD(do_masound);
 ACMD(do_mkill);
 ACMD(do_mheal);
@@ -821,11 +829,13 @@ const struct command_info cmd_info[] = {
   { "pose"     , "pos"          , POS_STANDING, do_pose     , 0, ADMLVL_NONE    , 0 },
   { "post"     , "pos"          , POS_STANDING, do_post     , 0, ADMLVL_NONE    , 0 },
   { "potential", "poten"        , POS_STANDING, do_potential, 0, ADMLVL_NONE    , 0 },
+  { "pools"    , "pools"	, POS_DEAD    , do_pools    , 0, ADMLVL_GOD	, 0 },
   { "pour"     , "pour"		, POS_STANDING, do_pour     , 0, ADMLVL_NONE	, SCMD_POUR },
   { "powerup"  , "poweru"       , POS_FIGHTING, do_powerup  , 0, ADMLVL_NONE    , 0 },
   { "preference", "preferenc"   , POS_DEAD    , do_preference , 0, ADMLVL_NONE    , 0 },
   { "program"  , "progra"       , POS_DEAD    , do_oasis    , 0, ADMLVL_NONE  , SCMD_OASIS_REDIT },
   { "prompt"   , "pro"		, POS_DEAD    , do_display  , 0, ADMLVL_NONE	, 0 },
+  { "profile"  , "profile"	, POS_DEAD    , do_profile  , 0, ADMLVL_GOD	, 0 },
   { "practice" , "pra"		, POS_RESTING , do_practice , 1, ADMLVL_NONE	, 0 },
   { "psychic"  , "psychi"       , POS_FIGHTING, do_psyblast , 0, ADMLVL_NONE     , 0 },
   { "punch"    , "punc"         , POS_FIGHTING, do_punch    , 0, ADMLVL_NONE     , 0 },
@@ -951,6 +961,7 @@ const struct command_info cmd_info[] = {
   { "tailwhip" , "tailw"        , POS_FIGHTING, do_tailwhip , 0, ADMLVL_NONE    , 0 },
   { "taisha"   , "taish"        , POS_FIGHTING, do_taisha , 0, ADMLVL_NONE    , 0 },
   { "taste"    , "tas"		, POS_RESTING , do_eat      , 0, ADMLVL_NONE	, SCMD_TASTE },
+  { "tasks"    , "tasks"	, POS_DEAD    , do_tasks    , 0, ADMLVL_GOD	, 0 },
   { "teleport" , "tele"		, POS_DEAD    , do_teleport , 0, ADMLVL_IMMORT	, 0 },
   { "telepathy", "telepa"       , POS_DEAD    , do_telepathy, 0, ADMLVL_NONE    , 0 },
   { "tedit"    , "tedit"	, POS_DEAD    , do_tedit    , 0, ADMLVL_GRGOD	, 0 },  
@@ -1034,7 +1045,9 @@ const struct command_info cmd_info[] = {
   { "detach"   , "detach"	, POS_DEAD    , do_detach   , 0, ADMLVL_BUILDER	, 0 },
   { "detect"   , "detec"        , POS_STANDING, do_radar    , 0, ADMLVL_NONE     , 0 },
   { "tlist"    , "tlist"	, POS_DEAD    , do_oasis    , 0, ADMLVL_IMMORT	, SCMD_OASIS_TLIST },
+  { "tprofile" , "tprofile"	, POS_DEAD    , do_tprofile , 0, ADMLVL_GOD	, 0 },
   { "tstat"    , "tstat"	, POS_DEAD    , do_tstat    , 0, ADMLVL_IMMORT	, 0 },
+  { "tverify"  , "tverify"	, POS_DEAD    , do_tverify  , 0, ADMLVL_GOD	, 0 },
   { "masound"  , "masound"	, POS_DEAD    , do_masound  , -1, ADMLVL_NONE	, 0 },
   { "mheal"    , "mhea"         , POS_SITTING , do_mheal    , -1, ADMLVL_NONE   , 0 },
   { "mkill"    , "mkill"	, POS_STANDING, do_mkill    , -1, ADMLVL_NONE	, 0 },
@@ -1115,7 +1128,7 @@ int roll_stats(struct char_data *ch, int type, int bonus)
  */
 void command_interpreter(struct char_data *ch, char *argument)
 {
-  int cmd, length;
+  int cmd;
   int skip_ld = 0;
   char *line;
   char arg[MAX_INPUT_LENGTH];
@@ -1161,17 +1174,9 @@ void command_interpreter(struct char_data *ch, char *argument)
   if (!cont) cont = command_otrigger(ch, arg, line);   /* any object triggers ? */
   if (cont) return;                                    /* yes, command trigger took over */
   }
-  for (length = strlen(arg), cmd = 0; *complete_cmd_info[cmd].command != '\n'; cmd++) {
-    if (!strncmp(complete_cmd_info[cmd].command, arg, length))
-      if (GET_LEVEL(ch) >= complete_cmd_info[cmd].minimum_level &&
-          GET_ADMLEVEL(ch) >= complete_cmd_info[cmd].minimum_admlevel)
-	break;
-  }
+  cmd = lookup_command(arg, GET_LEVEL(ch), GET_ADMLEVEL(ch));
 
-  char blah[MAX_INPUT_LENGTH];
-
-  sprintf(blah, "%s", complete_cmd_info[cmd].command);
-  if (!strcasecmp(blah, "throw"))
+  if (!strcmp(complete_cmd_info[cmd].command, "throw"))
       ch->throws = rand_number(1, 3);
 
 
@@ -1188,7 +1193,7 @@ void command_interpreter(struct char_data *ch, char *argument)
      }
   }
 
-  else if (!command_pass(blah, ch) && GET_ADMLEVEL(ch) < 1)
+  else if (!command_pass(complete_cmd_info[cmd].command, ch) && GET_ADMLEVEL(ch) < 1)
       send_to_char(ch, "It's unfortunate...\r\n");
   else if (check_disabled(&complete_cmd_info[cmd]))    /* is it disabled? */
       send_to_char(ch, "This command has been temporarily disabled.\r\n");
@@ -1322,15 +1327,18 @@ ACMD(do_alias)
  * easier, and it's not that much of a limitation anyway.)  Also valid
  * is "$*", which stands for the entire original line after the alias.
  * ";" is used to delimit commands.
+ *
+ * Returns FALSE, with nothing queued, if the input queue can't take all
+ * of the alias.
  */
 #define NUM_TOKENS       9
 
-void perform_complex_alias(struct txt_q *input_q, char *orig, struct alias_data *a)
+int perform_complex_alias(struct input_q *input_q, char *orig, struct alias_data *a)
 {
-  struct txt_q temp_queue;
-  char *tokens[NUM_TOKENS], *temp, *write_point;
+  char *tokens[NUM_TOKENS], *temp, *write_point, *end;
+  char *cmds[INPUT_QUEUE_LINES + 1];
   char buf2[MAX_RAW_INPUT_LENGTH], buf[MAX_RAW_INPUT_LENGTH];	/* raw? */
-  int num_of_tokens = 0, num;
+  int num_of_tokens = 0, num, num_cmds = 0, pushed = 0, aliased;
 
   /* First, parse the original string */
   strcpy(buf2, orig);	/* strcpy: OK (orig:MAX_INPUT_LENGTH < buf2:MAX_RAW_INPUT_LENGTH) */
@@ -1340,42 +1348,55 @@ void perform_complex_alias(struct txt_q *input_q, char *orig, struct alias_data
     temp = strtok(NULL, " ");
   }
 
-  /* initialize */
-  write_point = buf;
-  temp_queue.head = temp_queue.tail = NULL;
-
-  /* now parse the alias */
-  for (temp = a->replacement; *temp; temp++) {
-    if (*temp == ALIAS_SEP_CHAR) {
-      *write_point = '\0';
-      buf[MAX_INPUT_LENGTH - 1] = '\0';
-      write_to_q(buf, &temp_queue, 1);
-      write_point = buf;
-    } else if (*temp == ALIAS_VAR_CHAR) {
+  /*
+   * Find where each command in the alias starts; anything past what the
+   * input queue could ever hold is dropped.
+   */
+  cmds[num_cmds++] = a->replacement;
+  for (temp = a->replacement; *temp && num_cmds < INPUT_QUEUE_LINES; temp++) {
+    if (*temp == ALIAS_VAR_CHAR && *(temp + 1))
       temp++;
-      if ((num = *temp - '1') < num_of_tokens && num >= 0) {
-	strcpy(write_point, tokens[num]);	/* strcpy: OK */
-	write_point += strlen(tokens[num]);
-      } else if (*temp == ALIAS_GLOB_CHAR) {
-	strcpy(write_point, orig);		/* strcpy: OK */
-	write_point += strlen(orig);
-      } else if ((*(write_point++) = *temp) == '$')	/* redouble $ for act safety */
-	*(write_point++) = '$';
-    } else
-      *(write_point++) = *temp;
+    else if (*temp == ALIAS_SEP_CHAR)
+      cmds[num_cmds++] = temp + 1;
   }
+  for (; *temp && *temp != ALIAS_SEP_CHAR; temp++)
+    if (*temp == ALIAS_VAR_CHAR && *(temp + 1))
+      temp++;
+  cmds[num_cmds] = temp + 1;
 
-  *write_point = '\0';
-  buf[MAX_INPUT_LENGTH - 1] = '\0';
-  write_to_q(buf, &temp_queue, 1);
+  /*
+   * Now expand them last to first, pushing each one onto the _front_ of
+   * the input queue so they come back out in order.
+   */
+  while (num_cmds-- > 0) {
+    write_point = buf;
+    end = cmds[num_cmds + 1] - 1;
+
+    for (temp = cmds[num_cmds]; temp < end && write_point - buf < MAX_INPUT_LENGTH; temp++) {
+      if (*temp == ALIAS_VAR_CHAR && temp + 1 < end) {
+        temp++;
+        if ((num = *temp - '1') < num_of_tokens && num >= 0)
+          write_point += strlcpy(write_point, tokens[num], MAX_INPUT_LENGTH);
+        else if (*temp == ALIAS_GLOB_CHAR)
+          write_point += strlcpy(write_point, orig, MAX_INPUT_LENGTH);
+        else if ((*(write_point++) = *temp) == '$')	/* redouble $ for act safety */
+          *(write_point++) = '$';
+      } else
+        *(write_point++) = *temp;
+    }
 
-  /* push our temp_queue on to the _front_ of the input queue */
-  if (input_q->head == NULL)
-    *input_q = temp_queue;
-  else {
-    temp_queue.tail->next = input_q->head;
-    input_q->head = temp_queue.head;
+    *write_point = '\0';
+    buf[MAX_INPUT_LENGTH - 1] = '\0';
+    if (!write_to_q_front(buf, input_q, 1)) {
+      /* Out of room: take back the later commands so none of it runs. */
+      while (pushed-- > 0)
+        get_from_q(input_q, buf, &aliased);
+      return (FALSE);
+    }
+    pushed++;
   }
+
+  return (TRUE);
 }
 
 
@@ -1415,7 +1436,8 @@ int perform_alias(struct descriptor_data *d, char *orig, size_t maxlen)
     strlcpy(orig, a->replacement, maxlen);
     return (0);
   } else {
-    perform_complex_alias(&d->input, ptr, a);
+    if (!perform_complex_alias(&d->input, ptr, a))
+      write_to_output(d, "Too many commands queued; that alias was dropped.\r\n");
     return (1);
   }
 }
@@ -2045,14 +2067,207 @@ void half_chop(char *string, char *arg1, char *arg2)
 
 
 
+/*
+ * The command index.  command_interpreter() used to strncmp() its way down
+ * complete_cmd_info until it hit the first command the typed word
+ * abbreviates that the character is allowed to use.  Now
+ * create_command_list() builds a trie of the command names, and each node
+ * keeps the commands under it that could ever be that first match, in
+ * table order: a command is left out if an earlier one under the same
+ * node needs no more level and no more admin level, since whoever may use
+ * the later one may use the earlier one too.  Most nodes end up with one
+ * or two.  A lookup walks the word a byte at a time and takes the first
+ * of the node's commands the character passes, which is exactly what the
+ * old scan found.
+ */
+struct cmd_node {
+  char letter;
+  int child;			/* first child, or -1			*/
+  int sibling;			/* next child of our parent, or -1	*/
+  int exact;			/* first command named just this, or -1	*/
+  std::vector<int> first;	/* commands that can match first	*/
+};
+
+static std::vector<struct cmd_node> cmd_index;
+static int cmd_index_top = 0;	/* the "\n" entry ending the table	*/
+
+
+static int cmd_index_child(int node, char letter)
+{
+  int n;
+
+  for (n = cmd_index[node].child; n >= 0; n = cmd_index[n].sibling)
+    if (cmd_index[n].letter == letter)
+      return (n);
+  return (-1);
+}
+
+
+static void cmd_index_offer(int node, int cmd)
+{
+  for (int c : cmd_index[node].first)
+    if (complete_cmd_info[c].minimum_level <= complete_cmd_info[cmd].minimum_level &&
+        complete_cmd_info[c].minimum_admlevel <= complete_cmd_info[cmd].minimum_admlevel)
+      return;
+  cmd_index[node].first.push_back(cmd);
+}
+
+
+void build_command_index(void)
+{
+  const char *p;
+  int cmd, node, next;
+
+  cmd_index.clear();
+  cmd_index.push_back({ '\0', -1, -1, -1, {} });
+
+  for (cmd = 0; *complete_cmd_info[cmd].command != '\n'; cmd++) {
+    node = 0;
+    cmd_index_offer(node, cmd);
+    for (p = complete_cmd_info[cmd].command; *p; p++) {
+      if ((next = cmd_index_child(node, *p)) < 0) {
+        next = cmd_index.size();
+        cmd_index.push_back({ *p, -1, cmd_index[node].child, -1, {} });
+        cmd_index[node].child = next;
+      }
+      node = next;
+      cmd_index_offer(node, cmd);
+    }
+    if (cmd_index[node].exact < 0)
+      cmd_index[node].exact = cmd;
+  }
+  cmd_index_top = cmd;
+}
+
+
+void free_command_index(void)
+{
+  std::vector<struct cmd_node>().swap(cmd_index);
+  cmd_index_top = 0;
+}
+
+
+static int cmd_index_find(const char *arg)
+{
+  int node = 0;
+
+  if (cmd_index.empty())
+    return (-1);
+  for (; *arg && node >= 0; arg++)
+    node = cmd_index_child(node, *arg);
+  return (node);
+}
+
+
+/*
+ * The first command 'arg' abbreviates that someone of the given level and
+ * admin level may use, or the "\n" entry at the end of complete_cmd_info
+ * if there's none.
+ */
+int lookup_command(const char *arg, int level, int admlevel)
+{
+  int node = cmd_index_find(arg);
+
+  if (node >= 0)
+    for (int cmd : cmd_index[node].first)
+      if (level >= complete_cmd_info[cmd].minimum_level &&
+          admlevel >= complete_cmd_info[cmd].minimum_admlevel)
+        return (cmd);
+  return (cmd_index_top);
+}
+
+
 /* Used in specprocs, mostly.  (Exactly) matches "command" to cmd number */
 int find_command(const char *command)
 {
-  int cmd;
+  int node = cmd_index_find(command);
+
+  return (node >= 0 ? cmd_index[node].exact : -1);
+}
+
+
+/* The old scan, kept to measure the index against. */
+static int lookup_command_linear(const char *arg, int level, int admlevel)
+{
+  int cmd, length = strlen(arg);
+
   for (cmd = 0; *complete_cmd_info[cmd].command != '\n'; cmd++)
-    if (!strcmp(complete_cmd_info[cmd].command, command))
-      return (cmd);
-  return (-1);
+    if (!strncmp(complete_cmd_info[cmd].command, arg, length))
+      if (level >= complete_cmd_info[cmd].minimum_level &&
+          admlevel >= complete_cmd_info[cmd].minimum_admlevel)
+        break;
+  return (cmd);
+}
+
+
+#define CMD_BENCH_ROUNDS	200
+
+/*
+ * Time both lookups over a set of words, as a mortal and as 'ch'.  Also
+ * checks that they agree.
+ */
+static void cmd_bench_run(struct char_data *ch, const char *label, std::vector<std::string> &words)
+{
+  const int levels[2][2] = { { 1, ADMLVL_NONE }, { GET_LEVEL(ch), GET_ADMLEVEL(ch) } };
+  unsigned long long start, linear, indexed;
+  int i, r, sum = 0, wrong = 0;
+
+  if (words.empty())
+    return;
+
+  for (i = 0; i < 2; i++) {
+    for (auto &w : words)
+      if (lookup_command(w.c_str(), levels[i][0], levels[i][1]) !=
+          lookup_command_linear(w.c_str(), levels[i][0], levels[i][1]))
+        wrong++;
+
+    start = prof_clock();
+    for (r = 0; r < CMD_BENCH_ROUNDS; r++)
+      for (auto &w : words)
+        sum += lookup_command_linear(w.c_str(), levels[i][0], levels[i][1]);
+    linear = prof_clock() - start;
+
+    start = prof_clock();
+    for (r = 0; r < CMD_BENCH_ROUNDS; r++)
+      for (auto &w : words)
+        sum += lookup_command(w.c_str(), levels[i][0], levels[i][1]);
+    indexed = prof_clock() - start;
+
+    send_to_char(ch, "%-20s %-8s %6d  %10.1f  %10.1f  %6.1fx\r\n", label, i ? "you" : "mortal",
+                 (int) words.size(), (double) linear / (CMD_BENCH_ROUNDS * words.size()),
+                 (double) indexed / (CMD_BENCH_ROUNDS * words.size()),
+                 indexed ? (double) linear / indexed : 0.0);
+  }
+
+  if (wrong)
+    send_to_char(ch, "@R%d lookup%s of %s disagreed with the old scan!@n\r\n", wrong, wrong == 1 ? "" : "s", label);
+  if (sum == -1)	/* keep the loops from being optimised away */
+    send_to_char(ch, "\r\n");
+}
+
+
+void command_index_bench(struct char_data *ch)
+{
+  std::vector<std::string> full, abbrev, late, missing;
+  int cmd;
+
+  for (cmd = 1; cmd < cmd_index_top; cmd++) {
+    full.push_back(complete_cmd_info[cmd].command);
+    abbrev.push_back(std::string(complete_cmd_info[cmd].command, MIN(2, (int) strlen(complete_cmd_info[cmd].command))));
+    if (cmd >= cmd_index_top - 20)
+      late.push_back(complete_cmd_info[cmd].command);
+    missing.push_back(std::string(complete_cmd_info[cmd].command) + "zq");
+  }
+  missing.push_back("xyzzyplugh");
+  missing.push_back(std::string(MAX_INPUT_LENGTH / 2, 'q'));
+
+  send_to_char(ch, "Command lookup, %d commands in %d index nodes, ns per lookup:\r\n",
+               cmd_index_top, (int) cmd_index.size());
+  send_to_char(ch, "%-20s %-8s %6s  %10s  %10s  %7s\r\n", "Words", "As", "Count", "Old scan", "Index", "Speedup");
+  cmd_bench_run(ch, "full names", full);
+  cmd_bench_run(ch, "two letters", abbrev);
+  cmd_bench_run(ch, "end of table", late);
+  cmd_bench_run(ch, "no such command", missing);
 }
 
 
@@ -2151,8 +2366,10 @@ int perform_dupe_check(struct descriptor_data *d)
 	target = k->original;
 	mode = UNSWITCH;
       }
-      if (k->character)
+      if (k->character) {
 	k->character->desc = NULL;
+	zone_occupancy_sync(k->character);
+      }
       k->character = NULL;
       k->original = NULL;
     } else if (k->character && GET_IDNUM(k->character) == id && k->original) {
@@ -2173,6 +2390,7 @@ int perform_dupe_check(struct descriptor_data *d)
 	mode = USURP;
       }
       k->character->desc = NULL;
+      zone_occupancy_sync(k->character);
       k->character = NULL;
       k->original = NULL;
       write_to_output(k, "\r\nMultiple login detected -- disconnecting.\r\n");
@@ -2233,6 +2451,7 @@ int perform_dupe_check(struct descriptor_data *d)
   REMOVE_BIT_AR(PLR_FLAGS(d->character), PLR_WRITING);
   REMOVE_BIT_AR(AFF_FLAGS(d->character), AFF_GROUP);
   STATE(d) = CON_PLAYING;
+  zone_occupancy_sync(d->character);
 
   switch (mode) {
   case RECON:
@@ -2352,6 +2571,8 @@ int enter_player_game (struct descriptor_data *d)
 
       reset_char(d->character);
       read_aliases(d->character);
+      load_intro_memory(d->character);
+      load_sense_memory(d->character);
 
       racial_body_parts(d->character);
 
@@ -2377,8 +2598,8 @@ int enter_player_game (struct descriptor_data *d)
       if (PLR_FLAGGED(d->character, PLR_FROZEN))
 	load_room = real_room(CONFIG_FROZEN_START);
 
-      d->character->next = character_list;
-      character_list = d->character;
+      LINK_TO_LIST(d->character, character_list, next, prev);
+      keyword_file_char(d->character);
       char_to_room(d->character, load_room);
       load_result = Crash_load(d->character);
       if (d->character->player_specials->host) {
@@ -2589,7 +2810,7 @@ void payout(int num)
  }
 }
 
-int command_pass(char *cmd, struct char_data *ch)
+int command_pass(const char *cmd, struct char_data *ch)
 {
 
  if (AFF_FLAGGED(ch, AFF_LIQUEFIED)) {
@@ -3944,7 +4165,7 @@ void nanny(struct descriptor_data *d, char *arg)
   skip_spaces(&arg);
 
   if (d->character == NULL) {
-    CREATE(d->character, struct char_data, 1);
+    POOL_CREATE(d->character, struct char_data, char_pool);
     clear_char(d->character);
     CREATE(d->character->player_specials, struct player_special_data, 1);
     d->character->desc = d;
@@ -3968,7 +4189,7 @@ void nanny(struct descriptor_data *d, char *arg)
      free_char(d->character);
     }
     if (!d->character) {
-      CREATE(d->character, struct char_data, 1);
+      POOL_CREATE(d->character, struct char_data, char_pool);
       clear_char(d->character);
       CREATE(d->character->player_specials, struct player_special_data, 1);
       d->character->desc = d;
@@ -4022,7 +4243,7 @@ void nanny(struct descriptor_data *d, char *arg)
 	    write_to_output(d, "@YInvalid name@n, please try @Canother.@n\r\nName: ");
 	    return;
 	  }
-	  CREATE(d->character, struct char_data, 1);
+	  POOL_CREATE(d->character, struct char_data, char_pool);
 	  clear_char(d->character);
 	  CREATE(d->character->player_specials, struct player_special_data, 1);
 	  d->character->desc = d;
@@ -6675,6 +6896,7 @@ void nanny(struct descriptor_data *d, char *arg)
       greet_memory_mtrigger(d->character);
 
       STATE(d) = CON_PLAYING;
+      zone_occupancy_sync(d->character);
       if (PCOUNT < HIGHPCOUNT && PCOUNT >= HIGHPCOUNT - 4) {
        payout(0);
       }
@@ -0,0 +1,290 @@
+/* ************************************************************************
+*   File: keywords.c                                    Part of CircleMUD *
+*  Usage: Pre-split name keywords, and an index of the world by keyword   *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+/*
+ * isname() copies and splits the whole name list every time it's asked,
+ * and the get_*_vis() and DG lookups ask it once per entry of whatever
+ * list they walk.  Instead each mob and object keeps its name split into
+ * lower case words, in a keyword_set shared by everything with that same
+ * name: the keyword_sets are interned by their text, so all the swords
+ * of one prototype use one.  Since names are assigned all over the place,
+ * the split is checked against the name before use and redone if the
+ * name has changed.  keywords_match() gives the same answers as isname().
+ *
+ * A keyword_set is counted by the things filed under it, and goes away
+ * when the last of them is unfiled or renamed, so corpses, restrings and
+ * names set by scripts don't pile up.  Anything else holding one, such as
+ * a prototype or a struct copied from a live thing, holds it uncounted;
+ * a split is only used once it's been checked to still be about.
+ *
+ * Everything on object_list and character_list is also filed under each
+ * of its words, so a search of the whole world looks at the things with
+ * a word the argument abbreviates instead of walking the whole list.  A
+ * thing is refiled whenever its split is redone, which includes every
+ * time it's put in a room, on a char or in a container.  The candidates
+ * come back in list order, newest first, so '2.sword' still means the
+ * same sword; callers still check each with isname_obj()/isname_char().
+ */
+
+#include "keywords.h"
+#include "utils.h"
+#include "db.h"
+
+template <class T> struct keyword_index {
+  std::map<std::string, std::unordered_set<T *>, std::less<>> words;
+  std::unordered_map<T *, struct keyword_set *> filed;	/* ... by what split */
+  unsigned long last_seq = 0;	/* list_seq given to the newest	*/
+};
+
+static std::unordered_map<std::string, struct keyword_set *> keyword_sets;
+static std::unordered_set<const struct keyword_set *> keyword_sets_live;
+static keyword_index<struct obj_data> obj_words;
+static keyword_index<struct char_data> char_words;
+
+
+/* The split of 'name', made the first time that name is seen. */
+const struct keyword_set *keywords_for(const char *name)
+{
+  struct keyword_set *kw;
+  const char *p, *start;
+
+  if (!name)
+    return (NULL);
+
+  auto found = keyword_sets.find(name);
+  if (found != keyword_sets.end())
+    return (found->second);
+
+  kw = new keyword_set();
+  kw->text = name;
+  for (p = name; *p; p++)
+    kw->lower += LOWER(*p);
+
+  for (p = kw->lower.c_str(); *p; ) {
+    for (; *p == ' ' || *p == '\t'; p++)
+      ;
+    for (start = p; *p && *p != ' ' && *p != '\t'; p++)
+      ;
+    if (p > start)
+      kw->words.emplace_back(start, p - start);
+  }
+
+  keyword_sets.emplace(kw->text, kw);
+  keyword_sets_live.insert(kw);
+  return (kw);
+}
+
+
+/* Throw away a split nothing is filed under any more. */
+static void keywords_drop(const struct keyword_set *kw)
+{
+  if (!kw || !keyword_sets_live.count(kw) || kw->refs)
+    return;
+  keyword_sets_live.erase(kw);
+  keyword_sets.erase(kw->text);
+  delete kw;
+}
+
+
+/* isname(), against a name already split. */
+int keywords_match(const char *str, const struct keyword_set *kw)
+{
+  const char *p, *q;
+
+  if (!str || !*str || !kw || kw->text.empty())
+    return (0);
+
+  /* the easy way */
+  for (p = str, q = kw->lower.c_str(); *p && LOWER(*p) == *q; p++, q++)
+    ;
+  if (!*p && !*q)
+    return (1);
+
+  for (auto &word : kw->words) {
+    for (p = str, q = word.c_str(); *p && LOWER(*p) == *q; p++, q++)
+      ;
+    if (*p)
+      continue;
+    /* Don't allow abbreviated numbers, as in isname(). */
+    if (isdigit(*str) && atoi(str) != atoi(word.c_str()))
+      return (0);
+    return (1);
+  }
+
+  return (0);
+}
+
+
+template <class T> static void index_add(keyword_index<T> &idx, T *thing)
+{
+  struct keyword_set *kw;
+
+  if (!thing->keywords)
+    return;
+
+  kw = const_cast<struct keyword_set *>(thing->keywords);
+  kw->refs++;
+  idx.filed[thing] = kw;
+  for (auto &word : kw->words)
+    idx.words[word].insert(thing);
+}
+
+
+/* Unfile a thing by the split it was filed under, whatever it has now. */
+template <class T> static void index_remove(keyword_index<T> &idx, T *thing)
+{
+  struct keyword_set *kw;
+
+  auto filed = idx.filed.find(thing);
+  if (filed == idx.filed.end())
+    return;
+  kw = filed->second;
+  idx.filed.erase(filed);
+
+  for (auto &word : kw->words) {
+    auto bucket = idx.words.find(word);
+    if (bucket == idx.words.end())
+      continue;
+    bucket->second.erase(thing);
+    if (bucket->second.empty())
+      idx.words.erase(bucket);
+  }
+
+  kw->refs--;
+  keywords_drop(kw);
+}
+
+
+/* Redo the split if the name changed, refiling the thing if it's filed. */
+template <class T> static void keywords_refresh(keyword_index<T> &idx, T *thing)
+{
+  const struct keyword_set *kw = thing->keywords;
+
+  /* a split that's gone since this was copied */
+  if (kw && !keyword_sets_live.count(kw))
+    thing->keywords = kw = NULL;
+
+  if (thing->name ? (kw && kw->text == thing->name) : !kw)
+    return;
+
+  if (thing->list_seq)
+    index_remove(idx, thing);
+  thing->keywords = keywords_for(thing->name);
+  if (thing->list_seq)
+    index_add(idx, thing);
+  if (kw != thing->keywords)
+    keywords_drop(kw);
+}
+
+
+template <class T> static bool newer_on_list(const T *a, const T *b)
+{
+  return (a->list_seq > b->list_seq);
+}
+
+
+template <class T> static void index_find(keyword_index<T> &idx, T *list, const char *str, std::vector<T *> &found)
+{
+  std::string key;
+  T *thing;
+
+  found.clear();
+
+  /* An argument with a space in it can only match a whole name. */
+  if (!*str || strpbrk(str, " \t")) {
+    for (thing = list; thing; thing = thing->next)
+      found.push_back(thing);
+    return;
+  }
+
+  for (; *str; str++)
+    key += LOWER(*str);
+
+  for (auto bucket = idx.words.lower_bound(key);
+       bucket != idx.words.end() && !bucket->first.compare(0, key.size(), key); ++bucket)
+    found.insert(found.end(), bucket->second.begin(), bucket->second.end());
+
+  std::sort(found.begin(), found.end(), newer_on_list<T>);
+  found.erase(std::unique(found.begin(), found.end()), found.end());
+}
+
+
+void obj_keywords_refresh(struct obj_data *obj)
+{
+  keywords_refresh(obj_words, obj);
+}
+
+
+void char_keywords_refresh(struct char_data *ch)
+{
+  keywords_refresh(char_words, ch);
+}
+
+
+int isname_obj(const char *str, struct obj_data *obj)
+{
+  keywords_refresh(obj_words, obj);
+  return (keywords_match(str, obj->keywords));
+}
+
+
+int isname_char(const char *str, struct char_data *ch)
+{
+  keywords_refresh(char_words, ch);
+  return (keywords_match(str, ch->keywords));
+}
+
+
+/* Just put on object_list; it's at the head, so it's the newest. */
+void keyword_file_obj(struct obj_data *obj)
+{
+  keyword_unfile_obj(obj);
+  keywords_refresh(obj_words, obj);
+  obj->list_seq = ++obj_words.last_seq;
+  index_add(obj_words, obj);
+}
+
+
+void keyword_unfile_obj(struct obj_data *obj)
+{
+  if (!obj->list_seq)
+    return;
+  index_remove(obj_words, obj);
+  obj->list_seq = 0;
+}
+
+
+void keyword_file_char(struct char_data *ch)
+{
+  keyword_unfile_char(ch);
+  keywords_refresh(char_words, ch);
+  ch->list_seq = ++char_words.last_seq;
+  index_add(char_words, ch);
+}
+
+
+void keyword_unfile_char(struct char_data *ch)
+{
+  if (!ch->list_seq)
+    return;
+  index_remove(char_words, ch);
+  ch->list_seq = 0;
+}
+
+
+/* Objects 'str' might name, in object_list order. */
+void keyword_find_objs(const char *str, std::vector<struct obj_data *> &found)
+{
+  index_find(obj_words, object_list, str, found);
+}
+
+
+/* Characters 'str' might name, in character_list order. */
+void keyword_find_chars(const char *str, std::vector<struct char_data *> &found)
+{
+  index_find(char_words, character_list, str, found);
+}
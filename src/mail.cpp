@@ -21,6 +21,7 @@ Written by Jeremy Elson (jelson@circlemud.org)
 #include "handler.h"
 #include "improved-edit.h"
 #include "players.h"
+#include "keywords.h"
 
 /* local globals */
 static mail_index_type *mail_index = NULL;	/* list of recs in the mail file  */
@@ -626,6 +627,7 @@ void postmaster_receive_mail(struct char_data *ch, struct char_data *mailman,
     obj->description = strdup(blm);
     sprintf(bla, "mail paper letter");
     obj->name = strdup(bla);
+    obj_keywords_refresh(obj);
     *bla = '\0';
     *blm = '\0';
     SET_BIT_AR(GET_OBJ_EXTRA(obj), ITEM_UNIQUE_SAVE);
@@ -0,0 +1,446 @@
+/* ************************************************************************
+*   File: mccp.c                                        Part of CircleMUD *
+*  Usage: MCCP2 stream compression, inline or on a pool of worker threads *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+/*
+ * Every compressed descriptor has a zlib stream and a buffer of compressed
+ * bytes the socket hasn't taken yet.  Text goes in through mccp_write(),
+ * one flush unit at a time, and comes out of mccp_flush().
+ *
+ * Normally deflate runs right there on the game thread.  Started with -z,
+ * each stream instead gets a small ring of jobs: the game thread copies
+ * the text into the next free job and hands the stream to a worker, the
+ * worker deflates jobs in order and bumps 'done', and the game thread picks
+ * the results up again from the same ring.  Only the run queue of streams
+ * waiting for a worker takes a lock.  A stream is only ever on the run
+ * queue once, so one worker at a time owns its z_stream and output stays
+ * in order.  game_loop() hands out everyone's output first and then waits
+ * for the pool once per pass, so a broadcast to everyone gets compressed
+ * in parallel.
+ */
+
+#include "mccp.h"
+#include "utils.h"
+#include "comm.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+int mccp_threads = 0;
+
+struct mccp_job {
+  int flush;			/* Z_SYNC_FLUSH, or Z_FINISH to end it	*/
+  int error;			/* deflate failed			*/
+  Bytef *in;
+  size_t in_len, in_size;
+  Bytef *out;
+  size_t out_len, out_size;
+  unsigned long long cpu_nsec;
+};
+
+struct mccp_stream {
+  z_streamp zs;
+  struct mccp_job jobs[MCCP_JOBS];
+  std::atomic<unsigned int> submitted;	/* written by the game thread	*/
+  std::atomic<unsigned int> done;	/* written by the owning worker	*/
+  unsigned int collected;		/* game thread only		*/
+  std::atomic<bool> queued;		/* on the run queue or being run */
+};
+
+static std::vector<std::thread> mccp_workers;
+static std::mutex run_lock;
+static std::condition_variable run_cv, idle_cv;
+static std::deque<struct mccp_stream *> run_queue;
+static std::atomic<int> jobs_in_flight(0);
+static bool mccp_stopping = FALSE;
+
+
+void *z_alloc(void *opaque, uInt items, uInt size)
+{
+    return calloc(items, size);
+}
+
+void z_free(void *opaque, void *address)
+{
+    return free(address);
+}
+
+
+static unsigned long long thread_cpu_nsec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ((unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+
+/*
+ * Deflate a set of buffers as one flush unit, appending to *out and growing
+ * it as needed.  Safe to call from a worker; it only touches what it's
+ * given.  Returns FALSE on a zlib error.
+ */
+static int mccp_deflate(z_streamp zs, const struct iovec *iov, int cnt, int flush,
+                        Bytef **out, size_t *out_len, size_t *out_size, unsigned long long *cpu)
+{
+  unsigned long long start = thread_cpu_nsec();
+  int i, result, ok = TRUE;
+
+  for (i = 0; i < cnt && ok; i++) {
+    zs->next_in = (Bytef *)iov[i].iov_base;
+    zs->avail_in = iov[i].iov_len;
+
+    do {
+      if (*out_size - *out_len < 64) {
+        *out_size = MAX(*out_size * 2, 1024);
+        RECREATE(*out, Bytef, *out_size);
+      }
+      zs->next_out = *out + *out_len;
+      zs->avail_out = *out_size - *out_len;
+
+      result = deflate(zs, i == cnt - 1 ? flush : Z_NO_FLUSH);
+      *out_len = zs->next_out - *out;
+
+      if (result == Z_STREAM_ERROR) {
+        ok = FALSE;
+        break;
+      }
+    } while (zs->avail_in > 0 || zs->avail_out == 0);
+  }
+
+  *cpu += thread_cpu_nsec() - start;
+  return (ok);
+}
+
+
+/* Make room for 'len' more bytes of compressed output in the send buffer. */
+static void mccp_reserve(struct compr *comp, size_t len)
+{
+  if (comp->sent_out) {
+    memmove(comp->buff_out, comp->buff_out + comp->sent_out, comp->size_out - comp->sent_out);
+    comp->size_out -= comp->sent_out;
+    comp->sent_out = 0;
+  }
+  if (comp->size_out + len > comp->total_out) {
+    comp->total_out = MAX(comp->total_out * 2, comp->size_out + len);
+    RECREATE(comp->buff_out, Bytef, comp->total_out);
+  }
+}
+
+
+/* ******************************************************************
+*  worker pool                                                      *
+****************************************************************** */
+
+static void mccp_worker(void)
+{
+  struct mccp_stream *s;
+  struct mccp_job *job;
+  struct iovec iov;
+  unsigned int d;
+  bool more;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lk(run_lock);
+      run_cv.wait(lk, [] { return mccp_stopping || !run_queue.empty(); });
+      if (run_queue.empty())
+        return;
+      s = run_queue.front();
+      run_queue.pop_front();
+    }
+
+    for (;;) {
+      while ((d = s->done.load(std::memory_order_relaxed)) != s->submitted.load(std::memory_order_acquire)) {
+        job = &s->jobs[d & (MCCP_JOBS - 1)];
+        iov.iov_base = job->in;
+        iov.iov_len = job->in_len;
+        job->out_len = 0;
+        job->cpu_nsec = 0;
+        job->error = !mccp_deflate(s->zs, &iov, 1, job->flush, &job->out, &job->out_len, &job->out_size, &job->cpu_nsec);
+        s->done.store(d + 1, std::memory_order_release);
+        jobs_in_flight--;
+      }
+
+      /*
+       * Let go, unless more came in while we were letting go.  This is done
+       * under the lock so mccp_end() can't free the stream under our feet.
+       */
+      {
+        std::lock_guard<std::mutex> lk(run_lock);
+        s->queued = false;
+        more = (s->done.load() != s->submitted.load() && !s->queued.exchange(true));
+        idle_cv.notify_all();
+      }
+      if (!more)
+        break;
+    }
+  }
+}
+
+
+int mccp_init(void)
+{
+  int i;
+
+  if (mccp_threads <= 0)
+    return (0);
+  if (mccp_threads > MCCP_MAX_THREADS)
+    mccp_threads = MCCP_MAX_THREADS;
+
+  for (i = 0; i < mccp_threads; i++)
+    mccp_workers.emplace_back(mccp_worker);
+
+  log("Compressing MCCP streams on %d worker thread%s.", mccp_threads, mccp_threads == 1 ? "" : "s");
+  return (0);
+}
+
+
+void mccp_shutdown(void)
+{
+  {
+    std::lock_guard<std::mutex> lk(run_lock);
+    mccp_stopping = TRUE;
+  }
+  run_cv.notify_all();
+
+  for (auto &t : mccp_workers)
+    t.join();
+  mccp_workers.clear();
+}
+
+
+/* Queue a flush unit for the workers.  FALSE if the stream's ring is full. */
+static int mccp_submit(struct compr *comp, const struct iovec *iov, int cnt, int flush)
+{
+  struct mccp_stream *s = comp->async;
+  struct mccp_job *job;
+  unsigned int idx = s->submitted.load(std::memory_order_relaxed);
+  size_t total = 0;
+  int i;
+
+  if (idx - s->collected >= MCCP_JOBS)
+    return (FALSE);
+
+  job = &s->jobs[idx & (MCCP_JOBS - 1)];
+  for (i = 0; i < cnt; i++)
+    total += iov[i].iov_len;
+  if (total > job->in_size) {
+    job->in_size = total;
+    RECREATE(job->in, Bytef, job->in_size);
+  }
+  for (job->in_len = 0, i = 0; i < cnt; i++) {
+    memcpy(job->in + job->in_len, iov[i].iov_base, iov[i].iov_len);
+    job->in_len += iov[i].iov_len;
+  }
+  job->flush = flush;
+
+  jobs_in_flight++;
+  s->submitted.store(idx + 1);
+
+  if (!s->queued.exchange(true)) {
+    std::lock_guard<std::mutex> lk(run_lock);
+    run_queue.push_back(s);
+    run_cv.notify_one();
+  }
+
+  return (TRUE);
+}
+
+
+/* Move finished jobs into the send buffer.  FALSE if deflate failed. */
+static int mccp_collect(struct compr *comp)
+{
+  struct mccp_stream *s = comp->async;
+  struct mccp_job *job;
+  unsigned int done = s->done.load(std::memory_order_acquire);
+
+  for (; s->collected != done; s->collected++) {
+    job = &s->jobs[s->collected & (MCCP_JOBS - 1)];
+    if (job->error)
+      return (FALSE);
+    mccp_reserve(comp, job->out_len);
+    memcpy(comp->buff_out + comp->size_out, job->out, job->out_len);
+    comp->size_out += job->out_len;
+    comp->raw_bytes += job->in_len;
+    comp->zip_bytes += job->out_len;
+    comp->cpu_nsec += job->cpu_nsec;
+  }
+
+  return (TRUE);
+}
+
+
+static void mccp_wait(struct compr *comp)
+{
+  struct mccp_stream *s = comp->async;
+  std::unique_lock<std::mutex> lk(run_lock);
+
+  idle_cv.wait(lk, [s] { return s->done.load() == s->submitted.load() && !s->queued.load(); });
+}
+
+
+/* Block until the workers have finished everything handed to them. */
+void mccp_wait_all(void)
+{
+  if (mccp_workers.empty())
+    return;
+
+  std::unique_lock<std::mutex> lk(run_lock);
+  idle_cv.wait(lk, [] { return jobs_in_flight.load() == 0; });
+}
+
+
+/* ******************************************************************
+*  streams                                                          *
+****************************************************************** */
+
+/* The client said yes to MCCP2; everything from here on is compressed. */
+void mccp_start(struct compr *comp)
+{
+  CREATE(comp->stream, z_stream, 1);
+  comp->stream->zalloc = z_alloc;
+  comp->stream->zfree = z_free;
+  comp->stream->opaque = Z_NULL;
+  deflateInit(comp->stream, Z_DEFAULT_COMPRESSION);
+
+  CREATE(comp->buff_out, Bytef, SMALL_BUFSIZE);
+  comp->total_out = SMALL_BUFSIZE;
+  comp->size_out = comp->sent_out = 0;
+
+  if (!mccp_workers.empty()) {
+    comp->async = new mccp_stream();
+    comp->async->zs = comp->stream;
+  }
+
+  comp->state = 2;
+}
+
+
+/* Tear down a stream; waits for any worker still holding it. */
+void mccp_end(struct compr *comp)
+{
+  int i;
+
+  if (comp->async) {
+    mccp_wait(comp);
+    for (i = 0; i < MCCP_JOBS; i++) {
+      if (comp->async->jobs[i].in)
+        free(comp->async->jobs[i].in);
+      if (comp->async->jobs[i].out)
+        free(comp->async->jobs[i].out);
+    }
+    delete comp->async;
+    comp->async = NULL;
+  }
+
+  if (comp->stream) {
+    deflateEnd(comp->stream);
+    free(comp->stream);
+    comp->stream = NULL;
+  }
+  if (comp->buff_out)
+    free(comp->buff_out);
+  comp->buff_out = NULL;
+  comp->total_out = comp->size_out = comp->sent_out = 0;
+}
+
+
+/* Is there compressed output still to go out? */
+int mccp_pending(struct compr *comp)
+{
+  if (!comp || !comp->stream)
+    return (FALSE);
+  if (comp->size_out > comp->sent_out)
+    return (TRUE);
+  return (comp->async && comp->async->collected != comp->async->submitted.load());
+}
+
+
+/*
+ * Write out whatever compressed output is ready.
+ *
+ * Returns:
+ *  -1  Fatal error; cut them off.
+ *   0  Everything ready has been sent.
+ *   1  The socket is full.
+ */
+int mccp_flush(socklen_t desc, struct compr *comp)
+{
+  ssize_t result;
+
+  if (comp->async && !mccp_collect(comp)) {
+    log("SYSERR: MCCP: deflate failed on descriptor %d.", desc);
+    return (-1);
+  }
+
+  while (comp->sent_out < comp->size_out) {
+    result = write(desc, comp->buff_out + comp->sent_out, comp->size_out - comp->sent_out);
+    if (result < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        return (1);
+      perror("SYSERR: MCCP write to socket");
+      return (-1);
+    }
+    comp->sent_out += result;
+  }
+
+  comp->size_out = comp->sent_out = 0;
+  return (0);
+}
+
+
+/*
+ * Compress a set of buffers as one unit and send what we can.  With
+ * workers running and 'wait' unset, the text is only handed off;
+ * game_loop() sends the result after mccp_wait_all().
+ *
+ * Like perform_socket_write(): returns the number of plain bytes taken
+ * (all or nothing), 0 if we're backed up, -1 on a fatal error.
+ */
+ssize_t mccp_write(socklen_t desc, struct compr *comp, const struct iovec *iov, int cnt, int wait)
+{
+  ssize_t total = 0;
+  int i, flush = (comp->state == 3 ? Z_FINISH : Z_SYNC_FLUSH);
+
+  /* Clear out what we're already holding; a slow socket pushes back. */
+  if (mccp_flush(desc, comp) < 0)
+    return (-1);
+  if (comp->size_out - comp->sent_out >= MCCP_MAX_PENDING)
+    return (0);
+
+  for (i = 0; i < cnt; i++)
+    total += iov[i].iov_len;
+
+  if (comp->async) {
+    if (!mccp_submit(comp, iov, cnt, flush))
+      return (0);
+    if (!wait)
+      return (total);
+    mccp_wait(comp);
+  } else {
+    size_t before;
+
+    mccp_reserve(comp, 0);
+    before = comp->size_out;
+    if (!mccp_deflate(comp->stream, iov, cnt, flush, &comp->buff_out, &comp->size_out, &comp->total_out, &comp->cpu_nsec)) {
+      log("SYSERR: MCCP: deflate failed on descriptor %d.", desc);
+      return (-1);
+    }
+    comp->raw_bytes += total;
+    comp->zip_bytes += comp->size_out - before;
+  }
+
+  if (mccp_flush(desc, comp) < 0)
+    return (-1);
+
+  return (total);
+}
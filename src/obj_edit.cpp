@@ -18,6 +18,7 @@
 #include "obj_edit.h"
 #include "dg_comm.h"
 #include "act.other.h"
+#include "keywords.h"
 
 /* local functions  */
 void disp_custom_menu(struct descriptor_data *d);
@@ -206,6 +207,7 @@ void pobj_edit_parse(struct descriptor_data *d, char *arg)
      *buf = '\0';
      sprintf(buf, "%s", d->obj_name);
      obj->name = strdup(buf);
+     obj_keywords_refresh(obj);
 
      *buf2 = '\0';
      sprintf(buf2, "%s", d->obj_short);
@@ -467,6 +469,7 @@ void pobj_edit_parse(struct descriptor_data *d, char *arg)
       *buf = '\0';
       sprintf(buf, d->obj_name);
       obj->name = strdup(buf);
+      obj_keywords_refresh(obj);
       *buf2 = '\0';
       sprintf(buf2, d->obj_short);
       obj->short_description = strdup(buf2);
@@ -479,6 +482,7 @@ void pobj_edit_parse(struct descriptor_data *d, char *arg)
       *buf = '\0';
       sprintf(buf, "%s", d->obj_name);
       obj->name = strdup(buf);
+      obj_keywords_refresh(obj);
       *buf2 = '\0';
       sprintf(buf2, "%s", d->obj_short);
       obj->short_description = strdup(buf2);
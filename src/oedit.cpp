@@ -26,6 +26,7 @@
 #include "act.wizard.h"
 #include "races.h"
 #include "fight.h"
+#include "keywords.h"
 
 /*------------------------------------------------------------------------*/
 
@@ -1103,7 +1104,22 @@ void oedit_parse(struct descriptor_data *d, char *arg)
       } else {
         send_to_char(d->character, "\r\nCommitting iedit changes.\r\n");
         obj = OLC_IOBJ(d);
+        OLC_OBJ(d)->next_instance = obj->next_instance;
+        OLC_OBJ(d)->prev_instance = obj->prev_instance;
+        OLC_OBJ(d)->next_content = obj->next_content;
+        OLC_OBJ(d)->prev_content = obj->prev_content;
+        OLC_OBJ(d)->next = obj->next;
+        OLC_OBJ(d)->prev = obj->prev;
+        memcpy(OLC_OBJ(d)->active_pos, obj->active_pos, sizeof(obj->active_pos));
+        SCRIPT(OLC_OBJ(d)) = SCRIPT(obj);
+        OLC_OBJ(d)->trig_types = obj->trig_types;
+        OLC_OBJ(d)->trig_room = obj->trig_room;
+        OLC_OBJ(d)->keywords = obj->keywords;
+        OLC_OBJ(d)->list_seq = obj->list_seq;
+        /* find_obj helper */
+        remove_from_lookup_table(GET_ID(obj));
         *obj = *(OLC_OBJ(d));
+        obj_keywords_refresh(obj);
         GET_ID(obj) = max_obj_id++;
         /* find_obj helper */
         add_to_lookup_table(GET_ID(obj), (void *)obj);
@@ -1119,6 +1135,7 @@ void oedit_parse(struct descriptor_data *d, char *arg)
           copy_proto_script(&obj_proto[robj], obj, OBJ_TRIGGER);
           assign_triggers(obj, OBJ_TRIGGER);
         }
+        room_trig_sync(obj, OBJ_TRIGGER);
         SET_BIT_AR(GET_OBJ_EXTRA(obj), ITEM_UNIQUE_SAVE);
   /* Xap - ought to save the old pointer, free after assignment I suppose */
         mudlog(CMP, MAX(ADMLVL_BUILDER, GET_INVIS_LEV(d->character)), TRUE,
@@ -1128,6 +1145,8 @@ void oedit_parse(struct descriptor_data *d, char *arg)
           STATE(d) = CON_PLAYING;
           act("$n stops using OLC.", TRUE, d->character, 0, 0, TO_ROOM);
         }
+        /* obj has the work copy's strings now, so only the struct goes */
+        free(OLC_OBJ(d));
         free(d->olc);
         d->olc = NULL;
       }
@@ -1783,15 +1802,25 @@ void iedit_setup_existing(struct descriptor_data *d, struct obj_data *real_num)
 
   OLC_IOBJ(d) = real_num;
 
-  obj = create_obj();
-  copy_object(obj,real_num);
+  /*
+   * Like oedit's, the work copy is plain CREATE()d memory that is never on
+   * object_list, in the keyword index or in the lookup table, so that
+   * cleanup_olc() can free() it.  The struct copy leaves it pointing at the
+   * live object's script and list neighbours; those aren't its to free or
+   * unlink, so just let go of them.  The commit puts the live ones back.
+   */
+  CREATE(obj, struct obj_data, 1);
+  copy_object(obj, real_num);
 
-  /* free any assigned scripts */
-  if (SCRIPT(obj))
-    extract_script(obj, OBJ_TRIGGER);
   SCRIPT(obj) = NULL;
-  /* find_obj helper */
-  remove_from_lookup_table(GET_ID(obj));
+  obj->keywords = NULL;
+  obj->list_seq = 0;
+  obj->trig_types = 0;
+  obj->trig_room = NOWHERE;
+  obj->next = obj->prev = NULL;
+  obj->next_content = obj->prev_content = NULL;
+  obj->next_instance = obj->prev_instance = NULL;
+  memset(obj->active_pos, 0, sizeof(obj->active_pos));
 
   OLC_OBJ(d) = obj;
   OLC_IOBJ(d) = real_num;
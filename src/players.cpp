@@ -49,6 +49,17 @@ int top_of_p_table = 0;		/* ref to top of table		 */
 int top_of_p_file = 0;		/* ref of size of p file	 */
 long top_idnum = 0;		/* highest idnum in use		 */
 
+/*
+ * player_table is searched by name at every login and by id from mail,
+ * clans, finger, intros and scripts, so both are hashed to the entry's
+ * index.  A deleted player's name is blanked and leaves the name map;
+ * the entry keeps its id until the slot is reused.  The table grows by
+ * doubling.
+ */
+static std::unordered_map<std::string, int, ci_hash, ci_equal> ptable_names;
+static std::unordered_map<long, int> ptable_ids;
+static int p_table_size = 0;	/* entries allocated in player_table	 */
+
 
 /* external ASCII Player Files vars */
 
@@ -143,6 +154,9 @@ void build_player_index(void)
   }
 
   CREATE(player_table, struct player_index_element, rec_count);
+  p_table_size = rec_count;
+  ptable_names.reserve(rec_count);
+  ptable_ids.reserve(rec_count);
   for (i = 0; i < rec_count; i++) {
     get_line(plr_index, line);
     player_table[i].admlevel = ADMLVL_NONE; /* In case they're not in the index yet */
@@ -152,6 +166,10 @@ void build_player_index(void)
     strcpy(player_table[i].name, arg2);
     player_table[i].flags = asciiflag_conv(bits);
     top_idnum = MAX(top_idnum, player_table[i].id);
+
+    /* First one wins, as the old linear searches did. */
+    ptable_names.emplace(player_table[i].name, i);
+    ptable_ids.emplace(player_table[i].id, i);
   }
 
   fclose(plr_index);
@@ -168,14 +186,14 @@ int create_entry(char *name)
 {
   int i, pos;
 
-  if (top_of_p_table == -1) {	/* no table */
-    CREATE(player_table, struct player_index_element, 1);
-    pos = top_of_p_table = 0;
-  } else if ((pos = get_ptable_by_name(name)) == -1) {	/* new name */
-    i = ++top_of_p_table + 1;
+  if (top_of_p_table == -1 || (pos = get_ptable_by_name(name)) == -1) {	/* new name */
+    pos = ++top_of_p_table;
 
-    RECREATE(player_table, struct player_index_element, i);
-    pos = top_of_p_table;
+    if (pos >= p_table_size) {
+      p_table_size = MAX(16, p_table_size * 2);
+      RECREATE(player_table, struct player_index_element, p_table_size);
+    }
+    memset(&player_table[pos], 0, sizeof(struct player_index_element));
   }
 
   CREATE(player_table[pos].name, char, strlen(name) + 1);
@@ -184,6 +202,8 @@ int create_entry(char *name)
   for (i = 0; (player_table[pos].name[i] = LOWER(name[i])); i++)
 	/* Nothing */;
 
+  ptable_names[player_table[pos].name] = pos;
+
   /* clear the bitflag in case we have garbage data */
   player_table[pos].flags = 0;
 
@@ -232,42 +252,46 @@ void free_player_index(void)
   free(player_table);
   player_table = NULL;
   top_of_p_table = 0;
+  p_table_size = 0;
+  ptable_names.clear();
+  ptable_ids.clear();
 }
 
 
 long get_ptable_by_name(const char *name)
 {
-  int i;
-
-  for (i = 0; i <= top_of_p_table; i++)
-    if (!strcasecmp(player_table[i].name, name))
-      return (i);
+  auto it = ptable_names.find(std::string_view(name));
 
-  return (-1);
+  return (it == ptable_names.end() ? -1 : it->second);
 }
 
 
 long get_id_by_name(const char *name)
 {
-  int i;
+  long pos = get_ptable_by_name(name);
 
-  for (i = 0; i <= top_of_p_table; i++)
-    if (!strcasecmp(player_table[i].name, name))
-      return (player_table[i].id);
-
-  return (-1);
+  return (pos == -1 ? -1 : player_table[pos].id);
 }
 
 
 char *get_name_by_id(long id)
 {
-  int i;
+  auto it = ptable_ids.find(id);
+
+  return (it == ptable_ids.end() ? NULL : player_table[it->second].name);
+}
 
-  for (i = 0; i <= top_of_p_table; i++)
-    if (player_table[i].id == id)
-      return (player_table[i].name);
 
-  return (NULL);
+/* Give a player_table entry a new id, keeping the id map in step. */
+void set_ptable_id(int pos, long id)
+{
+  auto it = ptable_ids.find(player_table[pos].id);
+
+  if (it != ptable_ids.end() && it->second == pos)
+    ptable_ids.erase(it);
+
+  player_table[pos].id = id;
+  ptable_ids.emplace(id, pos);
 }
 
 
@@ -288,8 +312,17 @@ void load_follower_from_file(FILE *fl, struct char_data *ch)
   newch->nr = real_mobile(nr);
 
   if (!parse_mobile_from_file(fl, newch)) {
-    free(newch);
+    /*
+     * create_char() put it on character_list, and free_char() takes it out
+     * of the rest.  It may have failed before its flags were read, and its
+     * player_specials is the shared dummy_mob.
+     */
+    UNLINK_FROM_LIST(newch, character_list, next, prev);
+    SET_BIT_AR(MOB_FLAGS(newch), MOB_ISNPC);
+    newch->player_specials = NULL;
+    free_char(newch);
   } else {
+    mob_instance_add(newch);
     add_follower(newch, ch);
     newch->master_id = GET_IDNUM(ch);
     GET_POS(newch) = POS_STANDING;
@@ -986,6 +1019,7 @@ void save_char(struct char_data * ch)
   }
 
   save_char_vars(ch);
+  save_recog_memory(ch);
 
   /*
    * remove the affections so that the raw values are stored; otherwise the
@@ -1563,6 +1597,9 @@ void remove_player(int pfilepos)
   log("PCLEAN: %s Lev: %d Last: %s",
 	player_table[pfilepos].name, player_table[pfilepos].level,
 	asctime(localtime(&player_table[pfilepos].last)));
+  auto it = ptable_names.find(std::string_view(player_table[pfilepos].name));
+  if (it != ptable_names.end() && it->second == pfilepos)
+    ptable_names.erase(it);
   player_table[pfilepos].name[0] = '\0';
   save_player_index();
 }
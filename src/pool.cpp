@@ -0,0 +1,172 @@
+/* ************************************************************************
+*   File: pool.c                                        Part of CircleMUD *
+*  Usage: Typed slab pools for the busiest game structures                *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+/*
+ * Characters, objects, affects and scripts used to be calloc()ed and
+ * free()d one at a time, so every zone reset and every big fight churned
+ * the heap and left it fragmented.  Each of those types now has a pool:
+ * items are carved out of large slabs, and a freed item goes on the
+ * pool's free list to be handed out again, most recently freed first.
+ * Slabs are never given back, so a pool only grows to its peak.  Items
+ * come back zeroed, just as from CREATE().
+ *
+ * The 'pools' command shows how many of each are in use, the most there
+ * have been, and how many are waiting on the free list.
+ */
+
+#include "pool.h"
+#include "utils.h"
+#include "comm.h"
+#include "dg_scripts.h"
+
+struct mem_slab {
+  struct mem_slab *next;
+};
+
+/* Slab headers take up a whole POOL_ALIGN so the items stay aligned. */
+#define SLAB_HEADER	((sizeof(struct mem_slab) + POOL_ALIGN - 1) & ~(size_t) (POOL_ALIGN - 1))
+
+struct mem_pool char_pool	= { "char_data", sizeof(struct char_data) };
+struct mem_pool obj_pool	= { "obj_data", sizeof(struct obj_data) };
+struct mem_pool affect_pool	= { "affected_type", sizeof(struct affected_type) };
+struct mem_pool script_pool	= { "script_data", sizeof(struct script_data) };
+struct mem_pool trig_pool	= { "trig_data", sizeof(struct trig_data) };
+
+static struct mem_pool *pools[] = {
+  &char_pool, &obj_pool, &affect_pool, &script_pool, &trig_pool
+};
+
+
+#ifndef POOL_PASSTHROUGH
+static void pool_grow(struct mem_pool *pool)
+{
+  struct mem_slab *slab;
+  char *item;
+  int i;
+
+  if (!pool->per_slab) {
+    pool->size = (pool->size + POOL_ALIGN - 1) & ~(size_t) (POOL_ALIGN - 1);
+    pool->per_slab = MAX(POOL_SLAB_MIN, (int) ((POOL_SLAB_BYTES - SLAB_HEADER) / pool->size));
+  }
+
+  if (!(slab = (struct mem_slab *) malloc(SLAB_HEADER + pool->size * pool->per_slab))) {
+    perror("SYSERR: malloc failure");
+    abort();
+  }
+  slab->next = pool->slabs;
+  pool->slabs = slab;
+  pool->num_slabs++;
+
+  /* Thread them on backwards so they're handed out in address order. */
+  item = (char *) slab + SLAB_HEADER + pool->size * pool->per_slab;
+  for (i = 0; i < pool->per_slab; i++) {
+    item -= pool->size;
+#ifdef POOL_DEBUG
+    memset(item, POOL_POISON, pool->size);
+#endif
+    *(void **) item = pool->free_list;
+    pool->free_list = item;
+  }
+  pool->idle += pool->per_slab;
+}
+
+
+#ifdef POOL_DEBUG
+/* Is everything after the free list link still poison? */
+static int pool_poisoned(struct mem_pool *pool, const void *ptr)
+{
+  const unsigned char *p = (const unsigned char *) ptr + sizeof(void *);
+  const unsigned char *end = (const unsigned char *) ptr + pool->size;
+
+  for (; p < end; p++)
+    if (*p != POOL_POISON)
+      return (FALSE);
+  return (TRUE);
+}
+#endif
+#endif
+
+
+void *pool_alloc(struct mem_pool *pool)
+{
+  void *item;
+
+#ifdef POOL_PASSTHROUGH
+  if (!(item = calloc(1, pool->size))) {
+    perror("SYSERR: malloc failure");
+    abort();
+  }
+#else
+  if (!pool->free_list)
+    pool_grow(pool);
+
+  item = pool->free_list;
+  pool->free_list = *(void **) item;
+  pool->idle--;
+
+#ifdef POOL_DEBUG
+  if (!pool_poisoned(pool, item))
+    log("SYSERR: %s %p was written to after it was freed.", pool->name, item);
+#endif
+  memset(item, 0, pool->size);
+#endif
+
+  pool->allocs++;
+  if (++pool->live > pool->peak)
+    pool->peak = pool->live;
+
+  return (item);
+}
+
+
+void pool_free(struct mem_pool *pool, void *ptr)
+{
+  if (!ptr)
+    return;
+
+#ifdef POOL_PASSTHROUGH
+  free(ptr);
+#else
+#ifdef POOL_DEBUG
+  if (pool_poisoned(pool, ptr)) {
+    log("SYSERR: %s %p looks to be freed twice.", pool->name, ptr);
+    return;
+  }
+  memset(ptr, POOL_POISON, pool->size);
+#endif
+  *(void **) ptr = pool->free_list;
+  pool->free_list = ptr;
+  pool->idle++;
+#endif
+
+  pool->frees++;
+  pool->live--;
+}
+
+
+void pool_show(struct char_data *ch)
+{
+  struct mem_pool *pool;
+  unsigned long bytes;
+  size_t i;
+
+#ifdef POOL_PASSTHROUGH
+  send_to_char(ch, "Pools are passing through to malloc (POOL_MALLOC).\r\n");
+#endif
+  send_to_char(ch, "Pool            Size  Slabs     Live     Peak     Free       Allocs        Frees    KBytes\r\n"
+                   "--------------- ---- ------ -------- -------- -------- ------------ ------------ ---------\r\n");
+  for (i = 0; i < sizeof(pools) / sizeof(pools[0]); i++) {
+    pool = pools[i];
+#ifdef POOL_PASSTHROUGH
+    bytes = pool->live * pool->size;
+#else
+    bytes = pool->num_slabs * (SLAB_HEADER + pool->size * pool->per_slab);
+#endif
+    send_to_char(ch, "%-15s %4d %6lu %8lu %8lu %8lu %12lu %12lu %9lu\r\n", pool->name, (int) pool->size,
+                 pool->num_slabs, pool->live, pool->peak, pool->idle, pool->allocs, pool->frees, bytes / 1024);
+  }
+}
@@ -0,0 +1,256 @@
+/* ************************************************************************
+*   File: profile.c                                     Part of CircleMUD *
+*  Usage: Per-phase timing of game_loop() passes, with rolling histograms *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+/*
+ * game_loop() and the heartbeat tasks time each of their phases with
+ * prof_lap()/prof_add().  Time spent in a phase is summed over the pass,
+ * and prof_end_pass() files each phase that ran into that minute's
+ * histogram, so 'profile' can show percentiles over the last 1, 5 and 60
+ * minutes.  The sums for the last pass are kept until the next one ends;
+ * when game_loop() finds the pass ran over its 0.1 seconds it calls
+ * prof_log_overrun() to log where the time went.
+ *
+ * Histograms are log-linear, as in HdrHistogram: microseconds below
+ * 2 << PROF_SUB_BITS get a bucket each, and every power of two above that
+ * is split into 1 << PROF_SUB_BITS buckets, so a bucket is never more
+ * than about 12% wide.  A minute of one phase is PROF_BUCKETS counters,
+ * kept in a ring of PROF_MINUTES and cleared as the ring comes round.
+ */
+
+#include "profile.h"
+#include "utils.h"
+#include "comm.h"
+
+struct prof_minute {
+  time_t stamp;				/* minute it holds, time / 60	*/
+  unsigned long long max_usec;
+  unsigned int count[PROF_BUCKETS];
+};
+
+struct prof_data {
+  const char *name;
+  unsigned long long pass_nsec;		/* summed over the current pass	*/
+  unsigned long long last_nsec;		/* ... and over the last one	*/
+  bool ran, last_ran;
+  struct prof_minute minute[PROF_MINUTES];
+};
+
+static struct prof_data *prof_phases[PROF_MAX_PHASES];
+static int num_prof_phases = 0;
+
+
+unsigned long long prof_clock(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+
+/* Find a phase by name, adding it if it's new.  Returns -1 if full. */
+int prof_phase(const char *name)
+{
+  int i;
+
+  for (i = 0; i < num_prof_phases; i++)
+    if (!strcmp(prof_phases[i]->name, name))
+      return (i);
+
+  if (num_prof_phases >= PROF_MAX_PHASES) {
+    log("SYSERR: Too many profile phases, not timing '%s'.", name);
+    return (-1);
+  }
+
+  prof_phases[num_prof_phases] = new prof_data();
+  prof_phases[num_prof_phases]->name = name;
+  return (num_prof_phases++);
+}
+
+
+void prof_add(int phase, unsigned long long nsec)
+{
+  if (phase < 0)
+    return;
+  prof_phases[phase]->pass_nsec += nsec;
+  prof_phases[phase]->ran = true;
+}
+
+
+/* Charge the time since 'since' to 'phase', and return the time now. */
+unsigned long long prof_lap(int phase, unsigned long long since)
+{
+  unsigned long long now = prof_clock();
+
+  prof_add(phase, now - since);
+  return (now);
+}
+
+
+static int prof_bucket(unsigned long long usec)
+{
+  int shift = 0;
+  unsigned long long v;
+
+  if (usec < (2 << PROF_SUB_BITS))
+    return ((int) usec);
+
+  for (v = usec >> (PROF_SUB_BITS + 1); v; v >>= 1)
+    shift++;
+
+  return (MIN(PROF_BUCKETS - 1, (shift << PROF_SUB_BITS) + (int) (usec >> shift)));
+}
+
+
+/* Largest value that lands in 'bucket'. */
+static unsigned long long prof_bucket_top(int bucket)
+{
+  int shift;
+
+  if (bucket < (2 << PROF_SUB_BITS))
+    return (bucket);
+
+  shift = (bucket >> PROF_SUB_BITS) - 1;
+  return (((unsigned long long) (bucket - (shift << PROF_SUB_BITS) + 1) << shift) - 1);
+}
+
+
+/* File this pass's totals into the current minute's histograms. */
+void prof_end_pass(void)
+{
+  struct prof_data *p;
+  struct prof_minute *m;
+  time_t stamp = time(0) / 60;
+  unsigned long long usec;
+  int i;
+
+  for (i = 0; i < num_prof_phases; i++) {
+    p = prof_phases[i];
+    p->last_nsec = p->pass_nsec;
+    p->last_ran = p->ran;
+    p->pass_nsec = 0;
+    p->ran = false;
+    if (!p->last_ran)
+      continue;
+
+    m = &p->minute[stamp % PROF_MINUTES];
+    if (m->stamp != stamp) {
+      memset(m->count, 0, sizeof(m->count));
+      m->max_usec = 0;
+      m->stamp = stamp;
+    }
+
+    usec = p->last_nsec / 1000;
+    m->count[prof_bucket(usec)]++;
+    m->max_usec = MAX(m->max_usec, usec);
+  }
+}
+
+
+static bool prof_slower(const struct prof_data *a, const struct prof_data *b)
+{
+  return (a->last_nsec > b->last_nsec);
+}
+
+
+/*
+ * The last pass took longer than a pulse.  Log the phases that used the
+ * most of it; the first phase registered is the whole pass.
+ */
+void prof_log_overrun(int missed_pulses)
+{
+  std::vector<struct prof_data *> worst;
+  char buf[MAX_STRING_LENGTH];
+  size_t len;
+  int i;
+
+  for (i = 1; i < num_prof_phases; i++)
+    if (prof_phases[i]->last_ran)
+      worst.push_back(prof_phases[i]);
+  std::sort(worst.begin(), worst.end(), prof_slower);
+
+  len = snprintf(buf, sizeof(buf), "Pass overran by %d pulse%s (%.1fms):", missed_pulses,
+                 missed_pulses == 1 ? "" : "s", num_prof_phases ? prof_phases[0]->last_nsec / 1000000.0 : 0.0);
+  for (i = 0; i < (int) worst.size() && i < PROF_WORST && len < sizeof(buf); i++)
+    len += snprintf(buf + len, sizeof(buf) - len, "%s %s %.1fms", i ? "," : "",
+                    worst[i]->name, worst[i]->last_nsec / 1000000.0);
+
+  log("%s", buf);
+}
+
+
+void prof_reset(void)
+{
+  int i;
+
+  for (i = 0; i < num_prof_phases; i++)
+    memset(prof_phases[i]->minute, 0, sizeof(prof_phases[i]->minute));
+}
+
+
+/* Merge a phase's last 'minutes' minutes and find p50, p99 and max, in ms. */
+static int prof_window(struct prof_data *p, int minutes, double *p50, double *p99, double *max)
+{
+  static unsigned int count[PROF_BUCKETS];
+  time_t now = time(0) / 60;
+  unsigned long long total = 0, seen = 0, max_usec = 0;
+  struct prof_minute *m;
+  int i, b;
+
+  memset(count, 0, sizeof(count));
+  for (i = 0; i < minutes; i++) {
+    m = &p->minute[(now - i) % PROF_MINUTES];
+    if (m->stamp != now - i)
+      continue;
+    for (b = 0; b < PROF_BUCKETS; b++) {
+      count[b] += m->count[b];
+      total += m->count[b];
+    }
+    max_usec = MAX(max_usec, m->max_usec);
+  }
+
+  if (!total)
+    return (FALSE);
+
+  *p50 = *p99 = -1;
+  for (b = 0; b < PROF_BUCKETS; b++) {
+    seen += count[b];
+    if (*p50 < 0 && seen * 100 >= total * 50)
+      *p50 = MIN(prof_bucket_top(b), max_usec) / 1000.0;
+    if (*p99 < 0 && seen * 100 >= total * 99) {
+      *p99 = MIN(prof_bucket_top(b), max_usec) / 1000.0;
+      break;
+    }
+  }
+  *max = max_usec / 1000.0;
+
+  return (TRUE);
+}
+
+
+void prof_show(struct char_data *ch)
+{
+  static const int windows[] = { 1, 5, PROF_MINUTES };
+  double p50, p99, max;
+  int i, w;
+
+  send_to_char(ch, "%-16s  %-20s  %-20s  last %d minutes\r\n", "", "last minute", "last 5 minutes", PROF_MINUTES);
+  send_to_char(ch, "%-16s", "Phase (ms)");
+  for (w = 0; w < 3; w++)
+    send_to_char(ch, "  %6s %6s %6s", "p50", "p99", "max");
+  send_to_char(ch, "\r\n");
+  for (i = 0; i < num_prof_phases; i++) {
+    send_to_char(ch, "%-16s", prof_phases[i]->name);
+    for (w = 0; w < 3; w++) {
+      if (prof_window(prof_phases[i], windows[w], &p50, &p99, &max))
+        send_to_char(ch, "  %6.1f %6.1f %6.1f", p50, p99, max);
+      else
+        send_to_char(ch, "  %6s %6s %6s", "-", "-", "-");
+    }
+    send_to_char(ch, "\r\n");
+  }
+}
@@ -0,0 +1,314 @@
+/* ************************************************************************
+*   File: reactor.c                                     Part of CircleMUD *
+*  Usage: Socket readiness backends used by game_loop()                   *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+/*
+ * The reactor tells game_loop() which descriptors have something to do.
+ * Descriptors register once when they are created and deregister when
+ * they are closed; each pass game_loop() polls without blocking and only
+ * walks ready_list for input and exceptions.
+ *
+ * The epoll backend is edge-triggered, so readiness is sticky: REACT_READ
+ * stays set until process_input() drains the socket to EAGAIN, and
+ * REACT_WRITE stays set until process_output() fails to flush everything.
+ * The select backend rebuilds the readiness bits from scratch every pass,
+ * exactly like the old code did, and is kept for systems without epoll.
+ */
+
+#include "reactor.h"
+#include "utils.h"
+#include "comm.h"
+
+#include <sys/epoll.h>
+
+int reactor_type = REACTOR_EPOLL;
+struct descriptor_data *ready_list = NULL;	/* descriptors with input or exceptions */
+
+static socklen_t reactor_mother = INVALID_SOCKET;
+
+
+/*
+ * Flag a descriptor as ready.  Anything with input or an exception pending
+ * is put on ready_list so the input loops never touch idle sockets.
+ */
+void reactor_mark(struct descriptor_data *d, int flags)
+{
+  d->ready |= flags;
+
+  if ((d->ready & (REACT_READ | REACT_EXCEPT)) && !(d->ready & REACT_QUEUED)) {
+    d->ready |= REACT_QUEUED;
+    d->next_ready = ready_list;
+    ready_list = d;
+  }
+}
+
+
+/* Drop descriptors that have nothing left to read from ready_list. */
+void reactor_prune(void)
+{
+  struct descriptor_data *d, **prev = &ready_list;
+
+  while ((d = *prev) != NULL) {
+    if (d->ready & (REACT_READ | REACT_EXCEPT))
+      prev = &d->next_ready;
+    else {
+      *prev = d->next_ready;
+      d->next_ready = NULL;
+      d->ready &= ~REACT_QUEUED;
+    }
+  }
+}
+
+
+static void reactor_unqueue(struct descriptor_data *d)
+{
+  struct descriptor_data *temp;
+
+  if (!(d->ready & REACT_QUEUED))
+    return;
+
+  REMOVE_FROM_LIST(d, ready_list, next_ready, temp);
+  d->next_ready = NULL;
+  d->ready &= ~REACT_QUEUED;
+}
+
+
+/* ******************************************************************
+*  epoll backend                                                    *
+****************************************************************** */
+
+#define EPOLL_BATCH	256
+
+static int epoll_desc = -1;
+
+static int epoll_init(socklen_t mother)
+{
+  struct epoll_event ev;
+
+  /* CLOEXEC: copyover execs us with the player sockets, not this one. */
+  if ((epoll_desc = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+    perror("SYSERR: epoll_create1");
+    return (-1);
+  }
+
+  /* The mother socket stays level-triggered; we accept one per pass. */
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.ptr = NULL;
+  if (epoll_ctl(epoll_desc, EPOLL_CTL_ADD, mother, &ev) < 0) {
+    perror("SYSERR: epoll_ctl (mother)");
+    close(epoll_desc);
+    epoll_desc = -1;
+    return (-1);
+  }
+
+  return (0);
+}
+
+static void epoll_shutdown(void)
+{
+  if (epoll_desc >= 0)
+    close(epoll_desc);
+  epoll_desc = -1;
+}
+
+static int epoll_add(struct descriptor_data *d)
+{
+  struct epoll_event ev;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN | EPOLLOUT | EPOLLPRI | EPOLLET;
+  ev.data.ptr = d;
+  if (epoll_ctl(epoll_desc, EPOLL_CTL_ADD, d->descriptor, &ev) < 0) {
+    perror("SYSERR: epoll_ctl (add)");
+    return (-1);
+  }
+
+  /* A fresh socket can take output; the first edge may already be gone. */
+  d->ready |= REACT_WRITE;
+  return (0);
+}
+
+static void epoll_del(struct descriptor_data *d)
+{
+  struct epoll_event ev;
+
+  /* ev is ignored, but kernels before 2.6.9 insist on a non-NULL pointer */
+  if (epoll_ctl(epoll_desc, EPOLL_CTL_DEL, d->descriptor, &ev) < 0 && errno != EBADF && errno != ENOENT)
+    perror("SYSERR: epoll_ctl (del)");
+}
+
+static int epoll_poll(int *mother_ready)
+{
+  struct epoll_event events[EPOLL_BATCH];
+  struct descriptor_data *d;
+  int i, n, flags;
+
+  *mother_ready = FALSE;
+
+  do {
+    if ((n = epoll_wait(epoll_desc, events, EPOLL_BATCH, 0)) < 0) {
+      if (errno == EINTR)
+        return (0);
+      return (-1);
+    }
+
+    for (i = 0; i < n; i++) {
+      if (!(d = (struct descriptor_data *) events[i].data.ptr)) {
+        *mother_ready = TRUE;
+        continue;
+      }
+      flags = 0;
+      /* A hangup shows up as a read of 0 bytes, just like under select(). */
+      if (events[i].events & (EPOLLIN | EPOLLHUP))
+        flags |= REACT_READ;
+      if (events[i].events & EPOLLOUT)
+        flags |= REACT_WRITE;
+      if (events[i].events & (EPOLLERR | EPOLLPRI))
+        flags |= REACT_EXCEPT;
+      reactor_mark(d, flags);
+    }
+  } while (n == EPOLL_BATCH);
+
+  return (0);
+}
+
+static const struct reactor_ops epoll_ops = {
+  "epoll", epoll_init, epoll_shutdown, epoll_add, epoll_del, epoll_poll
+};
+
+
+/* ******************************************************************
+*  select backend                                                   *
+****************************************************************** */
+
+static int select_init(socklen_t mother)
+{
+  return (0);
+}
+
+static void select_shutdown(void)
+{
+}
+
+static int select_add(struct descriptor_data *d)
+{
+  if (d->descriptor >= FD_SETSIZE) {
+    log("SYSERR: descriptor %d is beyond FD_SETSIZE (%d) for select().", d->descriptor, FD_SETSIZE);
+    return (-1);
+  }
+  return (0);
+}
+
+static void select_del(struct descriptor_data *d)
+{
+}
+
+static int select_poll(int *mother_ready)
+{
+  fd_set input_set, output_set, exc_set;
+  struct timeval null_time;
+  struct descriptor_data *d;
+  socklen_t maxdesc;
+  int flags;
+
+  null_time.tv_sec = 0;
+  null_time.tv_usec = 0;
+
+  /* Level-triggered: forget last pass and ask again about everyone. */
+  FD_ZERO(&input_set);
+  FD_ZERO(&output_set);
+  FD_ZERO(&exc_set);
+  FD_SET(reactor_mother, &input_set);
+
+  maxdesc = reactor_mother;
+  for (d = descriptor_list; d; d = d->next) {
+    d->ready &= REACT_QUEUED;
+    if (d->descriptor > maxdesc)
+      maxdesc = d->descriptor;
+    FD_SET(d->descriptor, &input_set);
+    FD_SET(d->descriptor, &output_set);
+    FD_SET(d->descriptor, &exc_set);
+  }
+  reactor_prune();
+
+  if (select(maxdesc + 1, &input_set, &output_set, &exc_set, &null_time) < 0)
+    return (-1);
+
+  *mother_ready = FD_ISSET(reactor_mother, &input_set);
+
+  for (d = descriptor_list; d; d = d->next) {
+    flags = 0;
+    if (FD_ISSET(d->descriptor, &input_set))
+      flags |= REACT_READ;
+    if (FD_ISSET(d->descriptor, &output_set))
+      flags |= REACT_WRITE;
+    if (FD_ISSET(d->descriptor, &exc_set))
+      flags |= REACT_EXCEPT;
+    reactor_mark(d, flags);
+  }
+
+  return (0);
+}
+
+static const struct reactor_ops select_ops = {
+  "select", select_init, select_shutdown, select_add, select_del, select_poll
+};
+
+
+/* ******************************************************************
+*  public interface                                                 *
+****************************************************************** */
+
+static const struct reactor_ops *reactor = &epoll_ops;
+
+int reactor_init(socklen_t mother)
+{
+  reactor_mother = mother;
+  reactor = (reactor_type == REACTOR_SELECT ? &select_ops : &epoll_ops);
+
+  if (reactor->init(mother) < 0) {
+    if (reactor == &select_ops)
+      return (-1);
+    log("SYSERR: Unable to start the %s reactor, falling back to select().", reactor->name);
+    reactor_type = REACTOR_SELECT;
+    reactor = &select_ops;
+    return (reactor->init(mother));
+  }
+
+  log("Using the %s network reactor.", reactor->name);
+  return (0);
+}
+
+void reactor_shutdown(void)
+{
+  reactor->shutdown();
+}
+
+const char *reactor_name(void)
+{
+  return (reactor->name);
+}
+
+int reactor_add(struct descriptor_data *d)
+{
+  d->ready = 0;
+  d->next_ready = NULL;
+  return (reactor->add(d));
+}
+
+void reactor_del(struct descriptor_data *d)
+{
+  reactor_unqueue(d);
+  reactor->del(d);
+  d->ready = 0;
+}
+
+/* Non-blocking poll; fills in readiness for everything registered. */
+int reactor_poll(int *mother_ready)
+{
+  return (reactor->poll(mother_ready));
+}
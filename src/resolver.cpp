@@ -0,0 +1,239 @@
+/* ************************************************************************
+*   File: resolver.c                                    Part of CircleMUD *
+*  Usage: Reverse DNS for new connections, off the game thread            *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+/*
+ * new_descriptor() used to call gethostbyaddr() right in the game loop, so
+ * one slow nameserver froze everybody.  Now a connection starts out with
+ * its numeric address, the name is looked up on a couple of resolver
+ * threads, and game_loop() picks up the answers with resolver_next() and
+ * upgrades d->host.
+ *
+ * Answers (and failures, for a shorter time) are cached on the game thread,
+ * so reconnects and floods from one address cost one lookup.  Only one
+ * lookup per address is ever in flight.
+ *
+ * The lookup itself goes through resolver_lookup, so it can be swapped out;
+ * -n <file> uses a stub that answers from a file instead of DNS.
+ */
+
+#include "resolver.h"
+#include "utils.h"
+#include "comm.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+struct resolver_entry {
+  std::string host;	/* empty if the address has no name	*/
+  time_t expires;
+  bool pending;		/* lookup in flight			*/
+};
+
+struct resolver_result {
+  struct in_addr addr;
+  bool found;
+  char host[HOST_LENGTH + 1];
+};
+
+/*
+ * Allocated once and never freed: a thread stuck in a lookup at shutdown
+ * is simply left behind, and must not find these destroyed under it.
+ */
+struct resolver_state {
+  std::mutex lock;
+  std::condition_variable cv;
+  std::deque<struct in_addr> requests;
+  std::deque<struct resolver_result> results;
+  bool stopping = false;
+};
+
+static struct resolver_state *rs = NULL;
+static std::unordered_map<in_addr_t, struct resolver_entry> resolver_cache;
+static std::unordered_map<in_addr_t, std::pair<std::string, int> > stub_table;
+
+
+static int dns_lookup(struct in_addr addr, char *host, size_t len)
+{
+  struct sockaddr_in sa;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr = addr;
+
+  return (getnameinfo((struct sockaddr *) &sa, sizeof(sa), host, len, NULL, 0, NI_NAMEREQD) == 0);
+}
+
+resolver_backend resolver_lookup = dns_lookup;
+
+
+/* Answers from the table read by resolver_use_stub(), after its delay. */
+static int stub_lookup(struct in_addr addr, char *host, size_t len)
+{
+  auto it = stub_table.find(addr.s_addr);
+
+  if (it == stub_table.end())
+    return (FALSE);
+  if (it->second.second > 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds(it->second.second));
+  if (it->second.first == "-")
+    return (FALSE);
+
+  strlcpy(host, it->second.first.c_str(), len);
+  return (TRUE);
+}
+
+
+/*
+ * Resolve from a file instead of DNS, for testing.  One address per line:
+ *   <numeric address> <name, or - for none> [delay in milliseconds]
+ */
+int resolver_use_stub(const char *filename)
+{
+  FILE *fl;
+  char line[READ_SIZE], ip[READ_SIZE], name[READ_SIZE];
+  struct in_addr addr;
+  int delay;
+
+  if (!(fl = fopen(filename, "r"))) {
+    perror("SYSERR: resolver_use_stub");
+    return (FALSE);
+  }
+
+  while (get_line(fl, line)) {
+    delay = 0;
+    if (sscanf(line, "%s %s %d", ip, name, &delay) < 2 || !inet_aton(ip, &addr))
+      continue;
+    stub_table[addr.s_addr] = std::make_pair(std::string(name), delay);
+  }
+  fclose(fl);
+
+  resolver_lookup = stub_lookup;
+  return (TRUE);
+}
+
+
+static void resolver_thread(void)
+{
+  struct resolver_result res;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lk(rs->lock);
+      rs->cv.wait(lk, [] { return rs->stopping || !rs->requests.empty(); });
+      if (rs->stopping)
+        return;
+      res.addr = rs->requests.front();
+      rs->requests.pop_front();
+    }
+
+    *res.host = '\0';
+    res.found = resolver_lookup(res.addr, res.host, sizeof(res.host));
+
+    std::lock_guard<std::mutex> lk(rs->lock);
+    rs->results.push_back(res);
+  }
+}
+
+
+void resolver_init(void)
+{
+  int i;
+
+  rs = new resolver_state;
+  for (i = 0; i < RESOLVER_THREADS; i++)
+    std::thread(resolver_thread).detach();
+
+  log("Resolving hostnames on %d background thread%s%s.", RESOLVER_THREADS,
+      RESOLVER_THREADS == 1 ? "" : "s", resolver_lookup == stub_lookup ? " (stub)" : "");
+}
+
+
+void resolver_shutdown(void)
+{
+  if (!rs)
+    return;
+
+  std::lock_guard<std::mutex> lk(rs->lock);
+  rs->stopping = true;
+  rs->cv.notify_all();
+}
+
+
+/* Drop expired entries once the cache gets big. */
+static void resolver_prune(void)
+{
+  time_t now = time(0);
+
+  for (auto it = resolver_cache.begin(); it != resolver_cache.end(); )
+    if (!it->second.pending && it->second.expires <= now)
+      it = resolver_cache.erase(it);
+    else
+      ++it;
+}
+
+
+/*
+ * Look in the cache.  Returns TRUE and fills in 'host' (empty if the
+ * address has no name) if we already know the answer.
+ */
+int resolver_cached(struct in_addr addr, char *host, size_t len)
+{
+  auto it = resolver_cache.find(addr.s_addr);
+
+  if (it == resolver_cache.end() || it->second.pending || it->second.expires <= time(0))
+    return (FALSE);
+
+  strlcpy(host, it->second.host.c_str(), len);
+  return (TRUE);
+}
+
+
+/* Start a lookup, unless one for this address is already running. */
+void resolver_request(struct in_addr addr)
+{
+  struct resolver_entry &ent = resolver_cache[addr.s_addr];
+
+  if (ent.pending)
+    return;
+  ent.pending = true;
+
+  if (resolver_cache.size() > RESOLVER_CACHE_MAX)
+    resolver_prune();
+
+  std::lock_guard<std::mutex> lk(rs->lock);
+  rs->requests.push_back(addr);
+  rs->cv.notify_one();
+}
+
+
+/*
+ * Hand back one finished lookup, caching it on the way.  Returns FALSE when
+ * there are none.  'host' is empty if the address has no name.
+ */
+int resolver_next(struct in_addr *addr, char *host, size_t len)
+{
+  struct resolver_result res;
+
+  {
+    std::lock_guard<std::mutex> lk(rs->lock);
+    if (rs->results.empty())
+      return (FALSE);
+    res = rs->results.front();
+    rs->results.pop_front();
+  }
+
+  struct resolver_entry &ent = resolver_cache[res.addr.s_addr];
+  ent.pending = false;
+  ent.host = (res.found ? res.host : "");
+  ent.expires = time(0) + (res.found ? RESOLVER_TTL : RESOLVER_NEG_TTL);
+
+  *addr = res.addr;
+  strlcpy(host, ent.host.c_str(), len);
+  return (TRUE);
+}
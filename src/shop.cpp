@@ -26,6 +26,7 @@
 #include "dg_comm.h"
 #include "act.other.h"
 #include "class.h"
+#include "keywords.h"
 
 /* Forward/External function declarations */
 static void sort_keeper_objs(struct char_data *keeper, int shop_nr);
@@ -365,7 +366,7 @@ static int evaluate_expression(struct obj_data *obj, char *expr)
 	    break;
 	  }
 	if (*extra_bits[eindex] == '\n')
-	  push(&vals, isname(name, obj->name));
+	  push(&vals, isname_obj(name, obj));
       } else {
 	if (temp != OPER_OPEN_PAREN)
 	  while (top(&ops) > temp)
@@ -515,7 +516,7 @@ static struct obj_data *get_slide_obj_vis(struct char_data *ch, char *name,
     return (NULL);
 
   for (i = list, j = 1; i && (j <= number); i = i->next_content)
-    if (isname(tmp, i->name))
+    if (isname_obj(tmp, i))
       if (CAN_SEE_OBJ(ch, i) && !same_obj(last_match, i)) {
 	if (j == number)
 	  return (i);
@@ -978,18 +979,18 @@ static struct obj_data *slide_obj(struct obj_data *obj, struct char_data *keeper
     return (&obj_proto[temp]);
   }
   SHOP_SORT(shop_nr)++;
-  loop = keeper->carrying;
   obj_to_char(obj, keeper);
-  keeper->carrying = loop;
-  while (loop) {
+  for (loop = obj->next_content; loop; loop = loop->next_content) {
     if (same_obj(obj, loop)) {
-      obj->next_content = loop->next_content;
+      /* Move it from the front to just after its twin. */
+      UNLINK_FROM_LIST(obj, keeper->carrying, next_content, prev_content);
+      if ((obj->next_content = loop->next_content))
+        obj->next_content->prev_content = obj;
+      obj->prev_content = loop;
       loop->next_content = obj;
-      return (obj);
+      break;
     }
-    loop = loop->next_content;
   }
-  keeper->carrying = obj;
   return (obj);
 }
 
@@ -1208,7 +1209,7 @@ static void shopping_list(char *arg, struct char_data *ch, struct char_data *kee
 	  cnt++;
 	else {
 	  lindex++;
-	  if (!*name || isname(name, last_obj->name)) {
+	  if (!*name || isname_obj(name, last_obj)) {
 	    strncat(buf, list_object(last_obj, cnt, lindex, shop_nr, keeper, ch), sizeof(buf) - len - 1);	/* strncat: OK */
             len = strlen(buf);
             if (len + 1 >= sizeof(buf))
@@ -1226,7 +1227,7 @@ static void shopping_list(char *arg, struct char_data *ch, struct char_data *kee
     send_to_char(ch, "Presently, none of those are for sale.\r\n");
   else {
     char zen[80];
-    if (!*name || isname(name, last_obj->name))	/* show last obj */
+    if (!*name || isname_obj(name, last_obj))	/* show last obj */
       if (len < sizeof(buf)) {
         strncat(buf, list_object(last_obj, cnt, lindex, shop_nr, keeper, ch), sizeof(buf) - len - 1);	/* strncat: OK */
       }
@@ -23,6 +23,8 @@
 #include "races.h"
 #include "act.comm.h"
 #include "class.h"
+#include "keywords.h"
+#include "pool.h"
 
 /* local functions */
 
@@ -874,6 +876,7 @@ SPECIAL(pet_shops)
       snprintf(buf, sizeof(buf), "%s %s", pet->name, pet_name);
       /* free(pet->name); don't free the prototype! */
       pet->name = strdup(buf);
+      char_keywords_refresh(pet);
 
       snprintf(buf, sizeof(buf), "%sA small sign on a chain around the neck says 'My name is %s'\r\n",
 	      pet->description, pet_name);
@@ -1003,7 +1006,7 @@ SPECIAL(auction)
        struct char_data *vict = NULL;
        int is_file = FALSE, player_i = 0;
 
-       CREATE(vict, struct char_data, 1);
+       POOL_CREATE(vict, struct char_data, char_pool);
        clear_char(vict);
        CREATE(vict->player_specials, struct player_special_data, 1);
        char blam[50];
@@ -1636,7 +1639,7 @@ SPECIAL(bank)
        int is_file = FALSE, player_i = 0;
        char name[MAX_INPUT_LENGTH];
 
-       CREATE(vict, struct char_data, 1);
+       POOL_CREATE(vict, struct char_data, char_pool);
        clear_char(vict);
        CREATE(vict->player_specials, struct player_special_data, 1);
 
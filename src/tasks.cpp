@@ -0,0 +1,237 @@
+/* ************************************************************************
+*   File: tasks.c                                       Part of CircleMUD *
+*  Usage: Periodic heartbeat tasks, scheduled on a timing wheel           *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+************************************************************************ */
+
+/*
+ * heartbeat() used to test every subsystem's "pulse % PULSE_FOO" on every
+ * pulse, and since nearly all the periods are multiples of one another the
+ * heavy updates all landed on the same pulses.  Now each subsystem is a
+ * task with a period and a phase: it runs on the pulses where
+ * pulse % period == phase.  A task added with TASK_STAGGER and TASK_HEAVY
+ * gets a phase that never (or as rarely as possible) shares a pulse with
+ * another heavy task.
+ *
+ * Tasks wait on a two level timing wheel.  Level 0 has a slot per pulse
+ * for the next TASK_WHEEL_SIZE pulses; level 1 has a slot per
+ * TASK_WHEEL_SIZE pulses after that, and each of its slots is spilled down
+ * into level 0 as its turn comes round.  A task further out than level 1
+ * reaches is parked in level 1's last slot and sorted again when that
+ * spills.  So a pulse only looks at the tasks actually due on it.
+ *
+ * Each run is timed; the 'tasks' command shows the totals, and each task
+ * is also a phase for the 'profile' histograms.
+ */
+
+#include "tasks.h"
+#include "utils.h"
+#include "comm.h"
+#include "profile.h"
+
+struct tick_task *task_list = NULL;
+
+static struct tick_task *task_wheel[2][TASK_WHEEL_SIZE];
+static int task_pulse = 0;	/* last pulse task_run() got to		*/
+static int num_tasks = 0;
+
+
+static int task_gcd(int a, int b)
+{
+  while (b) {
+    int r = a % b;
+    a = b;
+    b = r;
+  }
+  return (a);
+}
+
+
+/*
+ * Find the phase for a heavy task that collides with the fewest other
+ * heavy tasks.  Two tasks share a pulse sooner or later exactly when
+ * their phases agree modulo the gcd of their periods.
+ */
+static int task_pick_phase(struct tick_task *t)
+{
+  struct tick_task *o;
+  int p, g, cost, best = 0, best_cost = INT_MAX;
+
+  for (p = 0; p < t->period && best_cost; p++) {
+    cost = 0;
+    for (o = task_list; o; o = o->next) {
+      if (o == t || !IS_SET(o->flags, TASK_HEAVY))
+        continue;
+      g = task_gcd(t->period, o->period);
+      if ((((p - o->phase) % g) + g) % g == 0)
+        cost++;
+    }
+    if (cost < best_cost) {
+      best = p;
+      best_cost = cost;
+    }
+  }
+
+  return (best);
+}
+
+
+static void task_insert(struct tick_task *t)
+{
+  struct tick_task **slot;
+  int delta = t->due - task_pulse;
+
+  if (delta < TASK_WHEEL_SIZE)
+    slot = &task_wheel[0][t->due & TASK_WHEEL_MASK];
+  else if (delta < TASK_WHEEL_SIZE * TASK_WHEEL_SIZE)
+    slot = &task_wheel[1][(t->due >> TASK_WHEEL_BITS) & TASK_WHEEL_MASK];
+  else
+    slot = &task_wheel[1][((task_pulse >> TASK_WHEEL_BITS) + TASK_WHEEL_MASK) & TASK_WHEEL_MASK];
+
+  t->next_slot = *slot;
+  *slot = t;
+}
+
+
+/* Only needed when a task is changed, so just look everywhere. */
+static void task_unlink(struct tick_task *t)
+{
+  struct tick_task **pp;
+  int lvl, i;
+
+  for (lvl = 0; lvl < 2; lvl++)
+    for (i = 0; i < TASK_WHEEL_SIZE; i++)
+      for (pp = &task_wheel[lvl][i]; *pp; pp = &(*pp)->next_slot)
+        if (*pp == t) {
+          *pp = t->next_slot;
+          t->next_slot = NULL;
+          return;
+        }
+}
+
+
+/* First pulse after the current one that lands on the task's phase. */
+static void task_schedule(struct tick_task *t)
+{
+  int due = task_pulse + 1;
+
+  t->due = due + (((t->phase - due) % t->period) + t->period) % t->period;
+  task_insert(t);
+}
+
+
+/*
+ * Register a task, or change one already registered under 'name' (say,
+ * after cedit changes a pulse length).  'phase' is TASK_STAGGER to have
+ * one picked.
+ */
+struct tick_task *task_add(const char *name, void (*func)(void), int period, int phase, int flags)
+{
+  struct tick_task *t, **pp;
+
+  period = MAX(1, period);
+
+  for (t = task_list; t; t = t->next)
+    if (!strcmp(t->name, name))
+      break;
+
+  if (t) {
+    if (t->func == func && t->period == period && t->flags == flags &&
+        (phase == TASK_STAGGER || phase % period == t->phase))
+      return (t);
+    task_unlink(t);
+  } else {
+    CREATE(t, struct tick_task, 1);
+    t->name = name;
+    t->order = num_tasks++;
+    t->prof = prof_phase(name);
+    for (pp = &task_list; *pp; pp = &(*pp)->next)
+      ;
+    *pp = t;
+  }
+
+  t->func = func;
+  t->period = period;
+  t->flags = flags;
+  t->phase = (phase == TASK_STAGGER ? task_pick_phase(t) : phase % period);
+
+  task_schedule(t);
+  return (t);
+}
+
+
+static bool task_before(const struct tick_task *a, const struct tick_task *b)
+{
+  return (a->order < b->order);
+}
+
+
+/* Run everything due up to and including 'pulse'. */
+void task_run(int pulse)
+{
+  static std::vector<struct tick_task *> due;
+  struct tick_task *t, *next;
+  unsigned long long start, took;
+  int i;
+
+  while (task_pulse < pulse) {
+    task_pulse++;
+
+    /* Spill the next stretch of level 1 down into level 0. */
+    if (!(task_pulse & TASK_WHEEL_MASK)) {
+      i = (task_pulse >> TASK_WHEEL_BITS) & TASK_WHEEL_MASK;
+      t = task_wheel[1][i];
+      task_wheel[1][i] = NULL;
+      for (; t; t = next) {
+        next = t->next_slot;
+        task_insert(t);
+      }
+    }
+
+    i = task_pulse & TASK_WHEEL_MASK;
+    t = task_wheel[0][i];
+    task_wheel[0][i] = NULL;
+    if (!t)
+      continue;
+
+    due.clear();
+    for (; t; t = next) {
+      next = t->next_slot;
+      if (t->due == task_pulse)
+        due.push_back(t);
+      else
+        task_insert(t);
+    }
+
+    /* Same-pulse tasks run in the order they were added. */
+    std::sort(due.begin(), due.end(), task_before);
+
+    for (auto task : due) {
+      start = prof_clock();
+      (task->func)();
+      took = prof_clock() - start;
+      prof_add(task->prof, took);
+
+      task->runs++;
+      task->last_nsec = took;
+      task->total_nsec += took;
+      if (took > task->max_nsec)
+        task->max_nsec = took;
+
+      task->due += task->period;
+      task_insert(task);
+    }
+  }
+}
+
+
+void task_reset_stats(void)
+{
+  struct tick_task *t;
+
+  for (t = task_list; t; t = t->next) {
+    t->runs = 0;
+    t->total_nsec = t->max_nsec = t->last_nsec = 0;
+  }
+}
@@ -1362,106 +1362,148 @@ void senseCreate(struct char_data *ch)
   return;
 }
 
-int read_sense_memory(struct char_data *ch, struct char_data *vict) {
-  char fname[40], line[256];
-  int known = FALSE, idnums = -1337;
-  FILE *fl;
+/*
+ * Intro and sense memories used to be re-read from disk on every lookup,
+ * and PERS() does an intro lookup for every act() recipient.  They are now
+ * read once into ch->recog and written back by save_char().  Mobs never
+ * touch the disk; whatever they learn is forgotten when they are freed.
+ */
+static struct recog_memory *get_recog_memory(struct char_data *ch)
+{
+  if (!ch->recog)
+    ch->recog = new recog_memory();
 
-  /* Read Sense File */
-  if (vict == NULL) {
-    log("Noone.");
-    return 0;
-  }
+  return (ch->recog);
+}
 
-  if (!get_filename(fname, sizeof(fname), SENSE_FILE, GET_NAME(ch))) {
-    senseCreate(ch);
-  }
-  if (!(fl = fopen(fname, "r"))) {
-    return 2;
-  }
-  if (vict == ch) {
-    fclose(fl);
-    return 0;
-  }
+/* Returns FALSE if the intro file can neither be read nor created. */
+int load_intro_memory(struct char_data *ch)
+{
+  struct recog_memory *mem = get_recog_memory(ch);
+  char fname[40], filler[50], scrap[100], line[256];
+  FILE *fl;
 
-  while (!feof(fl)) {
-    get_line(fl, line);
-    sscanf(line, "%d\n", &idnums);
-    if (IS_NPC(vict)) {
-     if (idnums == GET_MOB_VNUM(vict)) {
-      known = TRUE;
-     }
-    } else {
-     if (idnums == GET_ID(vict)) {
-      known = TRUE;
-     }
+  if (mem->intro_loaded)
+    return (TRUE);
+
+  if (!IS_NPC(ch)) {
+    if (!get_filename(fname, sizeof(fname), INTRO_FILE, GET_NAME(ch)))
+      return (FALSE);
+    if (!(fl = fopen(fname, "r"))) {
+      introCreate(ch);
+      if (!(fl = fopen(fname, "r")))
+        return (FALSE);
+    }
+    while (get_line(fl, line)) {
+      if (sscanf(line, "%49s %99s", filler, scrap) == 2)
+        mem->intro.insert_or_assign(filler, scrap);
     }
+    fclose(fl);
   }
-   fclose(fl);
 
-   if (known == TRUE)
-    return 1;
-   else
-    return 0;
+  mem->intro_loaded = TRUE;
+  return (TRUE);
 }
 
-/* This writes a player's sense memory to file. */
-void sense_memory_write(struct char_data *ch, struct char_data *vict)
+/* Returns FALSE if the sense file can neither be read nor created. */
+int load_sense_memory(struct char_data *ch)
 {
-  FILE *file;
+  struct recog_memory *mem = get_recog_memory(ch);
   char fname[40], line[256];
-  int idnums[500] = {0};
+  int idnum;
   FILE *fl;
-  int count = 0, x = 0, id_sample;
 
-  /* Read Sense File */
-  if (!get_filename(fname, sizeof(fname), SENSE_FILE, GET_NAME(ch))) {
-    senseCreate(ch);
-  }
-  if (!(file = fopen(fname, "r"))) {
-    return;
-  }
-  while (!feof(file) || count < 498) {
-    get_line(file, line);
-    sscanf(line, "%d\n", &id_sample);
-    idnums[count] = id_sample;
-    count++;
+  if (mem->sense_loaded)
+    return (TRUE);
+
+  if (!IS_NPC(ch)) {
+    if (!get_filename(fname, sizeof(fname), SENSE_FILE, GET_NAME(ch)))
+      return (FALSE);
+    if (!(fl = fopen(fname, "r"))) {
+      senseCreate(ch);
+      if (!(fl = fopen(fname, "r")))
+        return (FALSE);
+    }
+    while (get_line(fl, line)) {
+      if (sscanf(line, "%d", &idnum) == 1)
+        mem->sense.insert(idnum);
+    }
+    fclose(fl);
   }
-  fclose(file);
 
-  /* Write Sense File */
+  mem->sense_loaded = TRUE;
+  return (TRUE);
+}
 
-  if (!get_filename(fname, sizeof(fname), SENSE_FILE, GET_NAME(ch)))
-    return;
+/* Write back whichever half of the memory changed since the last save. */
+void save_recog_memory(struct char_data *ch)
+{
+  struct recog_memory *mem = ch->recog;
+  char fname[40];
+  FILE *fl;
 
-  if( !(fl = fopen(fname, "w")) ) {
-    log("ERROR: could not save sense memory file, %s, to filename, %s.", GET_NAME(ch), fname);
+  if (!mem || IS_NPC(ch))
     return;
+
+  if (mem->intro_dirty && get_filename(fname, sizeof(fname), INTRO_FILE, GET_NAME(ch))) {
+    if (!(fl = fopen(fname, "w")))
+      log("ERROR: could not save intro file, %s, to filename, %s.", GET_NAME(ch), fname);
+    else {
+      for (const auto &entry : mem->intro)
+        fprintf(fl, "%s %s\n", entry.first.c_str(), entry.second.c_str());
+      fclose(fl);
+      mem->intro_dirty = FALSE;
+    }
   }
 
-  while(x < count) {
-    if (x == 0 || idnums[x-1] != idnums[x]) {
-     if (!IS_NPC(vict)) {
-      if (idnums[x] != GET_ID(vict)) {
-       fprintf(fl, "%d\n", idnums[x]);
-      }
-     } else {
-      if (idnums[x] != GET_MOB_VNUM(vict)) {
-       fprintf(fl, "%d\n", idnums[x]);
-      }
-     }
+  if (mem->sense_dirty && get_filename(fname, sizeof(fname), SENSE_FILE, GET_NAME(ch))) {
+    if (!(fl = fopen(fname, "w")))
+      log("ERROR: could not save sense memory file, %s, to filename, %s.", GET_NAME(ch), fname);
+    else {
+      for (int idnum : mem->sense)
+        fprintf(fl, "%d\n", idnum);
+      fclose(fl);
+      mem->sense_dirty = FALSE;
     }
-    x++;
   }
+}
 
-  if (!IS_NPC(vict)) {
-   fprintf(fl, "%d\n", GET_ID(vict));
-  } else {
-   fprintf(fl, "%d\n", GET_MOB_VNUM(vict));
+void free_recog_memory(struct char_data *ch)
+{
+  delete ch->recog;
+  ch->recog = NULL;
+}
+
+int read_sense_memory(struct char_data *ch, struct char_data *vict) {
+  /* Read Sense Memory */
+  if (vict == NULL) {
+    log("Noone.");
+    return 0;
   }
 
-  fclose(fl);
-  return;
+  if (!load_sense_memory(ch))
+    return 2;
+
+  if (vict == ch)
+    return 0;
+
+  if (ch->recog->sense.count(IS_NPC(vict) ? GET_MOB_VNUM(vict) : GET_ID(vict)))
+    return 1;
+  else
+    return 0;
+}
+
+/* This adds to a player's sense memory; save_char() writes it out. */
+void sense_memory_write(struct char_data *ch, struct char_data *vict)
+{
+  if (!load_sense_memory(ch))
+    return;
+
+  ch->recog->sense.insert(IS_NPC(vict) ? GET_MOB_VNUM(vict) : GET_ID(vict));
+  ch->recog->sense_dirty = TRUE;
+
+  if (!IS_NPC(ch))
+    SET_BIT_AR(PLR_FLAGS(ch), PLR_CRASH);
 }
 
 /* Will they manage to pursue a fleeing enemy? */
@@ -1531,10 +1573,13 @@ void broken_update()
 {
  struct obj_data *k, *money;
 
+ /* Gravity generators and ATMs are the only things that break down. */
+ static const obj_vnum breakable[] = {11, 3034};
  int rand_gravity[14] = {0, 10, 20, 30, 40, 50, 100, 200, 300, 400, 500, 1000, 5000, 10000};
- int dice = rand_number(2, 12), grav_roll = 0, grav_change = FALSE, health = 0;
+ int dice = rand_number(2, 12), grav_roll = 0, grav_change = FALSE, health = 0, i;
 
- for (k = object_list; k; k = k->next) {
+ for (i = 0; i < 2; i++)
+ for (k = obj_instances(breakable[i]); k; k = k->next_instance) {
   if (k->carried_by != NULL) {
    continue;
   }
@@ -4221,6 +4266,7 @@ void admin_set(struct char_data *ch, int value)
         GET_COND(ch, i) = (char) -1;
       SET_BIT_AR(PRF_FLAGS(ch), PRF_HOLYLIGHT);
     }
+    zone_occupancy_sync(ch);
     return;
   }
   if (GET_ADMLEVEL(ch) > value) { /* Demotion */
@@ -4240,6 +4286,7 @@ void admin_set(struct char_data *ch, int value)
       REMOVE_BIT_AR(PRF_FLAGS(ch), PRF_HOLYLIGHT);
       REMOVE_BIT_AR(PRF_FLAGS(ch), PRF_ROOMFLAGS);
     }
+    zone_occupancy_sync(ch);
     return;
   }
 }
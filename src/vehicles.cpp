@@ -328,26 +328,22 @@ static int ship_land_location(struct char_data *ch, struct obj_data *vehicle, ch
 
 struct obj_data *find_vehicle_by_vnum(int vnum) 
 {
-  extern struct obj_data * object_list;
   struct obj_data * i;
 
-  for (i = object_list; i; i = i->next)
+  for (i = obj_instances(vnum); i; i = i->next_instance)
     if (GET_OBJ_TYPE(i) == ITEM_VEHICLE)
-      if (GET_OBJ_VNUM(i) == vnum)
-        return i;
+      return i;
     
   return 0;
 }
 
 struct obj_data *find_hatch_by_vnum(int vnum)
 {
-  extern struct obj_data * object_list;
   struct obj_data * i;
 
-  for (i = object_list; i; i = i->next)
+  for (i = obj_instances(vnum); i; i = i->next_instance)
     if (GET_OBJ_TYPE(i) == ITEM_HATCH)
-      if (GET_OBJ_VNUM(i) == vnum)
-        return i;
+      return i;
 
   return 0;
 }
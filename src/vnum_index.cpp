@@ -0,0 +1,167 @@
+/***************************************************************************
+ *   File: vnum_index.c                                                    *
+ *  Usage: Paged vnum -> rnum lookup tables for rooms, mobiles and objects *
+ *                                                                         *
+ * This code is released under the CircleMud License                       *
+ ***************************************************************************/
+
+#include "vnum_index.h"
+#include "htree.h"
+#include "utils.h"
+#include "db.h"
+#include "comm.h"
+
+/* Define to a cycle count to benchmark the index against htree at boot. */
+#undef VNUM_INDEX_TEST_CYCLES
+
+struct vnum_index *vnum_index_init(void)
+{
+  struct vnum_index *vi;
+
+  CREATE(vi, struct vnum_index, 1);
+  vi->pages = NULL;
+  vi->num_pages = 0;
+  vi->pages_used = 0;
+
+  return (vi);
+}
+
+void vnum_index_free(struct vnum_index *vi)
+{
+  size_t i;
+
+  if (!vi)
+    return;
+
+  for (i = 0; i < vi->num_pages; i++)
+    if (vi->pages[i])
+      free(vi->pages[i]);
+  if (vi->pages)
+    free(vi->pages);
+  free(vi);
+}
+
+/* Returns FALSE if the vnum is too large to be indexed. */
+int vnum_index_add(struct vnum_index *vi, IDXTYPE vnum, IDXTYPE rnum)
+{
+  size_t page = vnum >> VNUM_PAGE_BITS, i;
+
+  if (!vi || vnum >= VNUM_INDEX_LIMIT)
+    return (FALSE);
+
+  if (page >= vi->num_pages) {
+    RECREATE(vi->pages, IDXTYPE *, page + 1);
+    for (i = vi->num_pages; i <= page; i++)
+      vi->pages[i] = NULL;
+    vi->num_pages = page + 1;
+  }
+
+  if (!vi->pages[page]) {
+    CREATE(vi->pages[page], IDXTYPE, VNUM_PAGE_SIZE);
+    /* NOWHERE, NOBODY and NOTHING are all ~0 */
+    memset(vi->pages[page], 0xff, VNUM_PAGE_SIZE * sizeof(IDXTYPE));
+    vi->pages_used++;
+  }
+
+  vi->pages[page][vnum & VNUM_PAGE_MASK] = rnum;
+  return (TRUE);
+}
+
+void vnum_index_del(struct vnum_index *vi, IDXTYPE vnum)
+{
+  size_t page = vnum >> VNUM_PAGE_BITS;
+
+  if (vi && page < vi->num_pages && vi->pages[page])
+    vi->pages[page][vnum & VNUM_PAGE_MASK] = NOWHERE;
+}
+
+IDXTYPE vnum_index_find(struct vnum_index *vi, IDXTYPE vnum)
+{
+  size_t page = vnum >> VNUM_PAGE_BITS;
+
+  if (!vi || page >= vi->num_pages || !vi->pages[page])
+    return (NOWHERE);
+
+  return (vi->pages[page][vnum & VNUM_PAGE_MASK]);
+}
+
+
+#ifdef VNUM_INDEX_TEST_CYCLES
+static float vnum_index_elapsed(struct timeval *start)
+{
+  struct timeval finish, diff;
+
+  gettimeofday(&finish, NULL);
+  timediff(&diff, &finish, start);
+  return ((float)diff.tv_sec + ((float)diff.tv_usec) / 1000000);
+}
+
+/*
+ * Time the same random lookups (hits taken from the loaded table, plus
+ * the same number of likely misses) through a throwaway htree and the
+ * live index.
+ */
+static void vnum_index_bench(const char *what, struct vnum_index *vi, IDXTYPE *vnums, IDXTYPE top)
+{
+  struct htree_node *tree;
+  struct timeval start;
+  IDXTYPE *sample, i, sink = 0;
+  float t_tree, t_index;
+
+  if (top == 0)
+    return;
+
+  tree = htree_init();
+  for (i = 0; i <= top; i++)
+    htree_add(tree, vnums[i], i);
+
+  CREATE(sample, IDXTYPE, VNUM_INDEX_TEST_CYCLES);
+  for (i = 0; i < VNUM_INDEX_TEST_CYCLES; i++)
+    sample[i] = (i & 1) ? vnums[rand_number(0, top)] : rand_number(0, vnums[top] + 1);
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < VNUM_INDEX_TEST_CYCLES; i++)
+    sink += htree_find(tree, sample[i]);
+  t_tree = vnum_index_elapsed(&start);
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < VNUM_INDEX_TEST_CYCLES; i++)
+    sink += vnum_index_find(vi, sample[i]);
+  t_index = vnum_index_elapsed(&start);
+
+  log("vnum_index_test: %-7s htree %.4fs, index %.4fs for %d lookups (%.1fx) [%u]",
+      what, t_tree, t_index, VNUM_INDEX_TEST_CYCLES, t_index > 0 ? t_tree / t_index : 0.0, sink);
+
+  free(sample);
+  htree_free(tree);
+}
+#endif /* VNUM_INDEX_TEST_CYCLES */
+
+void vnum_index_test(void)
+{
+#ifdef VNUM_INDEX_TEST_CYCLES
+  IDXTYPE *vnums, i;
+
+  CREATE(vnums, IDXTYPE, MAX(top_of_world, MAX(top_of_mobt, top_of_objt)) + 1);
+
+  for (i = 0; i <= top_of_world; i++)
+    vnums[i] = world[i].number;
+  vnum_index_bench("rooms", room_vindex, vnums, top_of_world);
+
+  for (i = 0; i <= top_of_mobt; i++)
+    vnums[i] = mob_index[i].vnum;
+  vnum_index_bench("mobiles", mob_vindex, vnums, top_of_mobt);
+
+  for (i = 0; i <= top_of_objt; i++)
+    vnums[i] = obj_index[i].vnum;
+  vnum_index_bench("objects", obj_vindex, vnums, top_of_objt);
+
+  free(vnums);
+  htree_shutdown();
+#endif /* VNUM_INDEX_TEST_CYCLES */
+  log("vnum index stats: %d/%d/%d pages, %" SZT " bytes (rooms/mobs/objs)",
+      room_vindex ? room_vindex->pages_used : 0, mob_vindex ? mob_vindex->pages_used : 0,
+      obj_vindex ? obj_vindex->pages_used : 0,
+      ((room_vindex ? room_vindex->pages_used : 0) + (mob_vindex ? mob_vindex->pages_used : 0) +
+       (obj_vindex ? obj_vindex->pages_used : 0)) * VNUM_PAGE_SIZE * sizeof(IDXTYPE));
+}